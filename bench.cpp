@@ -0,0 +1,386 @@
+/*
+	leptjson_bench: parse, stringify, free and round-trip throughput on generated documents.
+
+	usage: leptjson_bench [-r repeat] [-o results.json] [-w dir] [size...]
+
+	The corpora are generated from a fixed seed, so every run measures the same bytes:
+	  canada   numbers with 17 significant digits in nested coordinate arrays (GeoJSON)
+	  twitter  records of short strings, UTF-8 text, \u escapes, surrogate pairs, ids and nulls
+	  nested   records nested LEPT_BENCH_DEPTH deep, alternating objects and arrays
+	  wide     one object with a member per key
+	Each corpus is generated at every size (bytes, with an optional K or M suffix; default 64K 1M
+	16M). Times are the best of the repeats and MB/s are 10^6 bytes of JSON per second: the input
+	for parse, free and the round trip (parse, stringify, free), the output for stringify. Allocations
+	are counted by lept_count_allocs() over one more parse and stringify, and the peak RSS is that of
+	the process so far. -o writes the results as
+	JSON, -w writes each document to dir/<corpus>-<size>.json.
+*/
+#ifdef _WINDOWS
+#define _CRTDBG_MAP_ALLOC
+#include <crtdbg.h>
+#endif
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include "leptjson.h"
+
+#ifdef _WIN32
+#include <windows.h>
+#include <psapi.h>	/* GetProcessMemoryInfo() */
+#pragma comment(lib, "psapi")
+#else
+#include <time.h>	/* clock_gettime() */
+#include <sys/resource.h>	/* getrusage() */
+#endif
+
+#define LEPT_BENCH_DEPTH 100
+
+static double bench_now() {
+#ifdef _WIN32
+	LARGE_INTEGER t, f;
+	QueryPerformanceCounter(&t);
+	QueryPerformanceFrequency(&f);
+	return (double)t.QuadPart / (double)f.QuadPart;
+#else
+	struct timespec t;
+	clock_gettime(CLOCK_MONOTONIC, &t);
+	return t.tv_sec + t.tv_nsec * 1e-9;
+#endif
+}
+
+static size_t bench_peak_rss_kb() {
+#ifdef _WIN32
+	PROCESS_MEMORY_COUNTERS m;
+	return GetProcessMemoryInfo(GetCurrentProcess(), &m, sizeof(m)) ? m.PeakWorkingSetSize / 1024 : 0;
+#else
+	struct rusage u;
+	return getrusage(RUSAGE_SELF, &u) == 0 ? (size_t)u.ru_maxrss : 0;	/* kilobytes on Linux */
+#endif
+}
+
+/* Corpus generation */
+struct bench_buffer {
+	char* data;
+	size_t len, capacity;
+	uint64_t seed;	/* xorshift64* state */
+};
+
+static void bench_put(bench_buffer* b, const char* s, size_t len) {
+	if (b->len + len + 1 > b->capacity) {
+		while (b->len + len + 1 > b->capacity)
+			b->capacity += b->capacity / 2 + 4096;
+		b->data = (char*)realloc(b->data, b->capacity);
+	}
+	memcpy(b->data + b->len, s, len);
+	b->data[b->len += len] = '\0';
+}
+
+#define BENCH_PUTS(b, s) bench_put(b, s, sizeof(s) - 1)
+
+static void bench_puts(bench_buffer* b, const char* s) {
+	bench_put(b, s, strlen(s));
+}
+
+static unsigned bench_random(bench_buffer* b, unsigned n) {	/* 0..n-1 */
+	b->seed ^= b->seed >> 12;
+	b->seed ^= b->seed << 25;
+	b->seed ^= b->seed >> 27;
+	return (unsigned)((b->seed * ((uint64_t)0x2545F491 << 32 | 0x4F6CDD1D)) >> 33) % n;
+}
+
+static void bench_put_u64(bench_buffer* b, uint64_t x) {
+	char s[24], *p = s + sizeof(s);
+	do
+		*--p = (char)('0' + x % 10);
+	while ((x /= 10) != 0);
+	bench_put(b, p, s + sizeof(s) - p);
+}
+
+static void bench_utf8(bench_buffer* b, unsigned u) {
+	char s[4];
+	if (u < 0x80)
+		s[0] = (char)u;
+	else if (u < 0x800) {
+		s[0] = (char)(0xC0 | u >> 6);
+		s[1] = (char)(0x80 | (u & 0x3F));
+	}
+	else {
+		s[0] = (char)(0xE0 | u >> 12);
+		s[1] = (char)(0x80 | (u >> 6 & 0x3F));
+		s[2] = (char)(0x80 | (u & 0x3F));
+	}
+	bench_put(b, s, u < 0x80 ? 1 : u < 0x800 ? 2 : 3);
+}
+
+/* A quoted string of about len characters: words, Japanese, escapes and emoji */
+static void bench_text(bench_buffer* b, unsigned len, bool ascii) {
+	char s[16];
+	unsigned i, r;
+	BENCH_PUTS(b, "\"");
+	for (i = 0; i < len; i++) {
+		r = bench_random(b, 100);
+		if (ascii || r < 55)
+			bench_utf8(b, bench_random(b, 6) == 0 ? ' ' : 'a' + bench_random(b, 26));
+		else if (r < 75)
+			bench_utf8(b, 0x3041 + bench_random(b, 0x56));	/* hiragana */
+		else if (r < 90)
+			bench_utf8(b, 0x4E00 + bench_random(b, 0x5200));	/* CJK ideographs */
+		else if (r < 94)
+			bench_put(b, s, sprintf(s, "\\u%04X", 0x00C0 + bench_random(b, 0x3F)));
+		else if (r < 97)
+			bench_put(b, s, sprintf(s, "\\uD83D\\u%04X", 0xDE00 + bench_random(b, 0x50)));	/* emoji */
+		else
+			bench_put(b, "\\n\\\"\\/\\\\" + 2 * bench_random(b, 4), 2);
+	}
+	BENCH_PUTS(b, "\"");
+}
+
+static void bench_canada(bench_buffer* b, size_t size) {
+	char s[64];
+	double x = -65.613616999999977, y = 43.420273000000009;
+	unsigned i;
+	BENCH_PUTS(b, "{\"type\":\"FeatureCollection\",\"features\":[{\"type\":\"Feature\",\"properties\":{\"name\":\"Canada\"},"
+		"\"geometry\":{\"type\":\"Polygon\",\"coordinates\":[");
+	do {
+		bench_puts(b, b->data[b->len - 1] == '[' ? "[" : ",[");
+		for (i = 0; i < 512; i++) {
+			x += (bench_random(b, 2000001) - 1000000.0) * 1e-8;
+			y += (bench_random(b, 2000001) - 1000000.0) * 1e-8;
+			bench_put(b, s, sprintf(s, "%s[%.17g,%.17g]", i ? "," : "", x, y));
+		}
+		BENCH_PUTS(b, "]");
+	} while (b->len < size);
+	BENCH_PUTS(b, "]}}]}");
+}
+
+static void bench_twitter(bench_buffer* b, size_t size) {
+	static const char* langs[] = { "ja", "en", "es", "und" };
+	char s[128];
+	uint64_t id = (uint64_t)117783184 << 32 | 797065217;	/* 505874924095815681 */
+	unsigned i, n;
+	BENCH_PUTS(b, "{\"statuses\":[");
+	do {
+		id += 1 + bench_random(b, 1000000);
+		if (b->data[b->len - 1] != '[')
+			BENCH_PUTS(b, ",");
+		bench_put(b, s, sprintf(s, "{\"created_at\":\"Sun Aug 31 00:%02u:%02u +0000 2014\",\"id\":", bench_random(b, 60), bench_random(b, 60)));
+		bench_put_u64(b, id);
+		BENCH_PUTS(b, ",\"id_str\":\"");
+		bench_put_u64(b, id);
+		BENCH_PUTS(b, "\",\"text\":");
+		bench_text(b, 20 + bench_random(b, 120), false);
+		BENCH_PUTS(b, ",\"source\":\"<a href=\\\"http://twitter.com/download/iphone\\\" rel=\\\"nofollow\\\">Twitter for iPhone</a>\","
+			"\"truncated\":false,\"in_reply_to_status_id\":null,\"in_reply_to_screen_name\":null,\"user\":{\"id\":");
+		bench_put(b, s, sprintf(s, "%u,\"name\":", 1000000 + bench_random(b, 2000000000)));
+		bench_text(b, 4 + bench_random(b, 12), false);
+		BENCH_PUTS(b, ",\"screen_name\":");
+		bench_text(b, 4 + bench_random(b, 10), true);
+		BENCH_PUTS(b, ",\"description\":");
+		bench_text(b, bench_random(b, 80), false);
+		bench_put(b, s, sprintf(s, ",\"followers_count\":%u,\"friends_count\":%u,\"verified\":%s,\"profile_background_color\":\"C0DEED\"},",
+			bench_random(b, 100000), bench_random(b, 5000), bench_random(b, 20) ? "false" : "true"));
+		BENCH_PUTS(b, "\"entities\":{\"hashtags\":[");
+		for (i = 0, n = bench_random(b, 3); i < n; i++) {
+			bench_puts(b, i ? ",{\"text\":" : "{\"text\":");
+			bench_text(b, 3 + bench_random(b, 8), false);
+			bench_put(b, s, sprintf(s, ",\"indices\":[%u,%u]}", 10 * i, 10 * i + 8));
+		}
+		BENCH_PUTS(b, "],\"urls\":[],\"user_mentions\":[]},");
+		bench_put(b, s, sprintf(s, "\"retweet_count\":%u,\"favorite_count\":%u,\"favorited\":false,\"retweeted\":false,\"lang\":\"%s\"}",
+			bench_random(b, 1000), bench_random(b, 1000), langs[bench_random(b, 4)]));
+	} while (b->len < size);
+	BENCH_PUTS(b, "],\"search_metadata\":{\"completed_in\":0.087,\"max_id\":505874924095815681,\"count\":100}}");
+}
+
+static void bench_nested(bench_buffer* b, size_t size) {
+	char s[32];
+	unsigned i;
+	BENCH_PUTS(b, "[");
+	do {
+		if (b->data[b->len - 1] != '[')
+			BENCH_PUTS(b, ",");
+		for (i = 0; i < LEPT_BENCH_DEPTH; i++)
+			if (i % 2)
+				BENCH_PUTS(b, "[true,");
+			else
+				bench_put(b, s, sprintf(s, "{\"id\":%u,\"child\":", bench_random(b, 1000)));
+		bench_put(b, s, sprintf(s, "%u", bench_random(b, 1000000)));
+		for (i = LEPT_BENCH_DEPTH; i > 0; i--)
+			bench_puts(b, i % 2 ? "}" : "]");
+	} while (b->len < size);
+	BENCH_PUTS(b, "]");
+}
+
+static void bench_wide(bench_buffer* b, size_t size) {
+	char s[64];
+	unsigned i = 0;
+	BENCH_PUTS(b, "{");
+	do {
+		bench_put(b, s, sprintf(s, "%s\"key%07u\":", i ? "," : "", i));
+		switch (i++ % 4) {
+			case 0: bench_put(b, s, sprintf(s, "%u", bench_random(b, 100000000))); break;
+			case 1: bench_text(b, 4 + bench_random(b, 12), true); break;
+			case 2: BENCH_PUTS(b, "true"); break;
+			default: BENCH_PUTS(b, "null"); break;
+		}
+	} while (b->len < size);
+	BENCH_PUTS(b, "}");
+}
+
+struct bench_corpus {
+	const char* name;
+	void (*generate)(bench_buffer* b, size_t size);
+};
+
+static const bench_corpus bench_corpora[] = {
+	{ "canada", bench_canada },
+	{ "twitter", bench_twitter },
+	{ "nested", bench_nested },
+	{ "wide", bench_wide }
+};
+
+/* Measurement */
+struct bench_result {
+	double parse, stringify, free, roundtrip;	/* best seconds */
+	size_t output;
+	lept_alloc_stats parse_allocs, stringify_allocs;
+};
+
+static double bench_min(double a, double b) {
+	return a < b ? a : b;
+}
+
+static bool bench_run(const char* json, size_t len, int repeat, bench_result* r) {
+	lept_value v;
+	double t0, t1, t2, t3;
+	char* s;
+	int i;
+	r->parse = r->stringify = r->free = r->roundtrip = 1e300;
+	lept_init(&v);
+	lept_count_allocs(&r->parse_allocs);
+	if (lept_parse_n(&v, json, len) != LEPT_PARSE_OK)
+		return false;
+	lept_count_allocs(&r->stringify_allocs);
+	free(lept_stringify(&v, NULL));
+	lept_count_allocs(NULL);
+	lept_free(&v);
+	for (i = 0; i < repeat; i++) {
+		lept_init(&v);
+		t0 = bench_now();
+		if (lept_parse_n(&v, json, len) != LEPT_PARSE_OK)
+			return false;
+		t1 = bench_now();
+		s = lept_stringify(&v, &r->output);
+		t2 = bench_now();
+		lept_free(&v);
+		t3 = bench_now();
+		free(s);
+		r->parse = bench_min(r->parse, t1 - t0);
+		r->stringify = bench_min(r->stringify, t2 - t1);
+		r->free = bench_min(r->free, t3 - t2);
+		r->roundtrip = bench_min(r->roundtrip, t3 - t0);
+	}
+	return true;
+}
+
+static double bench_mbps(size_t bytes, double seconds) {
+	double mbps = bytes / seconds * 1e-6;
+	return floor(mbps * 100 + 0.5) / 100;	/* two decimals */
+}
+
+static void bench_set(lept_value* o, const char* key, double n) {
+	lept_set_number(lept_set_object_value(o, key, strlen(key)), n);
+}
+
+static size_t bench_size(const char* s) {
+	char* end;
+	size_t n = (size_t)strtoul(s, &end, 10);
+	return *end == 'K' || *end == 'k' ? n << 10 : *end == 'M' || *end == 'm' ? n << 20 : n;
+}
+
+int main(int argc, char** argv) {
+	static const char* default_sizes[] = { "64K", "1M", "16M" };
+	const char* const* sizes = default_sizes;
+	const char* output = NULL, *dir = NULL;
+	int repeat = 5, nsizes = 3, i, j, ret = 0;
+	lept_value results, *r;
+	bench_buffer b;
+	bench_result m;
+	char path[1024];
+	lept_sink sink;
+	FILE* fp;
+
+	for (i = 1; i < argc && argv[i][0] == '-'; i += 2) {
+		if (i + 1 == argc || strlen(argv[i]) != 2 || !strchr("row", argv[i][1])) {
+			fprintf(stderr, "usage: %s [-r repeat] [-o results.json] [-w dir] [size...]\n", argv[0]);
+			return 2;
+		}
+		if (argv[i][1] == 'r' && (repeat = atoi(argv[i + 1])) < 1)
+			repeat = 1;
+		if (argv[i][1] == 'o')
+			output = argv[i + 1];
+		if (argv[i][1] == 'w')
+			dir = argv[i + 1];
+	}
+	if (i < argc) {
+		sizes = (const char* const*)argv + i;
+		nsizes = argc - i;
+	}
+
+	lept_init(&results);
+	lept_set_array(&results, 0);
+	printf("%-8s %9s %9s %9s %9s %9s %9s %11s %11s %9s %10s\n", "corpus", "bytes", "parse", "stringify", "free", "roundtrip",
+		"allocs", "alloc peak", "stack", "str peak", "peak RSS");
+	for (i = 0; i < (int)(sizeof(bench_corpora) / sizeof(bench_corpora[0])); i++)
+		for (j = 0; j < nsizes; j++) {
+			memset(&b, 0, sizeof(b));
+			b.seed = (uint64_t)0x0139408D << 32 | 0xCBBF7A44;
+			bench_corpora[i].generate(&b, bench_size(sizes[j]));
+			if (dir) {
+				sprintf(path, "%.960s/%s-%.20s.json", dir, bench_corpora[i].name, sizes[j]);
+				if ((fp = fopen(path, "wb")) != NULL) {
+					fwrite(b.data, 1, b.len, fp);
+					fclose(fp);
+				}
+			}
+			if (!bench_run(b.data, b.len, repeat, &m)) {
+				fprintf(stderr, "%s-%s: parse error\n", bench_corpora[i].name, sizes[j]);
+				free(b.data);
+				ret = 1;
+				continue;
+			}
+			printf("%-8s %9lu %9.1f %9.1f %9.1f %9.1f %9lu %11lu %11lu %9lu %10lu\n", bench_corpora[i].name, (unsigned long)b.len,
+				bench_mbps(b.len, m.parse), bench_mbps(m.output, m.stringify), bench_mbps(b.len, m.free), bench_mbps(b.len, m.roundtrip),
+				(unsigned long)m.parse_allocs.allocs, (unsigned long)m.parse_allocs.peak, (unsigned long)m.parse_allocs.stack,
+				(unsigned long)m.stringify_allocs.peak, (unsigned long)bench_peak_rss_kb());
+			r = lept_pushback_array_element(&results);
+			lept_set_object(r, 16);
+			lept_set_string(lept_set_object_value(r, "corpus", 6), bench_corpora[i].name, strlen(bench_corpora[i].name));
+			bench_set(r, "bytes", (double)b.len);
+			bench_set(r, "parse_mbps", bench_mbps(b.len, m.parse));
+			bench_set(r, "stringify_mbps", bench_mbps(m.output, m.stringify));
+			bench_set(r, "free_mbps", bench_mbps(b.len, m.free));
+			bench_set(r, "roundtrip_mbps", bench_mbps(b.len, m.roundtrip));
+			bench_set(r, "parse_allocs", (double)m.parse_allocs.allocs);
+			bench_set(r, "parse_alloc_bytes", (double)m.parse_allocs.bytes);
+			bench_set(r, "parse_peak_bytes", (double)m.parse_allocs.peak);
+			bench_set(r, "parse_stack_bytes", (double)m.parse_allocs.stack);
+			bench_set(r, "stringify_allocs", (double)m.stringify_allocs.allocs);
+			bench_set(r, "stringify_peak_bytes", (double)m.stringify_allocs.peak);
+			bench_set(r, "peak_rss_kb", (double)bench_peak_rss_kb());
+			free(b.data);
+		}
+	if (output) {
+		if ((fp = fopen(output, "w")) != NULL)
+			sink = lept_sink_file(fp);
+		if (fp == NULL || lept_stringify_to(&results, &sink) != LEPT_STRINGIFY_OK) {
+			fprintf(stderr, "cannot write %s\n", output);
+			ret = 1;
+		}
+		if (fp)
+			fclose(fp);
+	}
+	lept_free(&results);
+	return ret;
+}
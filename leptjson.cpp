@@ -5,21 +5,172 @@
 
 #include "leptjson.h"
 #include <assert.h>		/* assert() */
-#include <stdlib.h>		/* NULL, strtod(), malloc(), realloc(), free() */
-#include <errno.h>		/* errno, ERANGE */
-#include <math.h>		/* HUGE_VAL */
+#include <stdlib.h>		/* NULL, malloc(), realloc(), free() */
+#include <stdint.h>		/* uint64_t, intptr_t */
+#include <errno.h>		/* errno, EINTR */
 #include <string.h>		/* memcpt() */
 #include <stdio.h>   /* sprintf() */
 
+#if defined(_WIN32)
+#include <windows.h>	/* CreateFileMapping(), MapViewOfFile() */
+#include <io.h>			/* _write() */
+#else
+#include <fcntl.h>		/* open() */
+#include <sys/mman.h>	/* mmap(), madvise(), munmap() */
+#include <sys/stat.h>	/* fstat() */
+#include <unistd.h>		/* close(), write(), sysconf() */
+#include <pthread.h>	/* pthread_create(), pthread_mutex_t, pthread_cond_t */
+#endif
+
+#if defined(__SSE2__) || defined(_M_X64) || (defined(_M_IX86_FP) && _M_IX86_FP >= 2)
+#define LEPT_SSE2
+#include <emmintrin.h>	/* SSE2 intrinsics */
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define LEPT_AVX2	/* compiled with a target attribute, selected at runtime */
+#include <immintrin.h>
+#endif
+#endif
+
 const int LEPT_PARSE_STACK_INIT_SIZE = 256;
 const int LEPT_PARSE_STRINGIFY_INIT_SIZE = 256;
+const size_t LEPT_ARENA_BLOCK_SIZE = 64 * 1024;
+const size_t LEPT_STRINGIFY_FLUSH_SIZE = 64 * 1024;	/* lept_stringify_to() writes once this much is buffered */
+const size_t LEPT_STRINGIFY_STRING_CHUNK = 4096;	/* bytes of a string escaped at a time */
+const size_t LEPT_PARSE_MAX_DEPTH = 1024;	/* the default of lept_set_max_depth() */
+const size_t LEPT_WALK_LOCAL_FRAMES = 32;	/* a tree walk allocates frames only below this depth */
+
+/* A container open in the parse: values are not recursed into, their frames are on lept_context */
+struct lept_parse_frame {
+	size_t size;	/* elements or members so far */
+	bool object;
+};
 
 struct lept_context {	// To reduce the number of parameters passed to paser-function, data is put into a stucture
 	const char* json;
+	const char* end;	/* one past the last input byte, the input need not be NUL-terminated */
 	char* stack;
 	size_t size, top;
+	lept_arena* arena;	/* NULL: parsed values own malloc'd storage */
+	bool insitu;	/* strings are decoded in place and borrowed from the input buffer */
+	const lept_sink* sink;	/* stringify: NULL keeps the whole output on the stack */
+	bool sink_failed;
+	lept_parse_frame* frames;	/* the open containers, innermost last */
+	size_t depth, frame_capacity, max_depth;
+};
+
+struct lept_arena_block {
+	lept_arena_block* next;
+	size_t size, used;	/* usable bytes after the header, bytes handed out */
 };
 
+/* Every allocation is aligned for lept_value/lept_member (pointers, size_t and double) */
+inline size_t LEPT_ARENA_ALIGN(size_t n) {
+	return (n + sizeof(double) - 1) & ~(sizeof(double) - 1);
+}
+
+inline char* LEPT_ARENA_DATA(lept_arena_block* b) {
+	return (char*)b + LEPT_ARENA_ALIGN(sizeof(lept_arena_block));
+}
+
+/*
+	Allocation: every allocation goes through the allocator set by lept_set_allocator(). The
+	counters of lept_count_allocs() are kept per thread; sizes of 0 passed for the old size of a
+	realloc or the size of a free are unknown and not subtracted from the bytes held.
+*/
+#if defined(_MSC_VER)
+#define LEPT_THREAD_LOCAL __declspec(thread)
+#else
+#define LEPT_THREAD_LOCAL __thread
+#endif
+
+static void* lept_default_allocate(void*, size_t size) {
+	return malloc(size);
+}
+
+static void* lept_default_reallocate(void*, void* p, size_t size) {
+	return realloc(p, size);
+}
+
+static void lept_default_deallocate(void*, void* p) {
+	free(p);
+}
+
+#if defined(_MSC_VER)
+inline int64_t lept_atomic_load(volatile int64_t* p) { return InterlockedCompareExchange64(p, 0, 0); }
+inline void lept_atomic_store(volatile int64_t* p, int64_t x) { InterlockedExchange64(p, x); }
+inline int64_t lept_atomic_increment(volatile int64_t* p) { return InterlockedIncrement64(p); }
+#else
+inline int64_t lept_atomic_load(volatile int64_t* p) { return __atomic_load_n(p, __ATOMIC_SEQ_CST); }
+inline void lept_atomic_store(volatile int64_t* p, int64_t x) { __atomic_store_n(p, x, __ATOMIC_SEQ_CST); }
+inline int64_t lept_atomic_increment(volatile int64_t* p) { return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST); }
+#endif
+
+static lept_allocator lept_allocator_current = { lept_default_allocate, lept_default_reallocate, lept_default_deallocate, NULL };
+static LEPT_THREAD_LOCAL lept_alloc_stats* lept_stats;
+static volatile int64_t lept_max_depth = LEPT_PARSE_MAX_DEPTH;	/* process-wide, atomic as it may be set while other threads parse */
+
+void lept_set_allocator(const lept_allocator* a) {
+	static const lept_allocator default_allocator = { lept_default_allocate, lept_default_reallocate, lept_default_deallocate, NULL };
+	assert(a == NULL || (a->allocate != NULL && a->reallocate != NULL && a->deallocate != NULL));
+	lept_allocator_current = a ? *a : default_allocator;
+}
+
+void lept_set_max_depth(size_t depth) {
+	lept_atomic_store(&lept_max_depth, (int64_t)(depth ? depth : LEPT_PARSE_MAX_DEPTH));
+}
+
+/* Read once by each parse or load, which keeps the limit it started with */
+inline size_t lept_get_max_depth() {
+	return (size_t)lept_atomic_load(&lept_max_depth);
+}
+
+void lept_count_allocs(lept_alloc_stats* stats) {
+	if (stats)
+		memset(stats, 0, sizeof(*stats));
+	lept_stats = stats;
+}
+
+static void lept_count_alloc(lept_alloc_stats* s, size_t old, size_t size) {
+	s->allocs++;
+	s->bytes += size;
+	s->held += size - (old < s->held ? old : s->held);
+	if (s->held > s->peak)
+		s->peak = s->held;
+}
+
+static void lept_count_stack(size_t size) {
+	if (lept_stats && size > lept_stats->stack)
+		lept_stats->stack = size;
+}
+
+static void* lept_mem_alloc(size_t size) {
+	lept_alloc_stats* s = lept_stats;
+	if (s)
+		lept_count_alloc(s, 0, size);
+	return lept_allocator_current.allocate(lept_allocator_current.user, size);
+}
+
+static void* lept_mem_calloc(size_t count, size_t size) {
+	void* p = count <= (size_t)-1 / size ? lept_mem_alloc(count * size) : NULL;
+	if (p)
+		memset(p, 0, count * size);
+	return p;
+}
+
+static void* lept_mem_realloc(void* p, size_t old, size_t size) {
+	lept_alloc_stats* s = lept_stats;
+	if (s)
+		lept_count_alloc(s, p ? old : 0, size);
+	return lept_allocator_current.reallocate(lept_allocator_current.user, p, size);
+}
+
+static void lept_mem_free(void* p, size_t size) {
+	lept_alloc_stats* s = lept_stats;
+	if (s && p)
+		s->held -= size < s->held ? size : s->held;
+	lept_allocator_current.deallocate(lept_allocator_current.user, p);
+}
+
 inline void EXPECT(lept_context* c, char ch) {
 	assert(*c->json == (ch));
 	c->json++;
@@ -33,23 +184,33 @@ inline bool ISDIGIT(char ch) {
 	return (ch >= '0' && ch <= '9');
 }
 
+inline char CHAR_AT(const char* p, const char* end) {	// '\0' stands in for the end of the input
+	return p != end ? *p : '\0';
+}
+
+inline bool PEEK(lept_context* c, char ch) {
+	return c->json != c->end && *c->json == ch;
+}
+
 static void* lept_context_push(lept_context* c, size_t size) {
 	void* ret;
 	assert(size > 0);
 	if (c->top + size >= c->size) {
+		size_t old = c->size;
 		if (c->size == 0) {
 			c->size = LEPT_PARSE_STACK_INIT_SIZE;
 		}
 		while (c->top + size >= c->size) {
 			c->size += c->size >> 1;	/* c->size * 1.5 */
 		}
-		char* new_ptr = (char*)realloc(c->stack, c->size);
+		char* new_ptr = (char*)lept_mem_realloc(c->stack, old, c->size);
 		if (!new_ptr) { // Memory allocation failed
 			// TODO
 			return NULL;
 		}
 		else {
 			c->stack = new_ptr;
+			lept_count_stack(c->size);
 		}
 	}
 	ret = c->stack + c->top;
@@ -70,136 +231,1605 @@ static void* lept_context_pop(lept_context* c, size_t size) {
 	return c->stack + (c->top -= size);
 }
 
-inline void lept_init(lept_value * v) {
+static void lept_context_init(lept_context* c, const char* json, size_t len) {
+	c->json = json;
+	c->end = json + len;
+	c->stack = NULL;
+	c->size = c->top = 0;
+	c->arena = NULL;
+	c->insitu = false;
+	c->sink = NULL;
+	c->sink_failed = false;
+	c->frames = NULL;
+	c->depth = c->frame_capacity = 0;
+	c->max_depth = lept_get_max_depth();
+}
+
+static void lept_context_free(lept_context* c) {
+	lept_mem_free(c->stack, c->size);
+	lept_mem_free(c->frames, c->frame_capacity * sizeof(lept_parse_frame));
+}
+
+/* Opens a container, or returns NULL when it would be nested deeper than c->max_depth */
+static lept_parse_frame* lept_context_open(lept_context* c, bool object) {
+	lept_parse_frame* f;
+	if (c->depth == c->max_depth)
+		return NULL;
+	if (c->depth == c->frame_capacity) {
+		size_t capacity = c->frame_capacity ? 2 * c->frame_capacity : 16;
+		c->frames = (lept_parse_frame*)lept_mem_realloc(c->frames, c->frame_capacity * sizeof(lept_parse_frame), capacity * sizeof(lept_parse_frame));
+		assert(c->frames != NULL);
+		c->frame_capacity = capacity;
+	}
+	f = &c->frames[c->depth++];
+	f->size = 0;
+	f->object = object;
+	return f;
+}
+
+/*
+	lept_free() and the writers walk a tree without recursion: a frame holds a container and the
+	next of its elements or members. The first frames are local, a deeper tree moves them to the heap.
+*/
+struct lept_walk_frame {
+	const lept_value* v;
+	size_t i;
+	size_t off;	/* the offset of the container in a binary snapshot */
+	const lept_value* w;	/* lept_is_equal(): the container compared with v */
+	uint64_t hash;	/* lept_hash(): of the elements or members before i */
+};
+
+struct lept_walk {
+	lept_walk_frame* frames;
+	size_t depth, capacity;
+	lept_walk_frame local[LEPT_WALK_LOCAL_FRAMES];
+};
+
+inline void lept_walk_init(lept_walk* w) {
+	w->frames = w->local;
+	w->depth = 0;
+	w->capacity = LEPT_WALK_LOCAL_FRAMES;
+}
+
+static void lept_walk_free(lept_walk* w) {
+	if (w->frames != w->local)
+		lept_mem_free(w->frames, w->capacity * sizeof(lept_walk_frame));
+}
+
+static void lept_walk_push(lept_walk* w, const lept_value* v) {
+	if (w->depth == w->capacity) {
+		lept_walk_frame* frames = (lept_walk_frame*)lept_mem_alloc(2 * w->capacity * sizeof(lept_walk_frame));
+		assert(frames != NULL);
+		memcpy(frames, w->frames, w->depth * sizeof(lept_walk_frame));
+		lept_walk_free(w);
+		w->frames = frames;
+		w->capacity *= 2;
+	}
+	w->frames[w->depth].v = v;
+	w->frames[w->depth++].i = 0;
+}
+
+/*
+	Hash caches. A value does not know the containers above it, so a change cannot drop their cached
+	hashes itself. lept_hash() labels the values of a tree it caches hashes in with a tree number,
+	kept in the flags above the lept_flag bits, and stamps each cache with the generation of that
+	tree; a change through the API advances the generation of the changed value's tree only. Trees
+	share a number once there are more than LEPT_TREES, which only drops more caches.
+*/
+const unsigned LEPT_TREE_SHIFT = 20;
+const unsigned LEPT_FLAG_MASK = (1u << LEPT_TREE_SHIFT) - 1;	/* the lept_flag bits */
+const unsigned LEPT_TREES = 1u << (32 - LEPT_TREE_SHIFT);
+
+struct lept_hash_cache {
+	uint64_t hash;
+	uint64_t generation;
+	unsigned tree;	/* 0: none */
+};
+
+static volatile int64_t lept_tree_generations[LEPT_TREES];
+static volatile int64_t lept_tree_count;	/* trees numbered so far */
+
+inline unsigned lept_tree(const lept_value* v) {
+	return (v->flags >> LEPT_TREE_SHIFT) & (LEPT_TREES - 1);
+}
+
+inline void lept_set_tree(const lept_value* v, unsigned tree) {	/* like a cached hash, a label does not change the value */
+	lept_value* c = const_cast<lept_value*>(v);
+	c->flags = (c->flags & LEPT_FLAG_MASK) | tree << LEPT_TREE_SHIFT;
+}
+
+/* A change of v through the API: drops the hashes cached in its tree, those of the containers above it */
+inline void lept_hash_invalidate(const lept_value* v) {
+	unsigned tree = lept_tree(v);
+	if (tree)
+		lept_atomic_increment(&lept_tree_generations[tree]);
+}
+
+void lept_init(lept_value * v) {
 	v->type = LEPT_NULL;
+	v->flags = 0;
+}
+
+static void lept_shape_release(lept_shape* shape);
+
+inline bool lept_owns_elements(const lept_value* v) {	// A container whose elements lept_free() walks
+	return (v->type == LEPT_ARRAY || v->type == LEPT_OBJECT) && !(v->flags & LEPT_FLAG_BORROWED);
+}
+
+static void lept_free_scalar(lept_value* v) {
+	if (v->type == LEPT_STRING && !(v->flags & LEPT_FLAG_BORROWED))
+		lept_mem_free(v->u.s.s, v->u.s.len + 1);
+}
+
+/* Releases the storage of a container whose elements or members are released already */
+static void lept_free_container(lept_value* v) {
+	if (v->type == LEPT_ARRAY) {
+		lept_mem_free(v->u.a.e, v->u.a.capacity * sizeof(lept_value));
+		lept_mem_free(v->u.a.hash, sizeof(lept_hash_cache));
+	}
+	else if (v->flags & LEPT_FLAG_SHAPED) {
+		lept_mem_free(v->u.sh.v, v->u.sh.size * sizeof(lept_value));
+		lept_mem_free(v->u.sh.hash, sizeof(lept_hash_cache));
+		lept_shape_release(v->u.sh.shape);
+	}
+	else {
+		lept_mem_free(v->u.o.m, v->u.o.capacity * sizeof(lept_member));
+		lept_mem_free(v->u.o.index, 0);
+	}
+}
+
+/*
+	Releases the elements or members of v from *i on, up to the first one that is a container
+	itself: it is returned to be released before the rest. NULL when none is left.
+*/
+static lept_value* lept_free_elements(lept_value* v, size_t* i) {
+	lept_value* e;
+	size_t k = *i, size;
+	if (v->type == LEPT_ARRAY || (v->flags & LEPT_FLAG_SHAPED)) {
+		e = v->type == LEPT_ARRAY ? v->u.a.e : v->u.sh.v;
+		size = v->type == LEPT_ARRAY ? v->u.a.size : v->u.sh.size;
+		for (; k < size; k++) {
+			if (lept_owns_elements(&e[k])) {
+				*i = k + 1;
+				return &e[k];
+			}
+			lept_free_scalar(&e[k]);
+		}
+	}
+	else {
+		lept_member* m = v->u.o.m;
+		bool keys = !(v->flags & LEPT_FLAG_BORROWED_KEYS);
+		for (size = v->u.o.size; k < size; k++) {
+			if (keys)
+				lept_mem_free(m[k].k, m[k].klen + 1);
+			if (lept_owns_elements(&m[k].v)) {
+				*i = k + 1;
+				return &m[k].v;
+			}
+			lept_free_scalar(&m[k].v);
+		}
+	}
+	return NULL;
 }
 
 void lept_free(lept_value* v) {
+	lept_walk w;
+	lept_value* c, *e;
+	size_t i = 0;
 	assert(v != NULL);
-	switch (v->type) {
-		case LEPT_STRING:
-			free(v->u.s.s);
-			break;
-		case LEPT_ARRAY:
-			for (int i = 0; i < v->u.a.size; i++) {
-				lept_free(&v->u.a.e[i]);	// Call lept_free() function recursively
-			}
-			free(v->u.a.e);
-			break;
-		case LEPT_OBJECT:
-			for (int i = 0; i < v->u.o.size; i++) {
-				free(v->u.o.m[i].k);
-				lept_free(&v->u.o.m[i].v);
+	lept_hash_invalidate(v);
+	if (lept_owns_elements(v)) {	/* the elements of c before c, its enclosing containers wait on w */
+		lept_walk_init(&w);
+		for (c = v; ; ) {
+			if ((e = lept_free_elements(c, &i)) != NULL) {
+				lept_walk_push(&w, c);
+				w.frames[w.depth - 1].i = i;
+				c = e;
+				i = 0;
+				continue;
 			}
-			free(v->u.o.m);
-			break;
-		default: break;
+			lept_free_container(c);
+			if (w.depth == 0)
+				break;
+			c = (lept_value*)w.frames[--w.depth].v;
+			i = w.frames[w.depth].i;
+		}
+		lept_walk_free(&w);
 	}
+	else
+		lept_free_scalar(v);
 	v->type = LEPT_NULL;
+	v->flags = 0;
 }
 
-static void lept_parse_whitespace(lept_context* c) {
-	const char* p = c->json;
-	while (*p == ' ' || *p == '\t' || *p == '\n' || *p == '\r') {	// space/tab/LF/CR
+static lept_arena_block* lept_arena_new_block(size_t size) {
+	lept_arena_block* b = (lept_arena_block*)lept_mem_alloc(LEPT_ARENA_ALIGN(sizeof(lept_arena_block)) + size);
+	if (!b)
+		return NULL;
+	b->next = NULL;
+	b->size = size;
+	b->used = 0;
+	return b;
+}
+
+void lept_arena_init(lept_arena* a, size_t block_size) {
+	assert(a != NULL);
+	a->head = NULL;
+	a->block_size = block_size ? LEPT_ARENA_ALIGN(block_size) : LEPT_ARENA_BLOCK_SIZE;
+}
+
+static void* lept_arena_alloc(lept_arena* a, size_t size) {
+	lept_arena_block* b = a->head;
+	void* ret;
+	size = LEPT_ARENA_ALIGN(size);
+	if (b && b->size - b->used >= size) {
+		ret = LEPT_ARENA_DATA(b) + b->used;
+		b->used += size;
+		return ret;
+	}
+	if (size > a->block_size / 4 && b) {
+		/* Oversized request: give it its own block behind the head so the current block stays usable */
+		lept_arena_block* big = lept_arena_new_block(size);
+		if (!big)
+			return NULL;
+		big->used = size;
+		big->next = b->next;
+		b->next = big;
+		return LEPT_ARENA_DATA(big);
+	}
+	if (!(b = lept_arena_new_block(size > a->block_size ? size : a->block_size)))
+		return NULL;
+	b->next = a->head;
+	a->head = b;
+	b->used = size;
+	return LEPT_ARENA_DATA(b);
+}
+
+void lept_arena_reset(lept_arena* a) {
+	lept_arena_block* b;
+	size_t total;
+	assert(a != NULL);
+	if (!a->head)
+		return;
+	if (!a->head->next) {	// Steady state: a single block is simply rewound
+		a->head->used = 0;
+		return;
+	}
+	/* The previous document needed several blocks: coalesce them so the next one fits into a single block */
+	total = 0;
+	while ((b = a->head) != NULL) {
+		a->head = b->next;
+		total += b->size;
+		lept_mem_free(b, 0);
+	}
+	a->head = lept_arena_new_block(total);
+}
+
+void lept_arena_free(lept_arena* a) {
+	lept_arena_block* b;
+	assert(a != NULL);
+	while ((b = a->head) != NULL) {
+		a->head = b->next;
+		lept_mem_free(b, 0);
+	}
+}
+
+static void* lept_context_alloc(lept_context* c, size_t size) {
+	return c->arena ? lept_arena_alloc(c->arena, size) : lept_mem_alloc(size);
+}
+
+static char* lept_context_strdup(lept_context* c, const char* s, size_t len) {
+	char* ret;
+	if (c->insitu)	// s already points at the NUL-terminated bytes in the input buffer
+		return (char*)s;
+	ret = (char*)lept_context_alloc(c, len + 1);
+	if (len)	// an empty string may come from a stack that was never allocated
+		memcpy(ret, s, len);
+	ret[len] = '\0';
+	return ret;
+}
+
+/*
+	Scanning kernels over [p, end).
+	lept_skip_whitespace() returns the first byte that is not ' ', '\t', '\n' or '\r'.
+	lept_scan_string() returns the first byte that ends a run of unescaped string characters:
+	'"', '\\' or a control character.
+	Both return end when the run reaches the end of the input. The vector versions only load whole
+	blocks that lie inside the input and finish the tail with the scalar loop.
+*/
+inline bool ISWHITESPACE(char ch) {
+	return ch == ' ' || ch == '\t' || ch == '\n' || ch == '\r';
+}
+
+inline bool ISSTRINGSTOP(char ch) {
+	return ch == '\"' || ch == '\\' || (unsigned char)ch < 0x20;
+}
+
+inline unsigned lept_ctz(unsigned mask) {
+	assert(mask != 0);
+#if defined(__GNUC__)
+	return (unsigned)__builtin_ctz(mask);
+#else
+	unsigned n = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+inline unsigned lept_ctz64(uint64_t mask) {
+	assert(mask != 0);
+#if defined(__GNUC__)
+	return (unsigned)__builtin_ctzll(mask);
+#else
+	unsigned n = 0;
+	while (!(mask & 1)) {
+		mask >>= 1;
+		n++;
+	}
+	return n;
+#endif
+}
+
+inline unsigned lept_popcount(unsigned mask) {
+#if defined(__GNUC__)
+	return (unsigned)__builtin_popcount(mask);
+#else
+	unsigned n = 0;
+	for (; mask; mask &= mask - 1)
+		n++;
+	return n;
+#endif
+}
+
+static const char* lept_skip_whitespace_scalar(const char* p, const char* end) {
+	while (p != end && ISWHITESPACE(*p))
+		p++;
+	return p;
+}
+
+static const char* lept_scan_string_scalar(const char* p, const char* end) {
+	while (p != end && !ISSTRINGSTOP(*p))
 		p++;
+	return p;
+}
+
+#ifdef LEPT_SSE2
+static const char* lept_skip_whitespace_sse2(const char* p, const char* end) {
+	const __m128i sp = _mm_set1_epi8(' '), tab = _mm_set1_epi8('\t'), lf = _mm_set1_epi8('\n'), cr = _mm_set1_epi8('\r');
+	for (; end - p >= 16; p += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)p);
+		__m128i ws = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, sp), _mm_cmpeq_epi8(x, tab)),
+			_mm_or_si128(_mm_cmpeq_epi8(x, lf), _mm_cmpeq_epi8(x, cr)));
+		unsigned mask = (unsigned)_mm_movemask_epi8(ws) ^ 0xFFFF;
+		if (mask)
+			return p + lept_ctz(mask);
 	}
-	c->json = p;
+	return lept_skip_whitespace_scalar(p, end);
+}
+
+static const char* lept_scan_string_sse2(const char* p, const char* end) {
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+	for (; end - p >= 16; p += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)p);
+		__m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+			_mm_cmpeq_epi8(_mm_max_epu8(x, ctrl), ctrl));	/* x <= 0x1F */
+		unsigned mask = (unsigned)_mm_movemask_epi8(stop);
+		if (mask)
+			return p + lept_ctz(mask);
+	}
+	return lept_scan_string_scalar(p, end);
+}
+#endif
+
+#ifdef LEPT_AVX2
+__attribute__((target("avx2")))
+static const char* lept_skip_whitespace_avx2(const char* p, const char* end) {
+	const __m256i sp = _mm256_set1_epi8(' '), tab = _mm256_set1_epi8('\t'), lf = _mm256_set1_epi8('\n'), cr = _mm256_set1_epi8('\r');
+	for (; end - p >= 32; p += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)p);
+		__m256i ws = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, sp), _mm256_cmpeq_epi8(x, tab)),
+			_mm256_or_si256(_mm256_cmpeq_epi8(x, lf), _mm256_cmpeq_epi8(x, cr)));
+		unsigned mask = ~(unsigned)_mm256_movemask_epi8(ws);
+		if (mask)
+			return p + lept_ctz(mask);
+	}
+	return lept_skip_whitespace_sse2(p, end);
+}
+
+__attribute__((target("avx2")))
+static const char* lept_scan_string_avx2(const char* p, const char* end) {
+	const __m256i quote = _mm256_set1_epi8('"'), backslash = _mm256_set1_epi8('\\'), ctrl = _mm256_set1_epi8(0x1F);
+	for (; end - p >= 32; p += 32) {
+		__m256i x = _mm256_loadu_si256((const __m256i*)p);
+		__m256i stop = _mm256_or_si256(_mm256_or_si256(_mm256_cmpeq_epi8(x, quote), _mm256_cmpeq_epi8(x, backslash)),
+			_mm256_cmpeq_epi8(_mm256_max_epu8(x, ctrl), ctrl));
+		unsigned mask = (unsigned)_mm256_movemask_epi8(stop);
+		if (mask)
+			return p + lept_ctz(mask);
+	}
+	return lept_scan_string_sse2(p, end);
+}
+#endif
+
+typedef const char* (*lept_scan_func)(const char* p, const char* end);
+
+static const char* lept_skip_whitespace_dispatch(const char* p, const char* end);
+static const char* lept_scan_string_dispatch(const char* p, const char* end);
+
+static lept_scan_func lept_skip_whitespace_impl = lept_skip_whitespace_dispatch;
+static lept_scan_func lept_scan_string_impl = lept_scan_string_dispatch;
+
+/* Selects the kernels on first use; racing threads all store the same pointers */
+static void lept_select_kernels() {
+#if defined(LEPT_AVX2)
+	__builtin_cpu_init();
+	if (__builtin_cpu_supports("avx2")) {
+		lept_skip_whitespace_impl = lept_skip_whitespace_avx2;
+		lept_scan_string_impl = lept_scan_string_avx2;
+		return;
+	}
+#endif
+#if defined(LEPT_SSE2)
+	lept_skip_whitespace_impl = lept_skip_whitespace_sse2;
+	lept_scan_string_impl = lept_scan_string_sse2;
+#else
+	lept_skip_whitespace_impl = lept_skip_whitespace_scalar;
+	lept_scan_string_impl = lept_scan_string_scalar;
+#endif
+}
+
+static const char* lept_skip_whitespace_dispatch(const char* p, const char* end) {
+	lept_select_kernels();
+	return lept_skip_whitespace_impl(p, end);
+}
+
+static const char* lept_scan_string_dispatch(const char* p, const char* end) {
+	lept_select_kernels();
+	return lept_scan_string_impl(p, end);
+}
+
+inline const char* lept_skip_whitespace(const char* p, const char* end) {
+	/* Minified input rarely has whitespace, and when it does the run is often a single byte */
+	if (p == end || !ISWHITESPACE(*p))
+		return p;
+	if (++p == end || !ISWHITESPACE(*p))
+		return p;
+	return lept_skip_whitespace_impl(p, end);
+}
+
+inline const char* lept_scan_string(const char* p, const char* end) {
+	return (p == end || ISSTRINGSTOP(*p)) ? p : lept_scan_string_impl(p, end);
+}
+
+static void lept_parse_whitespace(lept_context* c) {
+	c->json = lept_skip_whitespace(c->json, c->end);
 }
 
-static int lept_parse_literal(lept_context* c, lept_value* v, const char* literal, lept_type type) {
+static int lept_parse_literal(lept_context* c, const char* literal) {
 	size_t i;
 	EXPECT(c, literal[0]);
 	for (i = 0; literal[i + 1]; i++) {
-		if (c->json[i] != literal[i + 1]) {
+		if (c->json + i == c->end || c->json[i] != literal[i + 1]) {
 			return LEPT_PARSE_INVALID_VALUE;
 		}
 	}
 	c->json += i;
-	v->type = type;
 	return LEPT_PARSE_OK;
 }
 
-static int lept_parse_number(lept_context* c, lept_value* v) {
-	/*
-		grammar:
-			number = [ "-" ] int [ frac ] [ exp ]
-			int = "0" / digit1-9 *digit
-			frac = "." 1*digit
-			exp = ("e" / "E") ["-" / "+"] 1*digit
-	*/
-	const char* p = c->json;
+/*
+	Decimal to double, correctly rounded like strtod() but independent of the locale: an exact
+	double computation when the digits and the power of ten are both exact, the Eisel-Lemire
+	algorithm on a 128-bit approximation of the power of ten otherwise, and a big decimal for the
+	rare inputs the approximation cannot decide.
+*/
+#define LEPT_U64(hi, lo) (((uint64_t)(hi) << 32) | (uint64_t)(lo))
 
-	if (*p == '-') p++;
+const int LEPT_POW10_MIN = -348;
+const int LEPT_POW10_MAX = 347;
 
-	if (*p == '0') p++;
-	else {
-		if (!ISDIGIT1TO9(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
-	}
+/* 10^q normalized to 128 bits and truncated, as { high word, low word }, q in [LEPT_POW10_MIN, LEPT_POW10_MAX] */
+static const uint64_t lept_pow10_128[][2] = {
+	{ LEPT_U64(0xfa8fd5a0, 0x081c0288), LEPT_U64(0x1732c869, 0xcd60e453) },	/* 1e-348 */
+	{ LEPT_U64(0x9c99e584, 0x05118195), LEPT_U64(0x0e7fbd42, 0x205c8eb4) },	/* 1e-347 */
+	{ LEPT_U64(0xc3c05ee5, 0x0655e1fa), LEPT_U64(0x521fac92, 0xa873b261) },	/* 1e-346 */
+	{ LEPT_U64(0xf4b0769e, 0x47eb5a78), LEPT_U64(0xe6a797b7, 0x52909ef9) },	/* 1e-345 */
+	{ LEPT_U64(0x98ee4a22, 0xecf3188b), LEPT_U64(0x9028bed2, 0x939a635c) },	/* 1e-344 */
+	{ LEPT_U64(0xbf29dcab, 0xa82fdeae), LEPT_U64(0x7432ee87, 0x3880fc33) },	/* 1e-343 */
+	{ LEPT_U64(0xeef453d6, 0x923bd65a), LEPT_U64(0x113faa29, 0x06a13b3f) },	/* 1e-342 */
+	{ LEPT_U64(0x9558b466, 0x1b6565f8), LEPT_U64(0x4ac7ca59, 0xa424c507) },	/* 1e-341 */
+	{ LEPT_U64(0xbaaee17f, 0xa23ebf76), LEPT_U64(0x5d79bcf0, 0x0d2df649) },	/* 1e-340 */
+	{ LEPT_U64(0xe95a99df, 0x8ace6f53), LEPT_U64(0xf4d82c2c, 0x107973dc) },	/* 1e-339 */
+	{ LEPT_U64(0x91d8a02b, 0xb6c10594), LEPT_U64(0x79071b9b, 0x8a4be869) },	/* 1e-338 */
+	{ LEPT_U64(0xb64ec836, 0xa47146f9), LEPT_U64(0x9748e282, 0x6cdee284) },	/* 1e-337 */
+	{ LEPT_U64(0xe3e27a44, 0x4d8d98b7), LEPT_U64(0xfd1b1b23, 0x08169b25) },	/* 1e-336 */
+	{ LEPT_U64(0x8e6d8c6a, 0xb0787f72), LEPT_U64(0xfe30f0f5, 0xe50e20f7) },	/* 1e-335 */
+	{ LEPT_U64(0xb208ef85, 0x5c969f4f), LEPT_U64(0xbdbd2d33, 0x5e51a935) },	/* 1e-334 */
+	{ LEPT_U64(0xde8b2b66, 0xb3bc4723), LEPT_U64(0xad2c7880, 0x35e61382) },	/* 1e-333 */
+	{ LEPT_U64(0x8b16fb20, 0x3055ac76), LEPT_U64(0x4c3bcb50, 0x21afcc31) },	/* 1e-332 */
+	{ LEPT_U64(0xaddcb9e8, 0x3c6b1793), LEPT_U64(0xdf4abe24, 0x2a1bbf3d) },	/* 1e-331 */
+	{ LEPT_U64(0xd953e862, 0x4b85dd78), LEPT_U64(0xd71d6dad, 0x34a2af0d) },	/* 1e-330 */
+	{ LEPT_U64(0x87d4713d, 0x6f33aa6b), LEPT_U64(0x8672648c, 0x40e5ad68) },	/* 1e-329 */
+	{ LEPT_U64(0xa9c98d8c, 0xcb009506), LEPT_U64(0x680efdaf, 0x511f18c2) },	/* 1e-328 */
+	{ LEPT_U64(0xd43bf0ef, 0xfdc0ba48), LEPT_U64(0x0212bd1b, 0x2566def2) },	/* 1e-327 */
+	{ LEPT_U64(0x84a57695, 0xfe98746d), LEPT_U64(0x014bb630, 0xf7604b57) },	/* 1e-326 */
+	{ LEPT_U64(0xa5ced43b, 0x7e3e9188), LEPT_U64(0x419ea3bd, 0x35385e2d) },	/* 1e-325 */
+	{ LEPT_U64(0xcf42894a, 0x5dce35ea), LEPT_U64(0x52064cac, 0x828675b9) },	/* 1e-324 */
+	{ LEPT_U64(0x818995ce, 0x7aa0e1b2), LEPT_U64(0x7343efeb, 0xd1940993) },	/* 1e-323 */
+	{ LEPT_U64(0xa1ebfb42, 0x19491a1f), LEPT_U64(0x1014ebe6, 0xc5f90bf8) },	/* 1e-322 */
+	{ LEPT_U64(0xca66fa12, 0x9f9b60a6), LEPT_U64(0xd41a26e0, 0x77774ef6) },	/* 1e-321 */
+	{ LEPT_U64(0xfd00b897, 0x478238d0), LEPT_U64(0x8920b098, 0x955522b4) },	/* 1e-320 */
+	{ LEPT_U64(0x9e20735e, 0x8cb16382), LEPT_U64(0x55b46e5f, 0x5d5535b0) },	/* 1e-319 */
+	{ LEPT_U64(0xc5a89036, 0x2fddbc62), LEPT_U64(0xeb2189f7, 0x34aa831d) },	/* 1e-318 */
+	{ LEPT_U64(0xf712b443, 0xbbd52b7b), LEPT_U64(0xa5e9ec75, 0x01d523e4) },	/* 1e-317 */
+	{ LEPT_U64(0x9a6bb0aa, 0x55653b2d), LEPT_U64(0x47b233c9, 0x2125366e) },	/* 1e-316 */
+	{ LEPT_U64(0xc1069cd4, 0xeabe89f8), LEPT_U64(0x999ec0bb, 0x696e840a) },	/* 1e-315 */
+	{ LEPT_U64(0xf148440a, 0x256e2c76), LEPT_U64(0xc00670ea, 0x43ca250d) },	/* 1e-314 */
+	{ LEPT_U64(0x96cd2a86, 0x5764dbca), LEPT_U64(0x38040692, 0x6a5e5728) },	/* 1e-313 */
+	{ LEPT_U64(0xbc807527, 0xed3e12bc), LEPT_U64(0xc6050837, 0x04f5ecf2) },	/* 1e-312 */
+	{ LEPT_U64(0xeba09271, 0xe88d976b), LEPT_U64(0xf7864a44, 0xc633682e) },	/* 1e-311 */
+	{ LEPT_U64(0x93445b87, 0x31587ea3), LEPT_U64(0x7ab3ee6a, 0xfbe0211d) },	/* 1e-310 */
+	{ LEPT_U64(0xb8157268, 0xfdae9e4c), LEPT_U64(0x5960ea05, 0xbad82964) },	/* 1e-309 */
+	{ LEPT_U64(0xe61acf03, 0x3d1a45df), LEPT_U64(0x6fb92487, 0x298e33bd) },	/* 1e-308 */
+	{ LEPT_U64(0x8fd0c162, 0x06306bab), LEPT_U64(0xa5d3b6d4, 0x79f8e056) },	/* 1e-307 */
+	{ LEPT_U64(0xb3c4f1ba, 0x87bc8696), LEPT_U64(0x8f48a489, 0x9877186c) },	/* 1e-306 */
+	{ LEPT_U64(0xe0b62e29, 0x29aba83c), LEPT_U64(0x331acdab, 0xfe94de87) },	/* 1e-305 */
+	{ LEPT_U64(0x8c71dcd9, 0xba0b4925), LEPT_U64(0x9ff0c08b, 0x7f1d0b14) },	/* 1e-304 */
+	{ LEPT_U64(0xaf8e5410, 0x288e1b6f), LEPT_U64(0x07ecf0ae, 0x5ee44dd9) },	/* 1e-303 */
+	{ LEPT_U64(0xdb71e914, 0x32b1a24a), LEPT_U64(0xc9e82cd9, 0xf69d6150) },	/* 1e-302 */
+	{ LEPT_U64(0x892731ac, 0x9faf056e), LEPT_U64(0xbe311c08, 0x3a225cd2) },	/* 1e-301 */
+	{ LEPT_U64(0xab70fe17, 0xc79ac6ca), LEPT_U64(0x6dbd630a, 0x48aaf406) },	/* 1e-300 */
+	{ LEPT_U64(0xd64d3d9d, 0xb981787d), LEPT_U64(0x092cbbcc, 0xdad5b108) },	/* 1e-299 */
+	{ LEPT_U64(0x85f04682, 0x93f0eb4e), LEPT_U64(0x25bbf560, 0x08c58ea5) },	/* 1e-298 */
+	{ LEPT_U64(0xa76c5823, 0x38ed2621), LEPT_U64(0xaf2af2b8, 0x0af6f24e) },	/* 1e-297 */
+	{ LEPT_U64(0xd1476e2c, 0x07286faa), LEPT_U64(0x1af5af66, 0x0db4aee1) },	/* 1e-296 */
+	{ LEPT_U64(0x82cca4db, 0x847945ca), LEPT_U64(0x50d98d9f, 0xc890ed4d) },	/* 1e-295 */
+	{ LEPT_U64(0xa37fce12, 0x6597973c), LEPT_U64(0xe50ff107, 0xbab528a0) },	/* 1e-294 */
+	{ LEPT_U64(0xcc5fc196, 0xfefd7d0c), LEPT_U64(0x1e53ed49, 0xa96272c8) },	/* 1e-293 */
+	{ LEPT_U64(0xff77b1fc, 0xbebcdc4f), LEPT_U64(0x25e8e89c, 0x13bb0f7a) },	/* 1e-292 */
+	{ LEPT_U64(0x9faacf3d, 0xf73609b1), LEPT_U64(0x77b19161, 0x8c54e9ac) },	/* 1e-291 */
+	{ LEPT_U64(0xc795830d, 0x75038c1d), LEPT_U64(0xd59df5b9, 0xef6a2417) },	/* 1e-290 */
+	{ LEPT_U64(0xf97ae3d0, 0xd2446f25), LEPT_U64(0x4b057328, 0x6b44ad1d) },	/* 1e-289 */
+	{ LEPT_U64(0x9becce62, 0x836ac577), LEPT_U64(0x4ee367f9, 0x430aec32) },	/* 1e-288 */
+	{ LEPT_U64(0xc2e801fb, 0x244576d5), LEPT_U64(0x229c41f7, 0x93cda73f) },	/* 1e-287 */
+	{ LEPT_U64(0xf3a20279, 0xed56d48a), LEPT_U64(0x6b435275, 0x78c1110f) },	/* 1e-286 */
+	{ LEPT_U64(0x9845418c, 0x345644d6), LEPT_U64(0x830a1389, 0x6b78aaa9) },	/* 1e-285 */
+	{ LEPT_U64(0xbe5691ef, 0x416bd60c), LEPT_U64(0x23cc986b, 0xc656d553) },	/* 1e-284 */
+	{ LEPT_U64(0xedec366b, 0x11c6cb8f), LEPT_U64(0x2cbfbe86, 0xb7ec8aa8) },	/* 1e-283 */
+	{ LEPT_U64(0x94b3a202, 0xeb1c3f39), LEPT_U64(0x7bf7d714, 0x32f3d6a9) },	/* 1e-282 */
+	{ LEPT_U64(0xb9e08a83, 0xa5e34f07), LEPT_U64(0xdaf5ccd9, 0x3fb0cc53) },	/* 1e-281 */
+	{ LEPT_U64(0xe858ad24, 0x8f5c22c9), LEPT_U64(0xd1b3400f, 0x8f9cff68) },	/* 1e-280 */
+	{ LEPT_U64(0x91376c36, 0xd99995be), LEPT_U64(0x23100809, 0xb9c21fa1) },	/* 1e-279 */
+	{ LEPT_U64(0xb5854744, 0x8ffffb2d), LEPT_U64(0xabd40a0c, 0x2832a78a) },	/* 1e-278 */
+	{ LEPT_U64(0xe2e69915, 0xb3fff9f9), LEPT_U64(0x16c90c8f, 0x323f516c) },	/* 1e-277 */
+	{ LEPT_U64(0x8dd01fad, 0x907ffc3b), LEPT_U64(0xae3da7d9, 0x7f6792e3) },	/* 1e-276 */
+	{ LEPT_U64(0xb1442798, 0xf49ffb4a), LEPT_U64(0x99cd11cf, 0xdf41779c) },	/* 1e-275 */
+	{ LEPT_U64(0xdd95317f, 0x31c7fa1d), LEPT_U64(0x40405643, 0xd711d583) },	/* 1e-274 */
+	{ LEPT_U64(0x8a7d3eef, 0x7f1cfc52), LEPT_U64(0x482835ea, 0x666b2572) },	/* 1e-273 */
+	{ LEPT_U64(0xad1c8eab, 0x5ee43b66), LEPT_U64(0xda324365, 0x0005eecf) },	/* 1e-272 */
+	{ LEPT_U64(0xd863b256, 0x369d4a40), LEPT_U64(0x90bed43e, 0x40076a82) },	/* 1e-271 */
+	{ LEPT_U64(0x873e4f75, 0xe2224e68), LEPT_U64(0x5a7744a6, 0xe804a291) },	/* 1e-270 */
+	{ LEPT_U64(0xa90de353, 0x5aaae202), LEPT_U64(0x711515d0, 0xa205cb36) },	/* 1e-269 */
+	{ LEPT_U64(0xd3515c28, 0x31559a83), LEPT_U64(0x0d5a5b44, 0xca873e03) },	/* 1e-268 */
+	{ LEPT_U64(0x8412d999, 0x1ed58091), LEPT_U64(0xe858790a, 0xfe9486c2) },	/* 1e-267 */
+	{ LEPT_U64(0xa5178fff, 0x668ae0b6), LEPT_U64(0x626e974d, 0xbe39a872) },	/* 1e-266 */
+	{ LEPT_U64(0xce5d73ff, 0x402d98e3), LEPT_U64(0xfb0a3d21, 0x2dc8128f) },	/* 1e-265 */
+	{ LEPT_U64(0x80fa687f, 0x881c7f8e), LEPT_U64(0x7ce66634, 0xbc9d0b99) },	/* 1e-264 */
+	{ LEPT_U64(0xa139029f, 0x6a239f72), LEPT_U64(0x1c1fffc1, 0xebc44e80) },	/* 1e-263 */
+	{ LEPT_U64(0xc9874347, 0x44ac874e), LEPT_U64(0xa327ffb2, 0x66b56220) },	/* 1e-262 */
+	{ LEPT_U64(0xfbe91419, 0x15d7a922), LEPT_U64(0x4bf1ff9f, 0x0062baa8) },	/* 1e-261 */
+	{ LEPT_U64(0x9d71ac8f, 0xada6c9b5), LEPT_U64(0x6f773fc3, 0x603db4a9) },	/* 1e-260 */
+	{ LEPT_U64(0xc4ce17b3, 0x99107c22), LEPT_U64(0xcb550fb4, 0x384d21d3) },	/* 1e-259 */
+	{ LEPT_U64(0xf6019da0, 0x7f549b2b), LEPT_U64(0x7e2a53a1, 0x46606a48) },	/* 1e-258 */
+	{ LEPT_U64(0x99c10284, 0x4f94e0fb), LEPT_U64(0x2eda7444, 0xcbfc426d) },	/* 1e-257 */
+	{ LEPT_U64(0xc0314325, 0x637a1939), LEPT_U64(0xfa911155, 0xfefb5308) },	/* 1e-256 */
+	{ LEPT_U64(0xf03d93ee, 0xbc589f88), LEPT_U64(0x793555ab, 0x7eba27ca) },	/* 1e-255 */
+	{ LEPT_U64(0x96267c75, 0x35b763b5), LEPT_U64(0x4bc1558b, 0x2f3458de) },	/* 1e-254 */
+	{ LEPT_U64(0xbbb01b92, 0x83253ca2), LEPT_U64(0x9eb1aaed, 0xfb016f16) },	/* 1e-253 */
+	{ LEPT_U64(0xea9c2277, 0x23ee8bcb), LEPT_U64(0x465e15a9, 0x79c1cadc) },	/* 1e-252 */
+	{ LEPT_U64(0x92a1958a, 0x7675175f), LEPT_U64(0x0bfacd89, 0xec191ec9) },	/* 1e-251 */
+	{ LEPT_U64(0xb749faed, 0x14125d36), LEPT_U64(0xcef980ec, 0x671f667b) },	/* 1e-250 */
+	{ LEPT_U64(0xe51c79a8, 0x5916f484), LEPT_U64(0x82b7e127, 0x80e7401a) },	/* 1e-249 */
+	{ LEPT_U64(0x8f31cc09, 0x37ae58d2), LEPT_U64(0xd1b2ecb8, 0xb0908810) },	/* 1e-248 */
+	{ LEPT_U64(0xb2fe3f0b, 0x8599ef07), LEPT_U64(0x861fa7e6, 0xdcb4aa15) },	/* 1e-247 */
+	{ LEPT_U64(0xdfbdcece, 0x67006ac9), LEPT_U64(0x67a791e0, 0x93e1d49a) },	/* 1e-246 */
+	{ LEPT_U64(0x8bd6a141, 0x006042bd), LEPT_U64(0xe0c8bb2c, 0x5c6d24e0) },	/* 1e-245 */
+	{ LEPT_U64(0xaecc4991, 0x4078536d), LEPT_U64(0x58fae9f7, 0x73886e18) },	/* 1e-244 */
+	{ LEPT_U64(0xda7f5bf5, 0x90966848), LEPT_U64(0xaf39a475, 0x506a899e) },	/* 1e-243 */
+	{ LEPT_U64(0x888f9979, 0x7a5e012d), LEPT_U64(0x6d8406c9, 0x52429603) },	/* 1e-242 */
+	{ LEPT_U64(0xaab37fd7, 0xd8f58178), LEPT_U64(0xc8e5087b, 0xa6d33b83) },	/* 1e-241 */
+	{ LEPT_U64(0xd5605fcd, 0xcf32e1d6), LEPT_U64(0xfb1e4a9a, 0x90880a64) },	/* 1e-240 */
+	{ LEPT_U64(0x855c3be0, 0xa17fcd26), LEPT_U64(0x5cf2eea0, 0x9a55067f) },	/* 1e-239 */
+	{ LEPT_U64(0xa6b34ad8, 0xc9dfc06f), LEPT_U64(0xf42faa48, 0xc0ea481e) },	/* 1e-238 */
+	{ LEPT_U64(0xd0601d8e, 0xfc57b08b), LEPT_U64(0xf13b94da, 0xf124da26) },	/* 1e-237 */
+	{ LEPT_U64(0x823c1279, 0x5db6ce57), LEPT_U64(0x76c53d08, 0xd6b70858) },	/* 1e-236 */
+	{ LEPT_U64(0xa2cb1717, 0xb52481ed), LEPT_U64(0x54768c4b, 0x0c64ca6e) },	/* 1e-235 */
+	{ LEPT_U64(0xcb7ddcdd, 0xa26da268), LEPT_U64(0xa9942f5d, 0xcf7dfd09) },	/* 1e-234 */
+	{ LEPT_U64(0xfe5d5415, 0x0b090b02), LEPT_U64(0xd3f93b35, 0x435d7c4c) },	/* 1e-233 */
+	{ LEPT_U64(0x9efa548d, 0x26e5a6e1), LEPT_U64(0xc47bc501, 0x4a1a6daf) },	/* 1e-232 */
+	{ LEPT_U64(0xc6b8e9b0, 0x709f109a), LEPT_U64(0x359ab641, 0x9ca1091b) },	/* 1e-231 */
+	{ LEPT_U64(0xf867241c, 0x8cc6d4c0), LEPT_U64(0xc30163d2, 0x03c94b62) },	/* 1e-230 */
+	{ LEPT_U64(0x9b407691, 0xd7fc44f8), LEPT_U64(0x79e0de63, 0x425dcf1d) },	/* 1e-229 */
+	{ LEPT_U64(0xc2109436, 0x4dfb5636), LEPT_U64(0x985915fc, 0x12f542e4) },	/* 1e-228 */
+	{ LEPT_U64(0xf294b943, 0xe17a2bc4), LEPT_U64(0x3e6f5b7b, 0x17b2939d) },	/* 1e-227 */
+	{ LEPT_U64(0x979cf3ca, 0x6cec5b5a), LEPT_U64(0xa705992c, 0xeecf9c42) },	/* 1e-226 */
+	{ LEPT_U64(0xbd8430bd, 0x08277231), LEPT_U64(0x50c6ff78, 0x2a838353) },	/* 1e-225 */
+	{ LEPT_U64(0xece53cec, 0x4a314ebd), LEPT_U64(0xa4f8bf56, 0x35246428) },	/* 1e-224 */
+	{ LEPT_U64(0x940f4613, 0xae5ed136), LEPT_U64(0x871b7795, 0xe136be99) },	/* 1e-223 */
+	{ LEPT_U64(0xb9131798, 0x99f68584), LEPT_U64(0x28e2557b, 0x59846e3f) },	/* 1e-222 */
+	{ LEPT_U64(0xe757dd7e, 0xc07426e5), LEPT_U64(0x331aeada, 0x2fe589cf) },	/* 1e-221 */
+	{ LEPT_U64(0x9096ea6f, 0x3848984f), LEPT_U64(0x3ff0d2c8, 0x5def7621) },	/* 1e-220 */
+	{ LEPT_U64(0xb4bca50b, 0x065abe63), LEPT_U64(0x0fed077a, 0x756b53a9) },	/* 1e-219 */
+	{ LEPT_U64(0xe1ebce4d, 0xc7f16dfb), LEPT_U64(0xd3e84959, 0x12c62894) },	/* 1e-218 */
+	{ LEPT_U64(0x8d3360f0, 0x9cf6e4bd), LEPT_U64(0x64712dd7, 0xabbbd95c) },	/* 1e-217 */
+	{ LEPT_U64(0xb080392c, 0xc4349dec), LEPT_U64(0xbd8d794d, 0x96aacfb3) },	/* 1e-216 */
+	{ LEPT_U64(0xdca04777, 0xf541c567), LEPT_U64(0xecf0d7a0, 0xfc5583a0) },	/* 1e-215 */
+	{ LEPT_U64(0x89e42caa, 0xf9491b60), LEPT_U64(0xf41686c4, 0x9db57244) },	/* 1e-214 */
+	{ LEPT_U64(0xac5d37d5, 0xb79b6239), LEPT_U64(0x311c2875, 0xc522ced5) },	/* 1e-213 */
+	{ LEPT_U64(0xd77485cb, 0x25823ac7), LEPT_U64(0x7d633293, 0x366b828b) },	/* 1e-212 */
+	{ LEPT_U64(0x86a8d39e, 0xf77164bc), LEPT_U64(0xae5dff9c, 0x02033197) },	/* 1e-211 */
+	{ LEPT_U64(0xa8530886, 0xb54dbdeb), LEPT_U64(0xd9f57f83, 0x0283fdfc) },	/* 1e-210 */
+	{ LEPT_U64(0xd267caa8, 0x62a12d66), LEPT_U64(0xd072df63, 0xc324fd7b) },	/* 1e-209 */
+	{ LEPT_U64(0x8380dea9, 0x3da4bc60), LEPT_U64(0x4247cb9e, 0x59f71e6d) },	/* 1e-208 */
+	{ LEPT_U64(0xa4611653, 0x8d0deb78), LEPT_U64(0x52d9be85, 0xf074e608) },	/* 1e-207 */
+	{ LEPT_U64(0xcd795be8, 0x70516656), LEPT_U64(0x67902e27, 0x6c921f8b) },	/* 1e-206 */
+	{ LEPT_U64(0x806bd971, 0x4632dff6), LEPT_U64(0x00ba1cd8, 0xa3db53b6) },	/* 1e-205 */
+	{ LEPT_U64(0xa086cfcd, 0x97bf97f3), LEPT_U64(0x80e8a40e, 0xccd228a4) },	/* 1e-204 */
+	{ LEPT_U64(0xc8a883c0, 0xfdaf7df0), LEPT_U64(0x6122cd12, 0x8006b2cd) },	/* 1e-203 */
+	{ LEPT_U64(0xfad2a4b1, 0x3d1b5d6c), LEPT_U64(0x796b8057, 0x20085f81) },	/* 1e-202 */
+	{ LEPT_U64(0x9cc3a6ee, 0xc6311a63), LEPT_U64(0xcbe33036, 0x74053bb0) },	/* 1e-201 */
+	{ LEPT_U64(0xc3f490aa, 0x77bd60fc), LEPT_U64(0xbedbfc44, 0x11068a9c) },	/* 1e-200 */
+	{ LEPT_U64(0xf4f1b4d5, 0x15acb93b), LEPT_U64(0xee92fb55, 0x15482d44) },	/* 1e-199 */
+	{ LEPT_U64(0x99171105, 0x2d8bf3c5), LEPT_U64(0x751bdd15, 0x2d4d1c4a) },	/* 1e-198 */
+	{ LEPT_U64(0xbf5cd546, 0x78eef0b6), LEPT_U64(0xd262d45a, 0x78a0635d) },	/* 1e-197 */
+	{ LEPT_U64(0xef340a98, 0x172aace4), LEPT_U64(0x86fb8971, 0x16c87c34) },	/* 1e-196 */
+	{ LEPT_U64(0x9580869f, 0x0e7aac0e), LEPT_U64(0xd45d35e6, 0xae3d4da0) },	/* 1e-195 */
+	{ LEPT_U64(0xbae0a846, 0xd2195712), LEPT_U64(0x89748360, 0x59cca109) },	/* 1e-194 */
+	{ LEPT_U64(0xe998d258, 0x869facd7), LEPT_U64(0x2bd1a438, 0x703fc94b) },	/* 1e-193 */
+	{ LEPT_U64(0x91ff8377, 0x5423cc06), LEPT_U64(0x7b6306a3, 0x4627ddcf) },	/* 1e-192 */
+	{ LEPT_U64(0xb67f6455, 0x292cbf08), LEPT_U64(0x1a3bc84c, 0x17b1d542) },	/* 1e-191 */
+	{ LEPT_U64(0xe41f3d6a, 0x7377eeca), LEPT_U64(0x20caba5f, 0x1d9e4a93) },	/* 1e-190 */
+	{ LEPT_U64(0x8e938662, 0x882af53e), LEPT_U64(0x547eb47b, 0x7282ee9c) },	/* 1e-189 */
+	{ LEPT_U64(0xb23867fb, 0x2a35b28d), LEPT_U64(0xe99e619a, 0x4f23aa43) },	/* 1e-188 */
+	{ LEPT_U64(0xdec681f9, 0xf4c31f31), LEPT_U64(0x6405fa00, 0xe2ec94d4) },	/* 1e-187 */
+	{ LEPT_U64(0x8b3c113c, 0x38f9f37e), LEPT_U64(0xde83bc40, 0x8dd3dd04) },	/* 1e-186 */
+	{ LEPT_U64(0xae0b158b, 0x4738705e), LEPT_U64(0x9624ab50, 0xb148d445) },	/* 1e-185 */
+	{ LEPT_U64(0xd98ddaee, 0x19068c76), LEPT_U64(0x3badd624, 0xdd9b0957) },	/* 1e-184 */
+	{ LEPT_U64(0x87f8a8d4, 0xcfa417c9), LEPT_U64(0xe54ca5d7, 0x0a80e5d6) },	/* 1e-183 */
+	{ LEPT_U64(0xa9f6d30a, 0x038d1dbc), LEPT_U64(0x5e9fcf4c, 0xcd211f4c) },	/* 1e-182 */
+	{ LEPT_U64(0xd47487cc, 0x8470652b), LEPT_U64(0x7647c320, 0x0069671f) },	/* 1e-181 */
+	{ LEPT_U64(0x84c8d4df, 0xd2c63f3b), LEPT_U64(0x29ecd9f4, 0x0041e073) },	/* 1e-180 */
+	{ LEPT_U64(0xa5fb0a17, 0xc777cf09), LEPT_U64(0xf4681071, 0x00525890) },	/* 1e-179 */
+	{ LEPT_U64(0xcf79cc9d, 0xb955c2cc), LEPT_U64(0x7182148d, 0x4066eeb4) },	/* 1e-178 */
+	{ LEPT_U64(0x81ac1fe2, 0x93d599bf), LEPT_U64(0xc6f14cd8, 0x48405530) },	/* 1e-177 */
+	{ LEPT_U64(0xa21727db, 0x38cb002f), LEPT_U64(0xb8ada00e, 0x5a506a7c) },	/* 1e-176 */
+	{ LEPT_U64(0xca9cf1d2, 0x06fdc03b), LEPT_U64(0xa6d90811, 0xf0e4851c) },	/* 1e-175 */
+	{ LEPT_U64(0xfd442e46, 0x88bd304a), LEPT_U64(0x908f4a16, 0x6d1da663) },	/* 1e-174 */
+	{ LEPT_U64(0x9e4a9cec, 0x15763e2e), LEPT_U64(0x9a598e4e, 0x043287fe) },	/* 1e-173 */
+	{ LEPT_U64(0xc5dd4427, 0x1ad3cdba), LEPT_U64(0x40eff1e1, 0x853f29fd) },	/* 1e-172 */
+	{ LEPT_U64(0xf7549530, 0xe188c128), LEPT_U64(0xd12bee59, 0xe68ef47c) },	/* 1e-171 */
+	{ LEPT_U64(0x9a94dd3e, 0x8cf578b9), LEPT_U64(0x82bb74f8, 0x301958ce) },	/* 1e-170 */
+	{ LEPT_U64(0xc13a148e, 0x3032d6e7), LEPT_U64(0xe36a5236, 0x3c1faf01) },	/* 1e-169 */
+	{ LEPT_U64(0xf18899b1, 0xbc3f8ca1), LEPT_U64(0xdc44e6c3, 0xcb279ac1) },	/* 1e-168 */
+	{ LEPT_U64(0x96f5600f, 0x15a7b7e5), LEPT_U64(0x29ab103a, 0x5ef8c0b9) },	/* 1e-167 */
+	{ LEPT_U64(0xbcb2b812, 0xdb11a5de), LEPT_U64(0x7415d448, 0xf6b6f0e7) },	/* 1e-166 */
+	{ LEPT_U64(0xebdf6617, 0x91d60f56), LEPT_U64(0x111b495b, 0x3464ad21) },	/* 1e-165 */
+	{ LEPT_U64(0x936b9fce, 0xbb25c995), LEPT_U64(0xcab10dd9, 0x00beec34) },	/* 1e-164 */
+	{ LEPT_U64(0xb84687c2, 0x69ef3bfb), LEPT_U64(0x3d5d514f, 0x40eea742) },	/* 1e-163 */
+	{ LEPT_U64(0xe65829b3, 0x046b0afa), LEPT_U64(0x0cb4a5a3, 0x112a5112) },	/* 1e-162 */
+	{ LEPT_U64(0x8ff71a0f, 0xe2c2e6dc), LEPT_U64(0x47f0e785, 0xeaba72ab) },	/* 1e-161 */
+	{ LEPT_U64(0xb3f4e093, 0xdb73a093), LEPT_U64(0x59ed2167, 0x65690f56) },	/* 1e-160 */
+	{ LEPT_U64(0xe0f218b8, 0xd25088b8), LEPT_U64(0x306869c1, 0x3ec3532c) },	/* 1e-159 */
+	{ LEPT_U64(0x8c974f73, 0x83725573), LEPT_U64(0x1e414218, 0xc73a13fb) },	/* 1e-158 */
+	{ LEPT_U64(0xafbd2350, 0x644eeacf), LEPT_U64(0xe5d1929e, 0xf90898fa) },	/* 1e-157 */
+	{ LEPT_U64(0xdbac6c24, 0x7d62a583), LEPT_U64(0xdf45f746, 0xb74abf39) },	/* 1e-156 */
+	{ LEPT_U64(0x894bc396, 0xce5da772), LEPT_U64(0x6b8bba8c, 0x328eb783) },	/* 1e-155 */
+	{ LEPT_U64(0xab9eb47c, 0x81f5114f), LEPT_U64(0x066ea92f, 0x3f326564) },	/* 1e-154 */
+	{ LEPT_U64(0xd686619b, 0xa27255a2), LEPT_U64(0xc80a537b, 0x0efefebd) },	/* 1e-153 */
+	{ LEPT_U64(0x8613fd01, 0x45877585), LEPT_U64(0xbd06742c, 0xe95f5f36) },	/* 1e-152 */
+	{ LEPT_U64(0xa798fc41, 0x96e952e7), LEPT_U64(0x2c481138, 0x23b73704) },	/* 1e-151 */
+	{ LEPT_U64(0xd17f3b51, 0xfca3a7a0), LEPT_U64(0xf75a1586, 0x2ca504c5) },	/* 1e-150 */
+	{ LEPT_U64(0x82ef8513, 0x3de648c4), LEPT_U64(0x9a984d73, 0xdbe722fb) },	/* 1e-149 */
+	{ LEPT_U64(0xa3ab6658, 0x0d5fdaf5), LEPT_U64(0xc13e60d0, 0xd2e0ebba) },	/* 1e-148 */
+	{ LEPT_U64(0xcc963fee, 0x10b7d1b3), LEPT_U64(0x318df905, 0x079926a8) },	/* 1e-147 */
+	{ LEPT_U64(0xffbbcfe9, 0x94e5c61f), LEPT_U64(0xfdf17746, 0x497f7052) },	/* 1e-146 */
+	{ LEPT_U64(0x9fd561f1, 0xfd0f9bd3), LEPT_U64(0xfeb6ea8b, 0xedefa633) },	/* 1e-145 */
+	{ LEPT_U64(0xc7caba6e, 0x7c5382c8), LEPT_U64(0xfe64a52e, 0xe96b8fc0) },	/* 1e-144 */
+	{ LEPT_U64(0xf9bd690a, 0x1b68637b), LEPT_U64(0x3dfdce7a, 0xa3c673b0) },	/* 1e-143 */
+	{ LEPT_U64(0x9c1661a6, 0x51213e2d), LEPT_U64(0x06bea10c, 0xa65c084e) },	/* 1e-142 */
+	{ LEPT_U64(0xc31bfa0f, 0xe5698db8), LEPT_U64(0x486e494f, 0xcff30a62) },	/* 1e-141 */
+	{ LEPT_U64(0xf3e2f893, 0xdec3f126), LEPT_U64(0x5a89dba3, 0xc3efccfa) },	/* 1e-140 */
+	{ LEPT_U64(0x986ddb5c, 0x6b3a76b7), LEPT_U64(0xf8962946, 0x5a75e01c) },	/* 1e-139 */
+	{ LEPT_U64(0xbe895233, 0x86091465), LEPT_U64(0xf6bbb397, 0xf1135823) },	/* 1e-138 */
+	{ LEPT_U64(0xee2ba6c0, 0x678b597f), LEPT_U64(0x746aa07d, 0xed582e2c) },	/* 1e-137 */
+	{ LEPT_U64(0x94db4838, 0x40b717ef), LEPT_U64(0xa8c2a44e, 0xb4571cdc) },	/* 1e-136 */
+	{ LEPT_U64(0xba121a46, 0x50e4ddeb), LEPT_U64(0x92f34d62, 0x616ce413) },	/* 1e-135 */
+	{ LEPT_U64(0xe896a0d7, 0xe51e1566), LEPT_U64(0x77b020ba, 0xf9c81d17) },	/* 1e-134 */
+	{ LEPT_U64(0x915e2486, 0xef32cd60), LEPT_U64(0x0ace1474, 0xdc1d122e) },	/* 1e-133 */
+	{ LEPT_U64(0xb5b5ada8, 0xaaff80b8), LEPT_U64(0x0d819992, 0x132456ba) },	/* 1e-132 */
+	{ LEPT_U64(0xe3231912, 0xd5bf60e6), LEPT_U64(0x10e1fff6, 0x97ed6c69) },	/* 1e-131 */
+	{ LEPT_U64(0x8df5efab, 0xc5979c8f), LEPT_U64(0xca8d3ffa, 0x1ef463c1) },	/* 1e-130 */
+	{ LEPT_U64(0xb1736b96, 0xb6fd83b3), LEPT_U64(0xbd308ff8, 0xa6b17cb2) },	/* 1e-129 */
+	{ LEPT_U64(0xddd0467c, 0x64bce4a0), LEPT_U64(0xac7cb3f6, 0xd05ddbde) },	/* 1e-128 */
+	{ LEPT_U64(0x8aa22c0d, 0xbef60ee4), LEPT_U64(0x6bcdf07a, 0x423aa96b) },	/* 1e-127 */
+	{ LEPT_U64(0xad4ab711, 0x2eb3929d), LEPT_U64(0x86c16c98, 0xd2c953c6) },	/* 1e-126 */
+	{ LEPT_U64(0xd89d64d5, 0x7a607744), LEPT_U64(0xe871c7bf, 0x077ba8b7) },	/* 1e-125 */
+	{ LEPT_U64(0x87625f05, 0x6c7c4a8b), LEPT_U64(0x11471cd7, 0x64ad4972) },	/* 1e-124 */
+	{ LEPT_U64(0xa93af6c6, 0xc79b5d2d), LEPT_U64(0xd598e40d, 0x3dd89bcf) },	/* 1e-123 */
+	{ LEPT_U64(0xd389b478, 0x79823479), LEPT_U64(0x4aff1d10, 0x8d4ec2c3) },	/* 1e-122 */
+	{ LEPT_U64(0x843610cb, 0x4bf160cb), LEPT_U64(0xcedf722a, 0x585139ba) },	/* 1e-121 */
+	{ LEPT_U64(0xa54394fe, 0x1eedb8fe), LEPT_U64(0xc2974eb4, 0xee658828) },	/* 1e-120 */
+	{ LEPT_U64(0xce947a3d, 0xa6a9273e), LEPT_U64(0x733d2262, 0x29feea32) },	/* 1e-119 */
+	{ LEPT_U64(0x811ccc66, 0x8829b887), LEPT_U64(0x0806357d, 0x5a3f525f) },	/* 1e-118 */
+	{ LEPT_U64(0xa163ff80, 0x2a3426a8), LEPT_U64(0xca07c2dc, 0xb0cf26f7) },	/* 1e-117 */
+	{ LEPT_U64(0xc9bcff60, 0x34c13052), LEPT_U64(0xfc89b393, 0xdd02f0b5) },	/* 1e-116 */
+	{ LEPT_U64(0xfc2c3f38, 0x41f17c67), LEPT_U64(0xbbac2078, 0xd443ace2) },	/* 1e-115 */
+	{ LEPT_U64(0x9d9ba783, 0x2936edc0), LEPT_U64(0xd54b944b, 0x84aa4c0d) },	/* 1e-114 */
+	{ LEPT_U64(0xc5029163, 0xf384a931), LEPT_U64(0x0a9e795e, 0x65d4df11) },	/* 1e-113 */
+	{ LEPT_U64(0xf64335bc, 0xf065d37d), LEPT_U64(0x4d4617b5, 0xff4a16d5) },	/* 1e-112 */
+	{ LEPT_U64(0x99ea0196, 0x163fa42e), LEPT_U64(0x504bced1, 0xbf8e4e45) },	/* 1e-111 */
+	{ LEPT_U64(0xc06481fb, 0x9bcf8d39), LEPT_U64(0xe45ec286, 0x2f71e1d6) },	/* 1e-110 */
+	{ LEPT_U64(0xf07da27a, 0x82c37088), LEPT_U64(0x5d767327, 0xbb4e5a4c) },	/* 1e-109 */
+	{ LEPT_U64(0x964e858c, 0x91ba2655), LEPT_U64(0x3a6a07f8, 0xd510f86f) },	/* 1e-108 */
+	{ LEPT_U64(0xbbe226ef, 0xb628afea), LEPT_U64(0x890489f7, 0x0a55368b) },	/* 1e-107 */
+	{ LEPT_U64(0xeadab0ab, 0xa3b2dbe5), LEPT_U64(0x2b45ac74, 0xccea842e) },	/* 1e-106 */
+	{ LEPT_U64(0x92c8ae6b, 0x464fc96f), LEPT_U64(0x3b0b8bc9, 0x0012929d) },	/* 1e-105 */
+	{ LEPT_U64(0xb77ada06, 0x17e3bbcb), LEPT_U64(0x09ce6ebb, 0x40173744) },	/* 1e-104 */
+	{ LEPT_U64(0xe5599087, 0x9ddcaabd), LEPT_U64(0xcc420a6a, 0x101d0515) },	/* 1e-103 */
+	{ LEPT_U64(0x8f57fa54, 0xc2a9eab6), LEPT_U64(0x9fa94682, 0x4a12232d) },	/* 1e-102 */
+	{ LEPT_U64(0xb32df8e9, 0xf3546564), LEPT_U64(0x47939822, 0xdc96abf9) },	/* 1e-101 */
+	{ LEPT_U64(0xdff97724, 0x70297ebd), LEPT_U64(0x59787e2b, 0x93bc56f7) },	/* 1e-100 */
+	{ LEPT_U64(0x8bfbea76, 0xc619ef36), LEPT_U64(0x57eb4edb, 0x3c55b65a) },	/* 1e-99 */
+	{ LEPT_U64(0xaefae514, 0x77a06b03), LEPT_U64(0xede62292, 0x0b6b23f1) },	/* 1e-98 */
+	{ LEPT_U64(0xdab99e59, 0x958885c4), LEPT_U64(0xe95fab36, 0x8e45eced) },	/* 1e-97 */
+	{ LEPT_U64(0x88b402f7, 0xfd75539b), LEPT_U64(0x11dbcb02, 0x18ebb414) },	/* 1e-96 */
+	{ LEPT_U64(0xaae103b5, 0xfcd2a881), LEPT_U64(0xd652bdc2, 0x9f26a119) },	/* 1e-95 */
+	{ LEPT_U64(0xd59944a3, 0x7c0752a2), LEPT_U64(0x4be76d33, 0x46f0495f) },	/* 1e-94 */
+	{ LEPT_U64(0x857fcae6, 0x2d8493a5), LEPT_U64(0x6f70a440, 0x0c562ddb) },	/* 1e-93 */
+	{ LEPT_U64(0xa6dfbd9f, 0xb8e5b88e), LEPT_U64(0xcb4ccd50, 0x0f6bb952) },	/* 1e-92 */
+	{ LEPT_U64(0xd097ad07, 0xa71f26b2), LEPT_U64(0x7e2000a4, 0x1346a7a7) },	/* 1e-91 */
+	{ LEPT_U64(0x825ecc24, 0xc873782f), LEPT_U64(0x8ed40066, 0x8c0c28c8) },	/* 1e-90 */
+	{ LEPT_U64(0xa2f67f2d, 0xfa90563b), LEPT_U64(0x72890080, 0x2f0f32fa) },	/* 1e-89 */
+	{ LEPT_U64(0xcbb41ef9, 0x79346bca), LEPT_U64(0x4f2b40a0, 0x3ad2ffb9) },	/* 1e-88 */
+	{ LEPT_U64(0xfea126b7, 0xd78186bc), LEPT_U64(0xe2f610c8, 0x4987bfa8) },	/* 1e-87 */
+	{ LEPT_U64(0x9f24b832, 0xe6b0f436), LEPT_U64(0x0dd9ca7d, 0x2df4d7c9) },	/* 1e-86 */
+	{ LEPT_U64(0xc6ede63f, 0xa05d3143), LEPT_U64(0x91503d1c, 0x79720dbb) },	/* 1e-85 */
+	{ LEPT_U64(0xf8a95fcf, 0x88747d94), LEPT_U64(0x75a44c63, 0x97ce912a) },	/* 1e-84 */
+	{ LEPT_U64(0x9b69dbe1, 0xb548ce7c), LEPT_U64(0xc986afbe, 0x3ee11aba) },	/* 1e-83 */
+	{ LEPT_U64(0xc24452da, 0x229b021b), LEPT_U64(0xfbe85bad, 0xce996168) },	/* 1e-82 */
+	{ LEPT_U64(0xf2d56790, 0xab41c2a2), LEPT_U64(0xfae27299, 0x423fb9c3) },	/* 1e-81 */
+	{ LEPT_U64(0x97c560ba, 0x6b0919a5), LEPT_U64(0xdccd879f, 0xc967d41a) },	/* 1e-80 */
+	{ LEPT_U64(0xbdb6b8e9, 0x05cb600f), LEPT_U64(0x5400e987, 0xbbc1c920) },	/* 1e-79 */
+	{ LEPT_U64(0xed246723, 0x473e3813), LEPT_U64(0x290123e9, 0xaab23b68) },	/* 1e-78 */
+	{ LEPT_U64(0x9436c076, 0x0c86e30b), LEPT_U64(0xf9a0b672, 0x0aaf6521) },	/* 1e-77 */
+	{ LEPT_U64(0xb9447093, 0x8fa89bce), LEPT_U64(0xf808e40e, 0x8d5b3e69) },	/* 1e-76 */
+	{ LEPT_U64(0xe7958cb8, 0x7392c2c2), LEPT_U64(0xb60b1d12, 0x30b20e04) },	/* 1e-75 */
+	{ LEPT_U64(0x90bd77f3, 0x483bb9b9), LEPT_U64(0xb1c6f22b, 0x5e6f48c2) },	/* 1e-74 */
+	{ LEPT_U64(0xb4ecd5f0, 0x1a4aa828), LEPT_U64(0x1e38aeb6, 0x360b1af3) },	/* 1e-73 */
+	{ LEPT_U64(0xe2280b6c, 0x20dd5232), LEPT_U64(0x25c6da63, 0xc38de1b0) },	/* 1e-72 */
+	{ LEPT_U64(0x8d590723, 0x948a535f), LEPT_U64(0x579c487e, 0x5a38ad0e) },	/* 1e-71 */
+	{ LEPT_U64(0xb0af48ec, 0x79ace837), LEPT_U64(0x2d835a9d, 0xf0c6d851) },	/* 1e-70 */
+	{ LEPT_U64(0xdcdb1b27, 0x98182244), LEPT_U64(0xf8e43145, 0x6cf88e65) },	/* 1e-69 */
+	{ LEPT_U64(0x8a08f0f8, 0xbf0f156b), LEPT_U64(0x1b8e9ecb, 0x641b58ff) },	/* 1e-68 */
+	{ LEPT_U64(0xac8b2d36, 0xeed2dac5), LEPT_U64(0xe272467e, 0x3d222f3f) },	/* 1e-67 */
+	{ LEPT_U64(0xd7adf884, 0xaa879177), LEPT_U64(0x5b0ed81d, 0xcc6abb0f) },	/* 1e-66 */
+	{ LEPT_U64(0x86ccbb52, 0xea94baea), LEPT_U64(0x98e94712, 0x9fc2b4e9) },	/* 1e-65 */
+	{ LEPT_U64(0xa87fea27, 0xa539e9a5), LEPT_U64(0x3f2398d7, 0x47b36224) },	/* 1e-64 */
+	{ LEPT_U64(0xd29fe4b1, 0x8e88640e), LEPT_U64(0x8eec7f0d, 0x19a03aad) },	/* 1e-63 */
+	{ LEPT_U64(0x83a3eeee, 0xf9153e89), LEPT_U64(0x1953cf68, 0x300424ac) },	/* 1e-62 */
+	{ LEPT_U64(0xa48ceaaa, 0xb75a8e2b), LEPT_U64(0x5fa8c342, 0x3c052dd7) },	/* 1e-61 */
+	{ LEPT_U64(0xcdb02555, 0x653131b6), LEPT_U64(0x3792f412, 0xcb06794d) },	/* 1e-60 */
+	{ LEPT_U64(0x808e1755, 0x5f3ebf11), LEPT_U64(0xe2bbd88b, 0xbee40bd0) },	/* 1e-59 */
+	{ LEPT_U64(0xa0b19d2a, 0xb70e6ed6), LEPT_U64(0x5b6aceae, 0xae9d0ec4) },	/* 1e-58 */
+	{ LEPT_U64(0xc8de0475, 0x64d20a8b), LEPT_U64(0xf245825a, 0x5a445275) },	/* 1e-57 */
+	{ LEPT_U64(0xfb158592, 0xbe068d2e), LEPT_U64(0xeed6e2f0, 0xf0d56712) },	/* 1e-56 */
+	{ LEPT_U64(0x9ced737b, 0xb6c4183d), LEPT_U64(0x55464dd6, 0x9685606b) },	/* 1e-55 */
+	{ LEPT_U64(0xc428d05a, 0xa4751e4c), LEPT_U64(0xaa97e14c, 0x3c26b886) },	/* 1e-54 */
+	{ LEPT_U64(0xf5330471, 0x4d9265df), LEPT_U64(0xd53dd99f, 0x4b3066a8) },	/* 1e-53 */
+	{ LEPT_U64(0x993fe2c6, 0xd07b7fab), LEPT_U64(0xe546a803, 0x8efe4029) },	/* 1e-52 */
+	{ LEPT_U64(0xbf8fdb78, 0x849a5f96), LEPT_U64(0xde985204, 0x72bdd033) },	/* 1e-51 */
+	{ LEPT_U64(0xef73d256, 0xa5c0f77c), LEPT_U64(0x963e6685, 0x8f6d4440) },	/* 1e-50 */
+	{ LEPT_U64(0x95a86376, 0x27989aad), LEPT_U64(0xdde70013, 0x79a44aa8) },	/* 1e-49 */
+	{ LEPT_U64(0xbb127c53, 0xb17ec159), LEPT_U64(0x5560c018, 0x580d5d52) },	/* 1e-48 */
+	{ LEPT_U64(0xe9d71b68, 0x9dde71af), LEPT_U64(0xaab8f01e, 0x6e10b4a6) },	/* 1e-47 */
+	{ LEPT_U64(0x92267121, 0x62ab070d), LEPT_U64(0xcab39613, 0x04ca70e8) },	/* 1e-46 */
+	{ LEPT_U64(0xb6b00d69, 0xbb55c8d1), LEPT_U64(0x3d607b97, 0xc5fd0d22) },	/* 1e-45 */
+	{ LEPT_U64(0xe45c10c4, 0x2a2b3b05), LEPT_U64(0x8cb89a7d, 0xb77c506a) },	/* 1e-44 */
+	{ LEPT_U64(0x8eb98a7a, 0x9a5b04e3), LEPT_U64(0x77f3608e, 0x92adb242) },	/* 1e-43 */
+	{ LEPT_U64(0xb267ed19, 0x40f1c61c), LEPT_U64(0x55f038b2, 0x37591ed3) },	/* 1e-42 */
+	{ LEPT_U64(0xdf01e85f, 0x912e37a3), LEPT_U64(0x6b6c46de, 0xc52f6688) },	/* 1e-41 */
+	{ LEPT_U64(0x8b61313b, 0xbabce2c6), LEPT_U64(0x2323ac4b, 0x3b3da015) },	/* 1e-40 */
+	{ LEPT_U64(0xae397d8a, 0xa96c1b77), LEPT_U64(0xabec975e, 0x0a0d081a) },	/* 1e-39 */
+	{ LEPT_U64(0xd9c7dced, 0x53c72255), LEPT_U64(0x96e7bd35, 0x8c904a21) },	/* 1e-38 */
+	{ LEPT_U64(0x881cea14, 0x545c7575), LEPT_U64(0x7e50d641, 0x77da2e54) },	/* 1e-37 */
+	{ LEPT_U64(0xaa242499, 0x697392d2), LEPT_U64(0xdde50bd1, 0xd5d0b9e9) },	/* 1e-36 */
+	{ LEPT_U64(0xd4ad2dbf, 0xc3d07787), LEPT_U64(0x955e4ec6, 0x4b44e864) },	/* 1e-35 */
+	{ LEPT_U64(0x84ec3c97, 0xda624ab4), LEPT_U64(0xbd5af13b, 0xef0b113e) },	/* 1e-34 */
+	{ LEPT_U64(0xa6274bbd, 0xd0fadd61), LEPT_U64(0xecb1ad8a, 0xeacdd58e) },	/* 1e-33 */
+	{ LEPT_U64(0xcfb11ead, 0x453994ba), LEPT_U64(0x67de18ed, 0xa5814af2) },	/* 1e-32 */
+	{ LEPT_U64(0x81ceb32c, 0x4b43fcf4), LEPT_U64(0x80eacf94, 0x8770ced7) },	/* 1e-31 */
+	{ LEPT_U64(0xa2425ff7, 0x5e14fc31), LEPT_U64(0xa1258379, 0xa94d028d) },	/* 1e-30 */
+	{ LEPT_U64(0xcad2f7f5, 0x359a3b3e), LEPT_U64(0x096ee458, 0x13a04330) },	/* 1e-29 */
+	{ LEPT_U64(0xfd87b5f2, 0x8300ca0d), LEPT_U64(0x8bca9d6e, 0x188853fc) },	/* 1e-28 */
+	{ LEPT_U64(0x9e74d1b7, 0x91e07e48), LEPT_U64(0x775ea264, 0xcf55347d) },	/* 1e-27 */
+	{ LEPT_U64(0xc6120625, 0x76589dda), LEPT_U64(0x95364afe, 0x032a819d) },	/* 1e-26 */
+	{ LEPT_U64(0xf79687ae, 0xd3eec551), LEPT_U64(0x3a83ddbd, 0x83f52204) },	/* 1e-25 */
+	{ LEPT_U64(0x9abe14cd, 0x44753b52), LEPT_U64(0xc4926a96, 0x72793542) },	/* 1e-24 */
+	{ LEPT_U64(0xc16d9a00, 0x95928a27), LEPT_U64(0x75b7053c, 0x0f178293) },	/* 1e-23 */
+	{ LEPT_U64(0xf1c90080, 0xbaf72cb1), LEPT_U64(0x5324c68b, 0x12dd6338) },	/* 1e-22 */
+	{ LEPT_U64(0x971da050, 0x74da7bee), LEPT_U64(0xd3f6fc16, 0xebca5e03) },	/* 1e-21 */
+	{ LEPT_U64(0xbce50864, 0x92111aea), LEPT_U64(0x88f4bb1c, 0xa6bcf584) },	/* 1e-20 */
+	{ LEPT_U64(0xec1e4a7d, 0xb69561a5), LEPT_U64(0x2b31e9e3, 0xd06c32e5) },	/* 1e-19 */
+	{ LEPT_U64(0x9392ee8e, 0x921d5d07), LEPT_U64(0x3aff322e, 0x62439fcf) },	/* 1e-18 */
+	{ LEPT_U64(0xb877aa32, 0x36a4b449), LEPT_U64(0x09befeb9, 0xfad487c2) },	/* 1e-17 */
+	{ LEPT_U64(0xe69594be, 0xc44de15b), LEPT_U64(0x4c2ebe68, 0x7989a9b3) },	/* 1e-16 */
+	{ LEPT_U64(0x901d7cf7, 0x3ab0acd9), LEPT_U64(0x0f9d3701, 0x4bf60a10) },	/* 1e-15 */
+	{ LEPT_U64(0xb424dc35, 0x095cd80f), LEPT_U64(0x538484c1, 0x9ef38c94) },	/* 1e-14 */
+	{ LEPT_U64(0xe12e1342, 0x4bb40e13), LEPT_U64(0x2865a5f2, 0x06b06fb9) },	/* 1e-13 */
+	{ LEPT_U64(0x8cbccc09, 0x6f5088cb), LEPT_U64(0xf93f87b7, 0x442e45d3) },	/* 1e-12 */
+	{ LEPT_U64(0xafebff0b, 0xcb24aafe), LEPT_U64(0xf78f69a5, 0x1539d748) },	/* 1e-11 */
+	{ LEPT_U64(0xdbe6fece, 0xbdedd5be), LEPT_U64(0xb573440e, 0x5a884d1b) },	/* 1e-10 */
+	{ LEPT_U64(0x89705f41, 0x36b4a597), LEPT_U64(0x31680a88, 0xf8953030) },	/* 1e-9 */
+	{ LEPT_U64(0xabcc7711, 0x8461cefc), LEPT_U64(0xfdc20d2b, 0x36ba7c3d) },	/* 1e-8 */
+	{ LEPT_U64(0xd6bf94d5, 0xe57a42bc), LEPT_U64(0x3d329076, 0x04691b4c) },	/* 1e-7 */
+	{ LEPT_U64(0x8637bd05, 0xaf6c69b5), LEPT_U64(0xa63f9a49, 0xc2c1b10f) },	/* 1e-6 */
+	{ LEPT_U64(0xa7c5ac47, 0x1b478423), LEPT_U64(0x0fcf80dc, 0x33721d53) },	/* 1e-5 */
+	{ LEPT_U64(0xd1b71758, 0xe219652b), LEPT_U64(0xd3c36113, 0x404ea4a8) },	/* 1e-4 */
+	{ LEPT_U64(0x83126e97, 0x8d4fdf3b), LEPT_U64(0x645a1cac, 0x083126e9) },	/* 1e-3 */
+	{ LEPT_U64(0xa3d70a3d, 0x70a3d70a), LEPT_U64(0x3d70a3d7, 0x0a3d70a3) },	/* 1e-2 */
+	{ LEPT_U64(0xcccccccc, 0xcccccccc), LEPT_U64(0xcccccccc, 0xcccccccc) },	/* 1e-1 */
+	{ LEPT_U64(0x80000000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e0 */
+	{ LEPT_U64(0xa0000000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e1 */
+	{ LEPT_U64(0xc8000000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e2 */
+	{ LEPT_U64(0xfa000000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e3 */
+	{ LEPT_U64(0x9c400000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e4 */
+	{ LEPT_U64(0xc3500000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e5 */
+	{ LEPT_U64(0xf4240000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e6 */
+	{ LEPT_U64(0x98968000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e7 */
+	{ LEPT_U64(0xbebc2000, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e8 */
+	{ LEPT_U64(0xee6b2800, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e9 */
+	{ LEPT_U64(0x9502f900, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e10 */
+	{ LEPT_U64(0xba43b740, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e11 */
+	{ LEPT_U64(0xe8d4a510, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e12 */
+	{ LEPT_U64(0x9184e72a, 0x00000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e13 */
+	{ LEPT_U64(0xb5e620f4, 0x80000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e14 */
+	{ LEPT_U64(0xe35fa931, 0xa0000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e15 */
+	{ LEPT_U64(0x8e1bc9bf, 0x04000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e16 */
+	{ LEPT_U64(0xb1a2bc2e, 0xc5000000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e17 */
+	{ LEPT_U64(0xde0b6b3a, 0x76400000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e18 */
+	{ LEPT_U64(0x8ac72304, 0x89e80000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e19 */
+	{ LEPT_U64(0xad78ebc5, 0xac620000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e20 */
+	{ LEPT_U64(0xd8d726b7, 0x177a8000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e21 */
+	{ LEPT_U64(0x87867832, 0x6eac9000), LEPT_U64(0x00000000, 0x00000000) },	/* 1e22 */
+	{ LEPT_U64(0xa968163f, 0x0a57b400), LEPT_U64(0x00000000, 0x00000000) },	/* 1e23 */
+	{ LEPT_U64(0xd3c21bce, 0xcceda100), LEPT_U64(0x00000000, 0x00000000) },	/* 1e24 */
+	{ LEPT_U64(0x84595161, 0x401484a0), LEPT_U64(0x00000000, 0x00000000) },	/* 1e25 */
+	{ LEPT_U64(0xa56fa5b9, 0x9019a5c8), LEPT_U64(0x00000000, 0x00000000) },	/* 1e26 */
+	{ LEPT_U64(0xcecb8f27, 0xf4200f3a), LEPT_U64(0x00000000, 0x00000000) },	/* 1e27 */
+	{ LEPT_U64(0x813f3978, 0xf8940984), LEPT_U64(0x40000000, 0x00000000) },	/* 1e28 */
+	{ LEPT_U64(0xa18f07d7, 0x36b90be5), LEPT_U64(0x50000000, 0x00000000) },	/* 1e29 */
+	{ LEPT_U64(0xc9f2c9cd, 0x04674ede), LEPT_U64(0xa4000000, 0x00000000) },	/* 1e30 */
+	{ LEPT_U64(0xfc6f7c40, 0x45812296), LEPT_U64(0x4d000000, 0x00000000) },	/* 1e31 */
+	{ LEPT_U64(0x9dc5ada8, 0x2b70b59d), LEPT_U64(0xf0200000, 0x00000000) },	/* 1e32 */
+	{ LEPT_U64(0xc5371912, 0x364ce305), LEPT_U64(0x6c280000, 0x00000000) },	/* 1e33 */
+	{ LEPT_U64(0xf684df56, 0xc3e01bc6), LEPT_U64(0xc7320000, 0x00000000) },	/* 1e34 */
+	{ LEPT_U64(0x9a130b96, 0x3a6c115c), LEPT_U64(0x3c7f4000, 0x00000000) },	/* 1e35 */
+	{ LEPT_U64(0xc097ce7b, 0xc90715b3), LEPT_U64(0x4b9f1000, 0x00000000) },	/* 1e36 */
+	{ LEPT_U64(0xf0bdc21a, 0xbb48db20), LEPT_U64(0x1e86d400, 0x00000000) },	/* 1e37 */
+	{ LEPT_U64(0x96769950, 0xb50d88f4), LEPT_U64(0x13144480, 0x00000000) },	/* 1e38 */
+	{ LEPT_U64(0xbc143fa4, 0xe250eb31), LEPT_U64(0x17d955a0, 0x00000000) },	/* 1e39 */
+	{ LEPT_U64(0xeb194f8e, 0x1ae525fd), LEPT_U64(0x5dcfab08, 0x00000000) },	/* 1e40 */
+	{ LEPT_U64(0x92efd1b8, 0xd0cf37be), LEPT_U64(0x5aa1cae5, 0x00000000) },	/* 1e41 */
+	{ LEPT_U64(0xb7abc627, 0x050305ad), LEPT_U64(0xf14a3d9e, 0x40000000) },	/* 1e42 */
+	{ LEPT_U64(0xe596b7b0, 0xc643c719), LEPT_U64(0x6d9ccd05, 0xd0000000) },	/* 1e43 */
+	{ LEPT_U64(0x8f7e32ce, 0x7bea5c6f), LEPT_U64(0xe4820023, 0xa2000000) },	/* 1e44 */
+	{ LEPT_U64(0xb35dbf82, 0x1ae4f38b), LEPT_U64(0xdda2802c, 0x8a800000) },	/* 1e45 */
+	{ LEPT_U64(0xe0352f62, 0xa19e306e), LEPT_U64(0xd50b2037, 0xad200000) },	/* 1e46 */
+	{ LEPT_U64(0x8c213d9d, 0xa502de45), LEPT_U64(0x4526f422, 0xcc340000) },	/* 1e47 */
+	{ LEPT_U64(0xaf298d05, 0x0e4395d6), LEPT_U64(0x9670b12b, 0x7f410000) },	/* 1e48 */
+	{ LEPT_U64(0xdaf3f046, 0x51d47b4c), LEPT_U64(0x3c0cdd76, 0x5f114000) },	/* 1e49 */
+	{ LEPT_U64(0x88d8762b, 0xf324cd0f), LEPT_U64(0xa5880a69, 0xfb6ac800) },	/* 1e50 */
+	{ LEPT_U64(0xab0e93b6, 0xefee0053), LEPT_U64(0x8eea0d04, 0x7a457a00) },	/* 1e51 */
+	{ LEPT_U64(0xd5d238a4, 0xabe98068), LEPT_U64(0x72a49045, 0x98d6d880) },	/* 1e52 */
+	{ LEPT_U64(0x85a36366, 0xeb71f041), LEPT_U64(0x47a6da2b, 0x7f864750) },	/* 1e53 */
+	{ LEPT_U64(0xa70c3c40, 0xa64e6c51), LEPT_U64(0x999090b6, 0x5f67d924) },	/* 1e54 */
+	{ LEPT_U64(0xd0cf4b50, 0xcfe20765), LEPT_U64(0xfff4b4e3, 0xf741cf6d) },	/* 1e55 */
+	{ LEPT_U64(0x82818f12, 0x81ed449f), LEPT_U64(0xbff8f10e, 0x7a8921a4) },	/* 1e56 */
+	{ LEPT_U64(0xa321f2d7, 0x226895c7), LEPT_U64(0xaff72d52, 0x192b6a0d) },	/* 1e57 */
+	{ LEPT_U64(0xcbea6f8c, 0xeb02bb39), LEPT_U64(0x9bf4f8a6, 0x9f764490) },	/* 1e58 */
+	{ LEPT_U64(0xfee50b70, 0x25c36a08), LEPT_U64(0x02f236d0, 0x4753d5b4) },	/* 1e59 */
+	{ LEPT_U64(0x9f4f2726, 0x179a2245), LEPT_U64(0x01d76242, 0x2c946590) },	/* 1e60 */
+	{ LEPT_U64(0xc722f0ef, 0x9d80aad6), LEPT_U64(0x424d3ad2, 0xb7b97ef5) },	/* 1e61 */
+	{ LEPT_U64(0xf8ebad2b, 0x84e0d58b), LEPT_U64(0xd2e08987, 0x65a7deb2) },	/* 1e62 */
+	{ LEPT_U64(0x9b934c3b, 0x330c8577), LEPT_U64(0x63cc55f4, 0x9f88eb2f) },	/* 1e63 */
+	{ LEPT_U64(0xc2781f49, 0xffcfa6d5), LEPT_U64(0x3cbf6b71, 0xc76b25fb) },	/* 1e64 */
+	{ LEPT_U64(0xf316271c, 0x7fc3908a), LEPT_U64(0x8bef464e, 0x3945ef7a) },	/* 1e65 */
+	{ LEPT_U64(0x97edd871, 0xcfda3a56), LEPT_U64(0x97758bf0, 0xe3cbb5ac) },	/* 1e66 */
+	{ LEPT_U64(0xbde94e8e, 0x43d0c8ec), LEPT_U64(0x3d52eeed, 0x1cbea317) },	/* 1e67 */
+	{ LEPT_U64(0xed63a231, 0xd4c4fb27), LEPT_U64(0x4ca7aaa8, 0x63ee4bdd) },	/* 1e68 */
+	{ LEPT_U64(0x945e455f, 0x24fb1cf8), LEPT_U64(0x8fe8caa9, 0x3e74ef6a) },	/* 1e69 */
+	{ LEPT_U64(0xb975d6b6, 0xee39e436), LEPT_U64(0xb3e2fd53, 0x8e122b44) },	/* 1e70 */
+	{ LEPT_U64(0xe7d34c64, 0xa9c85d44), LEPT_U64(0x60dbbca8, 0x7196b616) },	/* 1e71 */
+	{ LEPT_U64(0x90e40fbe, 0xea1d3a4a), LEPT_U64(0xbc8955e9, 0x46fe31cd) },	/* 1e72 */
+	{ LEPT_U64(0xb51d13ae, 0xa4a488dd), LEPT_U64(0x6babab63, 0x98bdbe41) },	/* 1e73 */
+	{ LEPT_U64(0xe264589a, 0x4dcdab14), LEPT_U64(0xc696963c, 0x7eed2dd1) },	/* 1e74 */
+	{ LEPT_U64(0x8d7eb760, 0x70a08aec), LEPT_U64(0xfc1e1de5, 0xcf543ca2) },	/* 1e75 */
+	{ LEPT_U64(0xb0de6538, 0x8cc8ada8), LEPT_U64(0x3b25a55f, 0x43294bcb) },	/* 1e76 */
+	{ LEPT_U64(0xdd15fe86, 0xaffad912), LEPT_U64(0x49ef0eb7, 0x13f39ebe) },	/* 1e77 */
+	{ LEPT_U64(0x8a2dbf14, 0x2dfcc7ab), LEPT_U64(0x6e356932, 0x6c784337) },	/* 1e78 */
+	{ LEPT_U64(0xacb92ed9, 0x397bf996), LEPT_U64(0x49c2c37f, 0x07965404) },	/* 1e79 */
+	{ LEPT_U64(0xd7e77a8f, 0x87daf7fb), LEPT_U64(0xdc33745e, 0xc97be906) },	/* 1e80 */
+	{ LEPT_U64(0x86f0ac99, 0xb4e8dafd), LEPT_U64(0x69a028bb, 0x3ded71a3) },	/* 1e81 */
+	{ LEPT_U64(0xa8acd7c0, 0x222311bc), LEPT_U64(0xc40832ea, 0x0d68ce0c) },	/* 1e82 */
+	{ LEPT_U64(0xd2d80db0, 0x2aabd62b), LEPT_U64(0xf50a3fa4, 0x90c30190) },	/* 1e83 */
+	{ LEPT_U64(0x83c7088e, 0x1aab65db), LEPT_U64(0x792667c6, 0xda79e0fa) },	/* 1e84 */
+	{ LEPT_U64(0xa4b8cab1, 0xa1563f52), LEPT_U64(0x577001b8, 0x91185938) },	/* 1e85 */
+	{ LEPT_U64(0xcde6fd5e, 0x09abcf26), LEPT_U64(0xed4c0226, 0xb55e6f86) },	/* 1e86 */
+	{ LEPT_U64(0x80b05e5a, 0xc60b6178), LEPT_U64(0x544f8158, 0x315b05b4) },	/* 1e87 */
+	{ LEPT_U64(0xa0dc75f1, 0x778e39d6), LEPT_U64(0x696361ae, 0x3db1c721) },	/* 1e88 */
+	{ LEPT_U64(0xc913936d, 0xd571c84c), LEPT_U64(0x03bc3a19, 0xcd1e38e9) },	/* 1e89 */
+	{ LEPT_U64(0xfb587849, 0x4ace3a5f), LEPT_U64(0x04ab48a0, 0x4065c723) },	/* 1e90 */
+	{ LEPT_U64(0x9d174b2d, 0xcec0e47b), LEPT_U64(0x62eb0d64, 0x283f9c76) },	/* 1e91 */
+	{ LEPT_U64(0xc45d1df9, 0x42711d9a), LEPT_U64(0x3ba5d0bd, 0x324f8394) },	/* 1e92 */
+	{ LEPT_U64(0xf5746577, 0x930d6500), LEPT_U64(0xca8f44ec, 0x7ee36479) },	/* 1e93 */
+	{ LEPT_U64(0x9968bf6a, 0xbbe85f20), LEPT_U64(0x7e998b13, 0xcf4e1ecb) },	/* 1e94 */
+	{ LEPT_U64(0xbfc2ef45, 0x6ae276e8), LEPT_U64(0x9e3fedd8, 0xc321a67e) },	/* 1e95 */
+	{ LEPT_U64(0xefb3ab16, 0xc59b14a2), LEPT_U64(0xc5cfe94e, 0xf3ea101e) },	/* 1e96 */
+	{ LEPT_U64(0x95d04aee, 0x3b80ece5), LEPT_U64(0xbba1f1d1, 0x58724a12) },	/* 1e97 */
+	{ LEPT_U64(0xbb445da9, 0xca61281f), LEPT_U64(0x2a8a6e45, 0xae8edc97) },	/* 1e98 */
+	{ LEPT_U64(0xea157514, 0x3cf97226), LEPT_U64(0xf52d09d7, 0x1a3293bd) },	/* 1e99 */
+	{ LEPT_U64(0x924d692c, 0xa61be758), LEPT_U64(0x593c2626, 0x705f9c56) },	/* 1e100 */
+	{ LEPT_U64(0xb6e0c377, 0xcfa2e12e), LEPT_U64(0x6f8b2fb0, 0x0c77836c) },	/* 1e101 */
+	{ LEPT_U64(0xe498f455, 0xc38b997a), LEPT_U64(0x0b6dfb9c, 0x0f956447) },	/* 1e102 */
+	{ LEPT_U64(0x8edf98b5, 0x9a373fec), LEPT_U64(0x4724bd41, 0x89bd5eac) },	/* 1e103 */
+	{ LEPT_U64(0xb2977ee3, 0x00c50fe7), LEPT_U64(0x58edec91, 0xec2cb657) },	/* 1e104 */
+	{ LEPT_U64(0xdf3d5e9b, 0xc0f653e1), LEPT_U64(0x2f2967b6, 0x6737e3ed) },	/* 1e105 */
+	{ LEPT_U64(0x8b865b21, 0x5899f46c), LEPT_U64(0xbd79e0d2, 0x0082ee74) },	/* 1e106 */
+	{ LEPT_U64(0xae67f1e9, 0xaec07187), LEPT_U64(0xecd85906, 0x80a3aa11) },	/* 1e107 */
+	{ LEPT_U64(0xda01ee64, 0x1a708de9), LEPT_U64(0xe80e6f48, 0x20cc9495) },	/* 1e108 */
+	{ LEPT_U64(0x884134fe, 0x908658b2), LEPT_U64(0x3109058d, 0x147fdcdd) },	/* 1e109 */
+	{ LEPT_U64(0xaa51823e, 0x34a7eede), LEPT_U64(0xbd4b46f0, 0x599fd415) },	/* 1e110 */
+	{ LEPT_U64(0xd4e5e2cd, 0xc1d1ea96), LEPT_U64(0x6c9e18ac, 0x7007c91a) },	/* 1e111 */
+	{ LEPT_U64(0x850fadc0, 0x9923329e), LEPT_U64(0x03e2cf6b, 0xc604ddb0) },	/* 1e112 */
+	{ LEPT_U64(0xa6539930, 0xbf6bff45), LEPT_U64(0x84db8346, 0xb786151c) },	/* 1e113 */
+	{ LEPT_U64(0xcfe87f7c, 0xef46ff16), LEPT_U64(0xe6126418, 0x65679a63) },	/* 1e114 */
+	{ LEPT_U64(0x81f14fae, 0x158c5f6e), LEPT_U64(0x4fcb7e8f, 0x3f60c07e) },	/* 1e115 */
+	{ LEPT_U64(0xa26da399, 0x9aef7749), LEPT_U64(0xe3be5e33, 0x0f38f09d) },	/* 1e116 */
+	{ LEPT_U64(0xcb090c80, 0x01ab551c), LEPT_U64(0x5cadf5bf, 0xd3072cc5) },	/* 1e117 */
+	{ LEPT_U64(0xfdcb4fa0, 0x02162a63), LEPT_U64(0x73d9732f, 0xc7c8f7f6) },	/* 1e118 */
+	{ LEPT_U64(0x9e9f11c4, 0x014dda7e), LEPT_U64(0x2867e7fd, 0xdcdd9afa) },	/* 1e119 */
+	{ LEPT_U64(0xc646d635, 0x01a1511d), LEPT_U64(0xb281e1fd, 0x541501b8) },	/* 1e120 */
+	{ LEPT_U64(0xf7d88bc2, 0x4209a565), LEPT_U64(0x1f225a7c, 0xa91a4226) },	/* 1e121 */
+	{ LEPT_U64(0x9ae75759, 0x6946075f), LEPT_U64(0x3375788d, 0xe9b06958) },	/* 1e122 */
+	{ LEPT_U64(0xc1a12d2f, 0xc3978937), LEPT_U64(0x0052d6b1, 0x641c83ae) },	/* 1e123 */
+	{ LEPT_U64(0xf209787b, 0xb47d6b84), LEPT_U64(0xc0678c5d, 0xbd23a49a) },	/* 1e124 */
+	{ LEPT_U64(0x9745eb4d, 0x50ce6332), LEPT_U64(0xf840b7ba, 0x963646e0) },	/* 1e125 */
+	{ LEPT_U64(0xbd176620, 0xa501fbff), LEPT_U64(0xb650e5a9, 0x3bc3d898) },	/* 1e126 */
+	{ LEPT_U64(0xec5d3fa8, 0xce427aff), LEPT_U64(0xa3e51f13, 0x8ab4cebe) },	/* 1e127 */
+	{ LEPT_U64(0x93ba47c9, 0x80e98cdf), LEPT_U64(0xc66f336c, 0x36b10137) },	/* 1e128 */
+	{ LEPT_U64(0xb8a8d9bb, 0xe123f017), LEPT_U64(0xb80b0047, 0x445d4184) },	/* 1e129 */
+	{ LEPT_U64(0xe6d3102a, 0xd96cec1d), LEPT_U64(0xa60dc059, 0x157491e5) },	/* 1e130 */
+	{ LEPT_U64(0x9043ea1a, 0xc7e41392), LEPT_U64(0x87c89837, 0xad68db2f) },	/* 1e131 */
+	{ LEPT_U64(0xb454e4a1, 0x79dd1877), LEPT_U64(0x29babe45, 0x98c311fb) },	/* 1e132 */
+	{ LEPT_U64(0xe16a1dc9, 0xd8545e94), LEPT_U64(0xf4296dd6, 0xfef3d67a) },	/* 1e133 */
+	{ LEPT_U64(0x8ce2529e, 0x2734bb1d), LEPT_U64(0x1899e4a6, 0x5f58660c) },	/* 1e134 */
+	{ LEPT_U64(0xb01ae745, 0xb101e9e4), LEPT_U64(0x5ec05dcf, 0xf72e7f8f) },	/* 1e135 */
+	{ LEPT_U64(0xdc21a117, 0x1d42645d), LEPT_U64(0x76707543, 0xf4fa1f73) },	/* 1e136 */
+	{ LEPT_U64(0x899504ae, 0x72497eba), LEPT_U64(0x6a06494a, 0x791c53a8) },	/* 1e137 */
+	{ LEPT_U64(0xabfa45da, 0x0edbde69), LEPT_U64(0x0487db9d, 0x17636892) },	/* 1e138 */
+	{ LEPT_U64(0xd6f8d750, 0x9292d603), LEPT_U64(0x45a9d284, 0x5d3c42b6) },	/* 1e139 */
+	{ LEPT_U64(0x865b8692, 0x5b9bc5c2), LEPT_U64(0x0b8a2392, 0xba45a9b2) },	/* 1e140 */
+	{ LEPT_U64(0xa7f26836, 0xf282b732), LEPT_U64(0x8e6cac77, 0x68d7141e) },	/* 1e141 */
+	{ LEPT_U64(0xd1ef0244, 0xaf2364ff), LEPT_U64(0x3207d795, 0x430cd926) },	/* 1e142 */
+	{ LEPT_U64(0x8335616a, 0xed761f1f), LEPT_U64(0x7f44e6bd, 0x49e807b8) },	/* 1e143 */
+	{ LEPT_U64(0xa402b9c5, 0xa8d3a6e7), LEPT_U64(0x5f16206c, 0x9c6209a6) },	/* 1e144 */
+	{ LEPT_U64(0xcd036837, 0x130890a1), LEPT_U64(0x36dba887, 0xc37a8c0f) },	/* 1e145 */
+	{ LEPT_U64(0x80222122, 0x6be55a64), LEPT_U64(0xc2494954, 0xda2c9789) },	/* 1e146 */
+	{ LEPT_U64(0xa02aa96b, 0x06deb0fd), LEPT_U64(0xf2db9baa, 0x10b7bd6c) },	/* 1e147 */
+	{ LEPT_U64(0xc83553c5, 0xc8965d3d), LEPT_U64(0x6f928294, 0x94e5acc7) },	/* 1e148 */
+	{ LEPT_U64(0xfa42a8b7, 0x3abbf48c), LEPT_U64(0xcb772339, 0xba1f17f9) },	/* 1e149 */
+	{ LEPT_U64(0x9c69a972, 0x84b578d7), LEPT_U64(0xff2a7604, 0x14536efb) },	/* 1e150 */
+	{ LEPT_U64(0xc38413cf, 0x25e2d70d), LEPT_U64(0xfef51385, 0x19684aba) },	/* 1e151 */
+	{ LEPT_U64(0xf46518c2, 0xef5b8cd1), LEPT_U64(0x7eb25866, 0x5fc25d69) },	/* 1e152 */
+	{ LEPT_U64(0x98bf2f79, 0xd5993802), LEPT_U64(0xef2f773f, 0xfbd97a61) },	/* 1e153 */
+	{ LEPT_U64(0xbeeefb58, 0x4aff8603), LEPT_U64(0xaafb550f, 0xfacfd8fa) },	/* 1e154 */
+	{ LEPT_U64(0xeeaaba2e, 0x5dbf6784), LEPT_U64(0x95ba2a53, 0xf983cf38) },	/* 1e155 */
+	{ LEPT_U64(0x952ab45c, 0xfa97a0b2), LEPT_U64(0xdd945a74, 0x7bf26183) },	/* 1e156 */
+	{ LEPT_U64(0xba756174, 0x393d88df), LEPT_U64(0x94f97111, 0x9aeef9e4) },	/* 1e157 */
+	{ LEPT_U64(0xe912b9d1, 0x478ceb17), LEPT_U64(0x7a37cd56, 0x01aab85d) },	/* 1e158 */
+	{ LEPT_U64(0x91abb422, 0xccb812ee), LEPT_U64(0xac62e055, 0xc10ab33a) },	/* 1e159 */
+	{ LEPT_U64(0xb616a12b, 0x7fe617aa), LEPT_U64(0x577b986b, 0x314d6009) },	/* 1e160 */
+	{ LEPT_U64(0xe39c4976, 0x5fdf9d94), LEPT_U64(0xed5a7e85, 0xfda0b80b) },	/* 1e161 */
+	{ LEPT_U64(0x8e41ade9, 0xfbebc27d), LEPT_U64(0x14588f13, 0xbe847307) },	/* 1e162 */
+	{ LEPT_U64(0xb1d21964, 0x7ae6b31c), LEPT_U64(0x596eb2d8, 0xae258fc8) },	/* 1e163 */
+	{ LEPT_U64(0xde469fbd, 0x99a05fe3), LEPT_U64(0x6fca5f8e, 0xd9aef3bb) },	/* 1e164 */
+	{ LEPT_U64(0x8aec23d6, 0x80043bee), LEPT_U64(0x25de7bb9, 0x480d5854) },	/* 1e165 */
+	{ LEPT_U64(0xada72ccc, 0x20054ae9), LEPT_U64(0xaf561aa7, 0x9a10ae6a) },	/* 1e166 */
+	{ LEPT_U64(0xd910f7ff, 0x28069da4), LEPT_U64(0x1b2ba151, 0x8094da04) },	/* 1e167 */
+	{ LEPT_U64(0x87aa9aff, 0x79042286), LEPT_U64(0x90fb44d2, 0xf05d0842) },	/* 1e168 */
+	{ LEPT_U64(0xa99541bf, 0x57452b28), LEPT_U64(0x353a1607, 0xac744a53) },	/* 1e169 */
+	{ LEPT_U64(0xd3fa922f, 0x2d1675f2), LEPT_U64(0x42889b89, 0x97915ce8) },	/* 1e170 */
+	{ LEPT_U64(0x847c9b5d, 0x7c2e09b7), LEPT_U64(0x69956135, 0xfebada11) },	/* 1e171 */
+	{ LEPT_U64(0xa59bc234, 0xdb398c25), LEPT_U64(0x43fab983, 0x7e699095) },	/* 1e172 */
+	{ LEPT_U64(0xcf02b2c2, 0x1207ef2e), LEPT_U64(0x94f967e4, 0x5e03f4bb) },	/* 1e173 */
+	{ LEPT_U64(0x8161afb9, 0x4b44f57d), LEPT_U64(0x1d1be0ee, 0xbac278f5) },	/* 1e174 */
+	{ LEPT_U64(0xa1ba1ba7, 0x9e1632dc), LEPT_U64(0x6462d92a, 0x69731732) },	/* 1e175 */
+	{ LEPT_U64(0xca28a291, 0x859bbf93), LEPT_U64(0x7d7b8f75, 0x03cfdcfe) },	/* 1e176 */
+	{ LEPT_U64(0xfcb2cb35, 0xe702af78), LEPT_U64(0x5cda7352, 0x44c3d43e) },	/* 1e177 */
+	{ LEPT_U64(0x9defbf01, 0xb061adab), LEPT_U64(0x3a088813, 0x6afa64a7) },	/* 1e178 */
+	{ LEPT_U64(0xc56baec2, 0x1c7a1916), LEPT_U64(0x088aaa18, 0x45b8fdd0) },	/* 1e179 */
+	{ LEPT_U64(0xf6c69a72, 0xa3989f5b), LEPT_U64(0x8aad549e, 0x57273d45) },	/* 1e180 */
+	{ LEPT_U64(0x9a3c2087, 0xa63f6399), LEPT_U64(0x36ac54e2, 0xf678864b) },	/* 1e181 */
+	{ LEPT_U64(0xc0cb28a9, 0x8fcf3c7f), LEPT_U64(0x84576a1b, 0xb416a7dd) },	/* 1e182 */
+	{ LEPT_U64(0xf0fdf2d3, 0xf3c30b9f), LEPT_U64(0x656d44a2, 0xa11c51d5) },	/* 1e183 */
+	{ LEPT_U64(0x969eb7c4, 0x7859e743), LEPT_U64(0x9f644ae5, 0xa4b1b325) },	/* 1e184 */
+	{ LEPT_U64(0xbc4665b5, 0x96706114), LEPT_U64(0x873d5d9f, 0x0dde1fee) },	/* 1e185 */
+	{ LEPT_U64(0xeb57ff22, 0xfc0c7959), LEPT_U64(0xa90cb506, 0xd155a7ea) },	/* 1e186 */
+	{ LEPT_U64(0x9316ff75, 0xdd87cbd8), LEPT_U64(0x09a7f124, 0x42d588f2) },	/* 1e187 */
+	{ LEPT_U64(0xb7dcbf53, 0x54e9bece), LEPT_U64(0x0c11ed6d, 0x538aeb2f) },	/* 1e188 */
+	{ LEPT_U64(0xe5d3ef28, 0x2a242e81), LEPT_U64(0x8f1668c8, 0xa86da5fa) },	/* 1e189 */
+	{ LEPT_U64(0x8fa47579, 0x1a569d10), LEPT_U64(0xf96e017d, 0x694487bc) },	/* 1e190 */
+	{ LEPT_U64(0xb38d92d7, 0x60ec4455), LEPT_U64(0x37c981dc, 0xc395a9ac) },	/* 1e191 */
+	{ LEPT_U64(0xe070f78d, 0x3927556a), LEPT_U64(0x85bbe253, 0xf47b1417) },	/* 1e192 */
+	{ LEPT_U64(0x8c469ab8, 0x43b89562), LEPT_U64(0x93956d74, 0x78ccec8e) },	/* 1e193 */
+	{ LEPT_U64(0xaf584166, 0x54a6babb), LEPT_U64(0x387ac8d1, 0x970027b2) },	/* 1e194 */
+	{ LEPT_U64(0xdb2e51bf, 0xe9d0696a), LEPT_U64(0x06997b05, 0xfcc0319e) },	/* 1e195 */
+	{ LEPT_U64(0x88fcf317, 0xf22241e2), LEPT_U64(0x441fece3, 0xbdf81f03) },	/* 1e196 */
+	{ LEPT_U64(0xab3c2fdd, 0xeeaad25a), LEPT_U64(0xd527e81c, 0xad7626c3) },	/* 1e197 */
+	{ LEPT_U64(0xd60b3bd5, 0x6a5586f1), LEPT_U64(0x8a71e223, 0xd8d3b074) },	/* 1e198 */
+	{ LEPT_U64(0x85c70565, 0x62757456), LEPT_U64(0xf6872d56, 0x67844e49) },	/* 1e199 */
+	{ LEPT_U64(0xa738c6be, 0xbb12d16c), LEPT_U64(0xb428f8ac, 0x016561db) },	/* 1e200 */
+	{ LEPT_U64(0xd106f86e, 0x69d785c7), LEPT_U64(0xe13336d7, 0x01beba52) },	/* 1e201 */
+	{ LEPT_U64(0x82a45b45, 0x0226b39c), LEPT_U64(0xecc00246, 0x61173473) },	/* 1e202 */
+	{ LEPT_U64(0xa34d7216, 0x42b06084), LEPT_U64(0x27f002d7, 0xf95d0190) },	/* 1e203 */
+	{ LEPT_U64(0xcc20ce9b, 0xd35c78a5), LEPT_U64(0x31ec038d, 0xf7b441f4) },	/* 1e204 */
+	{ LEPT_U64(0xff290242, 0xc83396ce), LEPT_U64(0x7e670471, 0x75a15271) },	/* 1e205 */
+	{ LEPT_U64(0x9f79a169, 0xbd203e41), LEPT_U64(0x0f0062c6, 0xe984d386) },	/* 1e206 */
+	{ LEPT_U64(0xc75809c4, 0x2c684dd1), LEPT_U64(0x52c07b78, 0xa3e60868) },	/* 1e207 */
+	{ LEPT_U64(0xf92e0c35, 0x37826145), LEPT_U64(0xa7709a56, 0xccdf8a82) },	/* 1e208 */
+	{ LEPT_U64(0x9bbcc7a1, 0x42b17ccb), LEPT_U64(0x88a66076, 0x400bb691) },	/* 1e209 */
+	{ LEPT_U64(0xc2abf989, 0x935ddbfe), LEPT_U64(0x6acff893, 0xd00ea435) },	/* 1e210 */
+	{ LEPT_U64(0xf356f7eb, 0xf83552fe), LEPT_U64(0x0583f6b8, 0xc4124d43) },	/* 1e211 */
+	{ LEPT_U64(0x98165af3, 0x7b2153de), LEPT_U64(0xc3727a33, 0x7a8b704a) },	/* 1e212 */
+	{ LEPT_U64(0xbe1bf1b0, 0x59e9a8d6), LEPT_U64(0x744f18c0, 0x592e4c5c) },	/* 1e213 */
+	{ LEPT_U64(0xeda2ee1c, 0x7064130c), LEPT_U64(0x1162def0, 0x6f79df73) },	/* 1e214 */
+	{ LEPT_U64(0x9485d4d1, 0xc63e8be7), LEPT_U64(0x8addcb56, 0x45ac2ba8) },	/* 1e215 */
+	{ LEPT_U64(0xb9a74a06, 0x37ce2ee1), LEPT_U64(0x6d953e2b, 0xd7173692) },	/* 1e216 */
+	{ LEPT_U64(0xe8111c87, 0xc5c1ba99), LEPT_U64(0xc8fa8db6, 0xccdd0437) },	/* 1e217 */
+	{ LEPT_U64(0x910ab1d4, 0xdb9914a0), LEPT_U64(0x1d9c9892, 0x400a22a2) },	/* 1e218 */
+	{ LEPT_U64(0xb54d5e4a, 0x127f59c8), LEPT_U64(0x2503beb6, 0xd00cab4b) },	/* 1e219 */
+	{ LEPT_U64(0xe2a0b5dc, 0x971f303a), LEPT_U64(0x2e44ae64, 0x840fd61d) },	/* 1e220 */
+	{ LEPT_U64(0x8da471a9, 0xde737e24), LEPT_U64(0x5ceaecfe, 0xd289e5d2) },	/* 1e221 */
+	{ LEPT_U64(0xb10d8e14, 0x56105dad), LEPT_U64(0x7425a83e, 0x872c5f47) },	/* 1e222 */
+	{ LEPT_U64(0xdd50f199, 0x6b947518), LEPT_U64(0xd12f124e, 0x28f77719) },	/* 1e223 */
+	{ LEPT_U64(0x8a5296ff, 0xe33cc92f), LEPT_U64(0x82bd6b70, 0xd99aaa6f) },	/* 1e224 */
+	{ LEPT_U64(0xace73cbf, 0xdc0bfb7b), LEPT_U64(0x636cc64d, 0x1001550b) },	/* 1e225 */
+	{ LEPT_U64(0xd8210bef, 0xd30efa5a), LEPT_U64(0x3c47f7e0, 0x5401aa4e) },	/* 1e226 */
+	{ LEPT_U64(0x8714a775, 0xe3e95c78), LEPT_U64(0x65acfaec, 0x34810a71) },	/* 1e227 */
+	{ LEPT_U64(0xa8d9d153, 0x5ce3b396), LEPT_U64(0x7f1839a7, 0x41a14d0d) },	/* 1e228 */
+	{ LEPT_U64(0xd31045a8, 0x341ca07c), LEPT_U64(0x1ede4811, 0x1209a050) },	/* 1e229 */
+	{ LEPT_U64(0x83ea2b89, 0x2091e44d), LEPT_U64(0x934aed0a, 0xab460432) },	/* 1e230 */
+	{ LEPT_U64(0xa4e4b66b, 0x68b65d60), LEPT_U64(0xf81da84d, 0x5617853f) },	/* 1e231 */
+	{ LEPT_U64(0xce1de406, 0x42e3f4b9), LEPT_U64(0x36251260, 0xab9d668e) },	/* 1e232 */
+	{ LEPT_U64(0x80d2ae83, 0xe9ce78f3), LEPT_U64(0xc1d72b7c, 0x6b426019) },	/* 1e233 */
+	{ LEPT_U64(0xa1075a24, 0xe4421730), LEPT_U64(0xb24cf65b, 0x8612f81f) },	/* 1e234 */
+	{ LEPT_U64(0xc94930ae, 0x1d529cfc), LEPT_U64(0xdee033f2, 0x6797b627) },	/* 1e235 */
+	{ LEPT_U64(0xfb9b7cd9, 0xa4a7443c), LEPT_U64(0x169840ef, 0x017da3b1) },	/* 1e236 */
+	{ LEPT_U64(0x9d412e08, 0x06e88aa5), LEPT_U64(0x8e1f2895, 0x60ee864e) },	/* 1e237 */
+	{ LEPT_U64(0xc491798a, 0x08a2ad4e), LEPT_U64(0xf1a6f2ba, 0xb92a27e2) },	/* 1e238 */
+	{ LEPT_U64(0xf5b5d7ec, 0x8acb58a2), LEPT_U64(0xae10af69, 0x6774b1db) },	/* 1e239 */
+	{ LEPT_U64(0x9991a6f3, 0xd6bf1765), LEPT_U64(0xacca6da1, 0xe0a8ef29) },	/* 1e240 */
+	{ LEPT_U64(0xbff610b0, 0xcc6edd3f), LEPT_U64(0x17fd090a, 0x58d32af3) },	/* 1e241 */
+	{ LEPT_U64(0xeff394dc, 0xff8a948e), LEPT_U64(0xddfc4b4c, 0xef07f5b0) },	/* 1e242 */
+	{ LEPT_U64(0x95f83d0a, 0x1fb69cd9), LEPT_U64(0x4abdaf10, 0x1564f98e) },	/* 1e243 */
+	{ LEPT_U64(0xbb764c4c, 0xa7a4440f), LEPT_U64(0x9d6d1ad4, 0x1abe37f1) },	/* 1e244 */
+	{ LEPT_U64(0xea53df5f, 0xd18d5513), LEPT_U64(0x84c86189, 0x216dc5ed) },	/* 1e245 */
+	{ LEPT_U64(0x92746b9b, 0xe2f8552c), LEPT_U64(0x32fd3cf5, 0xb4e49bb4) },	/* 1e246 */
+	{ LEPT_U64(0xb7118682, 0xdbb66a77), LEPT_U64(0x3fbc8c33, 0x221dc2a1) },	/* 1e247 */
+	{ LEPT_U64(0xe4d5e823, 0x92a40515), LEPT_U64(0x0fabaf3f, 0xeaa5334a) },	/* 1e248 */
+	{ LEPT_U64(0x8f05b116, 0x3ba6832d), LEPT_U64(0x29cb4d87, 0xf2a7400e) },	/* 1e249 */
+	{ LEPT_U64(0xb2c71d5b, 0xca9023f8), LEPT_U64(0x743e20e9, 0xef511012) },	/* 1e250 */
+	{ LEPT_U64(0xdf78e4b2, 0xbd342cf6), LEPT_U64(0x914da924, 0x6b255416) },	/* 1e251 */
+	{ LEPT_U64(0x8bab8eef, 0xb6409c1a), LEPT_U64(0x1ad089b6, 0xc2f7548e) },	/* 1e252 */
+	{ LEPT_U64(0xae9672ab, 0xa3d0c320), LEPT_U64(0xa184ac24, 0x73b529b1) },	/* 1e253 */
+	{ LEPT_U64(0xda3c0f56, 0x8cc4f3e8), LEPT_U64(0xc9e5d72d, 0x90a2741e) },	/* 1e254 */
+	{ LEPT_U64(0x88658996, 0x17fb1871), LEPT_U64(0x7e2fa67c, 0x7a658892) },	/* 1e255 */
+	{ LEPT_U64(0xaa7eebfb, 0x9df9de8d), LEPT_U64(0xddbb901b, 0x98feeab7) },	/* 1e256 */
+	{ LEPT_U64(0xd51ea6fa, 0x85785631), LEPT_U64(0x552a7422, 0x7f3ea565) },	/* 1e257 */
+	{ LEPT_U64(0x8533285c, 0x936b35de), LEPT_U64(0xd53a8895, 0x8f87275f) },	/* 1e258 */
+	{ LEPT_U64(0xa67ff273, 0xb8460356), LEPT_U64(0x8a892aba, 0xf368f137) },	/* 1e259 */
+	{ LEPT_U64(0xd01fef10, 0xa657842c), LEPT_U64(0x2d2b7569, 0xb0432d85) },	/* 1e260 */
+	{ LEPT_U64(0x8213f56a, 0x67f6b29b), LEPT_U64(0x9c3b2962, 0x0e29fc73) },	/* 1e261 */
+	{ LEPT_U64(0xa298f2c5, 0x01f45f42), LEPT_U64(0x8349f3ba, 0x91b47b8f) },	/* 1e262 */
+	{ LEPT_U64(0xcb3f2f76, 0x42717713), LEPT_U64(0x241c70a9, 0x36219a73) },	/* 1e263 */
+	{ LEPT_U64(0xfe0efb53, 0xd30dd4d7), LEPT_U64(0xed238cd3, 0x83aa0110) },	/* 1e264 */
+	{ LEPT_U64(0x9ec95d14, 0x63e8a506), LEPT_U64(0xf4363804, 0x324a40aa) },	/* 1e265 */
+	{ LEPT_U64(0xc67bb459, 0x7ce2ce48), LEPT_U64(0xb143c605, 0x3edcd0d5) },	/* 1e266 */
+	{ LEPT_U64(0xf81aa16f, 0xdc1b81da), LEPT_U64(0xdd94b786, 0x8e94050a) },	/* 1e267 */
+	{ LEPT_U64(0x9b10a4e5, 0xe9913128), LEPT_U64(0xca7cf2b4, 0x191c8326) },	/* 1e268 */
+	{ LEPT_U64(0xc1d4ce1f, 0x63f57d72), LEPT_U64(0xfd1c2f61, 0x1f63a3f0) },	/* 1e269 */
+	{ LEPT_U64(0xf24a01a7, 0x3cf2dccf), LEPT_U64(0xbc633b39, 0x673c8cec) },	/* 1e270 */
+	{ LEPT_U64(0x976e4108, 0x8617ca01), LEPT_U64(0xd5be0503, 0xe085d813) },	/* 1e271 */
+	{ LEPT_U64(0xbd49d14a, 0xa79dbc82), LEPT_U64(0x4b2d8644, 0xd8a74e18) },	/* 1e272 */
+	{ LEPT_U64(0xec9c459d, 0x51852ba2), LEPT_U64(0xddf8e7d6, 0x0ed1219e) },	/* 1e273 */
+	{ LEPT_U64(0x93e1ab82, 0x52f33b45), LEPT_U64(0xcabb90e5, 0xc942b503) },	/* 1e274 */
+	{ LEPT_U64(0xb8da1662, 0xe7b00a17), LEPT_U64(0x3d6a751f, 0x3b936243) },	/* 1e275 */
+	{ LEPT_U64(0xe7109bfb, 0xa19c0c9d), LEPT_U64(0x0cc51267, 0x0a783ad4) },	/* 1e276 */
+	{ LEPT_U64(0x906a617d, 0x450187e2), LEPT_U64(0x27fb2b80, 0x668b24c5) },	/* 1e277 */
+	{ LEPT_U64(0xb484f9dc, 0x9641e9da), LEPT_U64(0xb1f9f660, 0x802dedf6) },	/* 1e278 */
+	{ LEPT_U64(0xe1a63853, 0xbbd26451), LEPT_U64(0x5e7873f8, 0xa0396973) },	/* 1e279 */
+	{ LEPT_U64(0x8d07e334, 0x55637eb2), LEPT_U64(0xdb0b487b, 0x6423e1e8) },	/* 1e280 */
+	{ LEPT_U64(0xb049dc01, 0x6abc5e5f), LEPT_U64(0x91ce1a9a, 0x3d2cda62) },	/* 1e281 */
+	{ LEPT_U64(0xdc5c5301, 0xc56b75f7), LEPT_U64(0x7641a140, 0xcc7810fb) },	/* 1e282 */
+	{ LEPT_U64(0x89b9b3e1, 0x1b6329ba), LEPT_U64(0xa9e904c8, 0x7fcb0a9d) },	/* 1e283 */
+	{ LEPT_U64(0xac2820d9, 0x623bf429), LEPT_U64(0x546345fa, 0x9fbdcd44) },	/* 1e284 */
+	{ LEPT_U64(0xd732290f, 0xbacaf133), LEPT_U64(0xa97c1779, 0x47ad4095) },	/* 1e285 */
+	{ LEPT_U64(0x867f59a9, 0xd4bed6c0), LEPT_U64(0x49ed8eab, 0xcccc485d) },	/* 1e286 */
+	{ LEPT_U64(0xa81f3014, 0x49ee8c70), LEPT_U64(0x5c68f256, 0xbfff5a74) },	/* 1e287 */
+	{ LEPT_U64(0xd226fc19, 0x5c6a2f8c), LEPT_U64(0x73832eec, 0x6fff3111) },	/* 1e288 */
+	{ LEPT_U64(0x83585d8f, 0xd9c25db7), LEPT_U64(0xc831fd53, 0xc5ff7eab) },	/* 1e289 */
+	{ LEPT_U64(0xa42e74f3, 0xd032f525), LEPT_U64(0xba3e7ca8, 0xb77f5e55) },	/* 1e290 */
+	{ LEPT_U64(0xcd3a1230, 0xc43fb26f), LEPT_U64(0x28ce1bd2, 0xe55f35eb) },	/* 1e291 */
+	{ LEPT_U64(0x80444b5e, 0x7aa7cf85), LEPT_U64(0x7980d163, 0xcf5b81b3) },	/* 1e292 */
+	{ LEPT_U64(0xa0555e36, 0x1951c366), LEPT_U64(0xd7e105bc, 0xc332621f) },	/* 1e293 */
+	{ LEPT_U64(0xc86ab5c3, 0x9fa63440), LEPT_U64(0x8dd9472b, 0xf3fefaa7) },	/* 1e294 */
+	{ LEPT_U64(0xfa856334, 0x878fc150), LEPT_U64(0xb14f98f6, 0xf0feb951) },	/* 1e295 */
+	{ LEPT_U64(0x9c935e00, 0xd4b9d8d2), LEPT_U64(0x6ed1bf9a, 0x569f33d3) },	/* 1e296 */
+	{ LEPT_U64(0xc3b83581, 0x09e84f07), LEPT_U64(0x0a862f80, 0xec4700c8) },	/* 1e297 */
+	{ LEPT_U64(0xf4a642e1, 0x4c6262c8), LEPT_U64(0xcd27bb61, 0x2758c0fa) },	/* 1e298 */
+	{ LEPT_U64(0x98e7e9cc, 0xcfbd7dbd), LEPT_U64(0x8038d51c, 0xb897789c) },	/* 1e299 */
+	{ LEPT_U64(0xbf21e440, 0x03acdd2c), LEPT_U64(0xe0470a63, 0xe6bd56c3) },	/* 1e300 */
+	{ LEPT_U64(0xeeea5d50, 0x04981478), LEPT_U64(0x1858ccfc, 0xe06cac74) },	/* 1e301 */
+	{ LEPT_U64(0x95527a52, 0x02df0ccb), LEPT_U64(0x0f37801e, 0x0c43ebc8) },	/* 1e302 */
+	{ LEPT_U64(0xbaa718e6, 0x8396cffd), LEPT_U64(0xd3056025, 0x8f54e6ba) },	/* 1e303 */
+	{ LEPT_U64(0xe950df20, 0x247c83fd), LEPT_U64(0x47c6b82e, 0xf32a2069) },	/* 1e304 */
+	{ LEPT_U64(0x91d28b74, 0x16cdd27e), LEPT_U64(0x4cdc331d, 0x57fa5441) },	/* 1e305 */
+	{ LEPT_U64(0xb6472e51, 0x1c81471d), LEPT_U64(0xe0133fe4, 0xadf8e952) },	/* 1e306 */
+	{ LEPT_U64(0xe3d8f9e5, 0x63a198e5), LEPT_U64(0x58180fdd, 0xd97723a6) },	/* 1e307 */
+	{ LEPT_U64(0x8e679c2f, 0x5e44ff8f), LEPT_U64(0x570f09ea, 0xa7ea7648) },	/* 1e308 */
+	{ LEPT_U64(0xb201833b, 0x35d63f73), LEPT_U64(0x2cd2cc65, 0x51e513da) },	/* 1e309 */
+	{ LEPT_U64(0xde81e40a, 0x034bcf4f), LEPT_U64(0xf8077f7e, 0xa65e58d1) },	/* 1e310 */
+	{ LEPT_U64(0x8b112e86, 0x420f6191), LEPT_U64(0xfb04afaf, 0x27faf782) },	/* 1e311 */
+	{ LEPT_U64(0xadd57a27, 0xd29339f6), LEPT_U64(0x79c5db9a, 0xf1f9b563) },	/* 1e312 */
+	{ LEPT_U64(0xd94ad8b1, 0xc7380874), LEPT_U64(0x18375281, 0xae7822bc) },	/* 1e313 */
+	{ LEPT_U64(0x87cec76f, 0x1c830548), LEPT_U64(0x8f229391, 0x0d0b15b5) },	/* 1e314 */
+	{ LEPT_U64(0xa9c2794a, 0xe3a3c69a), LEPT_U64(0xb2eb3875, 0x504ddb22) },	/* 1e315 */
+	{ LEPT_U64(0xd433179d, 0x9c8cb841), LEPT_U64(0x5fa60692, 0xa46151eb) },	/* 1e316 */
+	{ LEPT_U64(0x849feec2, 0x81d7f328), LEPT_U64(0xdbc7c41b, 0xa6bcd333) },	/* 1e317 */
+	{ LEPT_U64(0xa5c7ea73, 0x224deff3), LEPT_U64(0x12b9b522, 0x906c0800) },	/* 1e318 */
+	{ LEPT_U64(0xcf39e50f, 0xeae16bef), LEPT_U64(0xd768226b, 0x34870a00) },	/* 1e319 */
+	{ LEPT_U64(0x81842f29, 0xf2cce375), LEPT_U64(0xe6a11583, 0x00d46640) },	/* 1e320 */
+	{ LEPT_U64(0xa1e53af4, 0x6f801c53), LEPT_U64(0x60495ae3, 0xc1097fd0) },	/* 1e321 */
+	{ LEPT_U64(0xca5e89b1, 0x8b602368), LEPT_U64(0x385bb19c, 0xb14bdfc4) },	/* 1e322 */
+	{ LEPT_U64(0xfcf62c1d, 0xee382c42), LEPT_U64(0x46729e03, 0xdd9ed7b5) },	/* 1e323 */
+	{ LEPT_U64(0x9e19db92, 0xb4e31ba9), LEPT_U64(0x6c07a2c2, 0x6a8346d1) },	/* 1e324 */
+	{ LEPT_U64(0xc5a05277, 0x621be293), LEPT_U64(0xc7098b73, 0x05241885) },	/* 1e325 */
+	{ LEPT_U64(0xf7086715, 0x3aa2db38), LEPT_U64(0xb8cbee4f, 0xc66d1ea7) },	/* 1e326 */
+	{ LEPT_U64(0x9a65406d, 0x44a5c903), LEPT_U64(0x737f74f1, 0xdc043328) },	/* 1e327 */
+	{ LEPT_U64(0xc0fe9088, 0x95cf3b44), LEPT_U64(0x505f522e, 0x53053ff2) },	/* 1e328 */
+	{ LEPT_U64(0xf13e34aa, 0xbb430a15), LEPT_U64(0x647726b9, 0xe7c68fef) },	/* 1e329 */
+	{ LEPT_U64(0x96c6e0ea, 0xb509e64d), LEPT_U64(0x5eca7834, 0x30dc19f5) },	/* 1e330 */
+	{ LEPT_U64(0xbc789925, 0x624c5fe0), LEPT_U64(0xb67d1641, 0x3d132072) },	/* 1e331 */
+	{ LEPT_U64(0xeb96bf6e, 0xbadf77d8), LEPT_U64(0xe41c5bd1, 0x8c57e88f) },	/* 1e332 */
+	{ LEPT_U64(0x933e37a5, 0x34cbaae7), LEPT_U64(0x8e91b962, 0xf7b6f159) },	/* 1e333 */
+	{ LEPT_U64(0xb80dc58e, 0x81fe95a1), LEPT_U64(0x723627bb, 0xb5a4adb0) },	/* 1e334 */
+	{ LEPT_U64(0xe61136f2, 0x227e3b09), LEPT_U64(0xcec3b1aa, 0xa30dd91c) },	/* 1e335 */
+	{ LEPT_U64(0x8fcac257, 0x558ee4e6), LEPT_U64(0x213a4f0a, 0xa5e8a7b1) },	/* 1e336 */
+	{ LEPT_U64(0xb3bd72ed, 0x2af29e1f), LEPT_U64(0xa988e2cd, 0x4f62d19d) },	/* 1e337 */
+	{ LEPT_U64(0xe0accfa8, 0x75af45a7), LEPT_U64(0x93eb1b80, 0xa33b8605) },	/* 1e338 */
+	{ LEPT_U64(0x8c6c01c9, 0x498d8b88), LEPT_U64(0xbc72f130, 0x660533c3) },	/* 1e339 */
+	{ LEPT_U64(0xaf87023b, 0x9bf0ee6a), LEPT_U64(0xeb8fad7c, 0x7f8680b4) },	/* 1e340 */
+	{ LEPT_U64(0xdb68c2ca, 0x82ed2a05), LEPT_U64(0xa67398db, 0x9f6820e1) },	/* 1e341 */
+	{ LEPT_U64(0x892179be, 0x91d43a43), LEPT_U64(0x88083f89, 0x43a1148c) },	/* 1e342 */
+	{ LEPT_U64(0xab69d82e, 0x364948d4), LEPT_U64(0x6a0a4f6b, 0x948959b0) },	/* 1e343 */
+	{ LEPT_U64(0xd6444e39, 0xc3db9b09), LEPT_U64(0x848ce346, 0x79abb01c) },	/* 1e344 */
+	{ LEPT_U64(0x85eab0e4, 0x1a6940e5), LEPT_U64(0xf2d80e0c, 0x0c0b4e11) },	/* 1e345 */
+	{ LEPT_U64(0xa7655d1d, 0x2103911f), LEPT_U64(0x6f8e118f, 0x0f0e2195) },	/* 1e346 */
+	{ LEPT_U64(0xd13eb464, 0x69447567), LEPT_U64(0x4b7195f2, 0xd2d1a9fb) },	/* 1e347 */
+};
 
-	if (*p == '.') {
-		p++;
-		if (!ISDIGIT(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
-	}
+static const double lept_pow10_exact[] = {
+	1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+	1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22
+};
 
-	if (*p == 'e' || *p == 'E') {
-		p++;
-		if (*p == '+' || *p == '-') p++;
-		if (!ISDIGIT(*p)) return LEPT_PARSE_INVALID_VALUE;
-		for (p++; ISDIGIT(*p); p++);
+inline int lept_clz64(uint64_t x) {
+	assert(x != 0);
+#if defined(__GNUC__)
+	return __builtin_clzll(x);
+#else
+	int n = 0;
+	while (!(x & LEPT_U64(0x80000000, 0))) {
+		x <<= 1;
+		n++;
 	}
-	errno = 0;
-	v->u.n = strtod(c->json, NULL);
-	if (errno == ERANGE && (v->u.n == HUGE_VAL || v->u.n == -HUGE_VAL))
-		return LEPT_PARSE_NUMBER_TOO_BIG;
-	c->json = p;
-	v->type = LEPT_NUMBER;
-	return LEPT_PARSE_OK;
+	return n;
+#endif
 }
 
-static const char* lept_parse_hex4(const char* p, unsigned* u) {	// Read 4 bits of hexadecimal numbers
-	*u = 0;
-	for (int i = 0; i < 4; i++) {
-		char ch = *p++;
-		*u <<= 4;
-		if (ch >= '0'&&ch <= '9') *u |= ch - '0';
-		else if (ch >= 'A'&&ch <= 'F')*u |= ch - 'A' + 10;
-		else if (ch >= 'a'&&ch <= 'f')*u |= ch - 'a' + 10;
-		else return NULL;
+inline uint64_t lept_mul128(uint64_t a, uint64_t b, uint64_t* hi) {	// Returns the low word of a * b
+#if defined(__SIZEOF_INT128__)
+	__extension__ typedef unsigned __int128 lept_u128;
+	lept_u128 p = (lept_u128)a * b;
+	*hi = (uint64_t)(p >> 64);
+	return (uint64_t)p;
+#else
+	uint64_t a0 = a & 0xFFFFFFFF, a1 = a >> 32, b0 = b & 0xFFFFFFFF, b1 = b >> 32;
+	uint64_t p00 = a0 * b0, p01 = a0 * b1, p10 = a1 * b0, p11 = a1 * b1;
+	uint64_t mid = (p00 >> 32) + (p01 & 0xFFFFFFFF) + (p10 & 0xFFFFFFFF);
+	*hi = p11 + (p01 >> 32) + (p10 >> 32) + (mid >> 32);
+	return (mid << 32) | (p00 & 0xFFFFFFFF);
+#endif
+}
+
+/* m * 10^e10 rounded to the bits of a positive double, false when it cannot be decided this way */
+static bool lept_eisel_lemire(uint64_t m, long e10, uint64_t* bits) {
+	uint64_t hi, lo, yhi, ylo, mantissa, exp2;
+	const uint64_t* pow;
+	int clz, msb;
+	if (m == 0) {
+		*bits = 0;
+		return true;
 	}
-	return p;
+	if (e10 < LEPT_POW10_MIN || e10 > LEPT_POW10_MAX)
+		return false;
+	pow = lept_pow10_128[e10 - LEPT_POW10_MIN];
+	clz = lept_clz64(m);
+	m <<= clz;
+	exp2 = (uint64_t)(((217706 * e10) >> 16) + 64 + 1023 - clz);	/* floor(log2(10^e10)) + 64 + bias */
+	lo = lept_mul128(m, pow[0], &hi);
+	if ((hi & 0x1FF) == 0x1FF && lo + m < m) {	/* the truncated low word of 10^e10 may matter */
+		ylo = lept_mul128(m, pow[1], &yhi);
+		if (lo + yhi < lo)
+			hi++;
+		lo += yhi;
+		if ((hi & 0x1FF) == 0x1FF && lo + 1 == 0 && ylo + m < m)
+			return false;
+	}
+	msb = (int)(hi >> 63);
+	mantissa = hi >> (msb + 9);	/* 54 bits */
+	exp2 -= 1 ^ msb;
+	if (lo == 0 && (hi & 0x1FF) == 0 && (mantissa & 3) == 1)
+		return false;	/* maybe exactly halfway */
+	mantissa += mantissa & 1;
+	mantissa >>= 1;
+	if (mantissa >> 53) {
+		mantissa >>= 1;
+		exp2++;
+	}
+	if (exp2 - 1 >= 0x7FF - 1)
+		return false;	/* subnormal or infinite */
+	*bits = (exp2 << 52) | (mantissa & LEPT_U64(0x000FFFFF, 0xFFFFFFFF));
+	return true;
 }
 
-/*
-BUG:
-static const char* lept_parse_hex4(const char* p, unsigned* u) {
-	char* end;
-	*u = (unsigned)strtol(p, &end, 16);
-	return end == p + 4 ? end : NULL;
+/* Big decimal 0.d[0]d[1]...d[nd-1] * 10^dp, shifted by powers of two until its binary exponent is known */
+const int LEPT_DECIMAL_DIGITS = 800;	/* enough for every digit that can matter in a double */
+const int LEPT_DECIMAL_MAX_SHIFT = 60;
+
+struct lept_decimal {
+	int nd, dp;
+	bool truncated;	/* nonzero digits were dropped after d[LEPT_DECIMAL_DIGITS - 1] */
+	unsigned char d[LEPT_DECIMAL_DIGITS];
+};
+
+static void lept_decimal_trim(lept_decimal* a) {
+	while (a->nd > 0 && a->d[a->nd - 1] == 0)
+		a->nd--;
+	if (a->nd == 0)
+		a->dp = 0;
 }
-note:	it would pass the invalid test case: "\u 123"
-		and it should add processing to determine whether there are spaces at the beginning. 
-*/
 
-static void lept_encode_utf8(lept_context*c, unsigned u) {
-	if (u <= 0x7F) {
-		PUTC(c, u & 0xFF);
+static void lept_decimal_assign(lept_decimal* a, const char* p, const char* end) {
+	long e = 0;
+	bool negative = false;
+	a->nd = a->dp = 0;
+	a->truncated = false;
+	if (*p == '-')
+		p++;
+	for (; p != end && ISDIGIT(*p); p++) {
+		if (*p == '0' && a->nd == 0)
+			continue;
+		if (a->nd < LEPT_DECIMAL_DIGITS)
+			a->d[a->nd++] = (unsigned char)(*p - '0');
+		else if (*p != '0')
+			a->truncated = true;
+		a->dp++;
 	}
-	else if (u <= 0x7FF) {
-		PUTC(c, 0xC0 | ((u >> 6) & 0x1F));
-		PUTC(c, 0x80 | (u & 0x3F));
+	if (p != end && *p == '.') {
+		for (p++; p != end && ISDIGIT(*p); p++) {
+			if (*p == '0' && a->nd == 0) {
+				a->dp--;
+				continue;
+			}
+			if (a->nd < LEPT_DECIMAL_DIGITS)
+				a->d[a->nd++] = (unsigned char)(*p - '0');
+			else if (*p != '0')
+				a->truncated = true;
+		}
+	}
+	if (p != end && (*p == 'e' || *p == 'E')) {
+		p++;
+		if (*p == '+' || *p == '-')
+			negative = *p++ == '-';
+		for (; p != end && ISDIGIT(*p); p++)
+			if (e < 100000)
+				e = e * 10 + (*p - '0');
+		a->dp += (int)(negative ? -e : e);
+	}
+	lept_decimal_trim(a);
+}
+
+static void lept_decimal_right_shift(lept_decimal* a, int k) {
+	uint64_t n = 0, mask = ((uint64_t)1 << k) - 1;
+	int r = 0, w = 0;
+	for (; (n >> k) == 0; r++) {
+		if (r >= a->nd) {
+			if (n == 0) {
+				a->nd = 0;
+				return;
+			}
+			while ((n >> k) == 0) {
+				n *= 10;
+				r++;
+			}
+			break;
+		}
+		n = n * 10 + a->d[r];
 	}
-	else if (u < 0xFFFF) {
-		PUTC(c, 0xE0 | ((u >> 12) & 0x0F));
-		PUTC(c, (0x80 | ((u >> 6) & 0x3F)));
-		PUTC(c, (0x80 | (u & 0x3F)));
+	a->dp -= r - 1;
+	for (; r < a->nd; r++) {
+		unsigned char digit = (unsigned char)(n >> k);
+		n = (n & mask) * 10 + a->d[r];
+		a->d[w++] = digit;
 	}
-	else if (u < 0x10FFFF) {
-		PUTC(c, 0xF0 | ((u >> 18) & 0x07));
-		PUTC(c, 0x80 | ((u >> 12) & 0x3F));
-		PUTC(c, (0x80 | ((u >> 6) & 0x3F)));
-		PUTC(c, (0x80 | (u & 0x3F)));
+	while (n > 0) {
+		unsigned char digit = (unsigned char)(n >> k);
+		n = (n & mask) * 10;
+		if (w < LEPT_DECIMAL_DIGITS)
+			a->d[w++] = digit;
+		else if (digit > 0)
+			a->truncated = true;
+	}
+	a->nd = w;
+	lept_decimal_trim(a);
+}
+
+static void lept_decimal_left_shift(lept_decimal* a, int k) {
+	uint64_t n = 0;
+	int r, w, delta = 0;
+	for (r = a->nd - 1; r >= 0; r--)	/* a first pass counts the new leading digits */
+		n = ((uint64_t)a->d[r] << k) + n / 10;
+	for (n /= 10; n > 0; n /= 10)
+		delta++;
+	w = a->nd + delta;
+	for (r = a->nd - 1, n = 0; r >= 0 || n > 0; r--) {
+		uint64_t digit;
+		if (r >= 0)
+			n += (uint64_t)a->d[r] << k;
+		digit = n % 10;
+		n /= 10;
+		if (--w < LEPT_DECIMAL_DIGITS)
+			a->d[w] = (unsigned char)digit;
+		else if (digit != 0)
+			a->truncated = true;
+	}
+	a->nd += delta;
+	if (a->nd > LEPT_DECIMAL_DIGITS)
+		a->nd = LEPT_DECIMAL_DIGITS;
+	a->dp += delta;
+	lept_decimal_trim(a);
+}
+
+static void lept_decimal_shift(lept_decimal* a, int k) {	// Multiplies by 2^k
+	if (a->nd == 0)
+		return;
+	for (; k > LEPT_DECIMAL_MAX_SHIFT; k -= LEPT_DECIMAL_MAX_SHIFT)
+		lept_decimal_left_shift(a, LEPT_DECIMAL_MAX_SHIFT);
+	for (; k < -LEPT_DECIMAL_MAX_SHIFT; k += LEPT_DECIMAL_MAX_SHIFT)
+		lept_decimal_right_shift(a, LEPT_DECIMAL_MAX_SHIFT);
+	if (k > 0)
+		lept_decimal_left_shift(a, k);
+	else if (k < 0)
+		lept_decimal_right_shift(a, -k);
+}
+
+static uint64_t lept_decimal_rounded_integer(const lept_decimal* a) {	// Rounds half to even
+	uint64_t n = 0;
+	int i;
+	bool up;
+	assert(a->dp <= 20);
+	for (i = 0; i < a->dp && i < a->nd; i++)
+		n = n * 10 + a->d[i];
+	for (; i < a->dp; i++)
+		n *= 10;
+	if (a->dp < 0 || a->dp >= a->nd)
+		return n;
+	if (a->d[a->dp] == 5 && a->dp + 1 == a->nd)
+		up = a->truncated || (a->dp > 0 && (a->d[a->dp - 1] & 1));
+	else
+		up = a->d[a->dp] >= 5;
+	return n + (up ? 1 : 0);
+}
+
+/* The bits of the positive double nearest to the number in [p, end), false on overflow */
+static bool lept_decimal_to_bits(const char* p, const char* end, uint64_t* bits) {
+	static const int steps[] = { 1, 3, 6, 9, 13, 16, 19, 23, 26 };	/* 2^steps[i] < 10^i */
+	lept_decimal a;
+	uint64_t mantissa;
+	int exp2 = 0, n;
+	lept_decimal_assign(&a, p, end);
+	*bits = 0;
+	if (a.nd == 0 || a.dp < -330)
+		return true;
+	if (a.dp > 310)
+		return false;
+	while (a.dp > 0) {	/* scale into [0.5, 1) */
+		n = a.dp >= 9 ? 27 : steps[a.dp];
+		lept_decimal_shift(&a, -n);
+		exp2 += n;
+	}
+	while (a.dp < 0 || (a.dp == 0 && a.d[0] < 5)) {
+		n = -a.dp >= 9 ? 27 : steps[-a.dp];
+		lept_decimal_shift(&a, n);
+		exp2 -= n;
+	}
+	exp2--;	/* now in [1, 2) */
+	if (exp2 < -1022) {	/* subnormal */
+		lept_decimal_shift(&a, exp2 + 1022);
+		exp2 = -1022;
+	}
+	if (exp2 > 1023)
+		return false;
+	lept_decimal_shift(&a, 53);
+	mantissa = lept_decimal_rounded_integer(&a);
+	if (mantissa == (uint64_t)2 << 52) {
+		mantissa >>= 1;
+		if (++exp2 > 1023)
+			return false;
+	}
+	if (!(mantissa & ((uint64_t)1 << 52)))
+		exp2 = -1023;	/* subnormal or zero */
+	*bits = ((uint64_t)(exp2 + 1023) << 52) | (mantissa & LEPT_U64(0x000FFFFF, 0xFFFFFFFF));
+	return true;
+}
+
+/*
+	[p, end) is a valid number with the significand m (its first 19 significant digits) and the
+	exponent e10, truncated if nonzero digits did not fit in m. Returns false on overflow.
+*/
+static bool lept_strtod(const char* p, const char* end, uint64_t m, long e10, bool truncated, double* d) {
+	uint64_t bits, upper;
+	bool negative = *p == '-';
+	if (!truncated && m <= ((uint64_t)1 << 53) && e10 >= -22 && e10 <= 22) {
+		/* both operands are exact, so is the correctly rounded product or quotient */
+		*d = e10 < 0 ? (double)m / lept_pow10_exact[-e10] : (double)m * lept_pow10_exact[e10];
+		if (negative)
+			*d = -*d;
+		return true;
+	}
+	if (!lept_eisel_lemire(m, e10, &bits) || (truncated && (!lept_eisel_lemire(m + 1, e10, &upper) || upper != bits)))
+		if (!lept_decimal_to_bits(p, end, &bits))
+			return false;
+	if (negative)
+		bits |= LEPT_U64(0x80000000, 0);
+	memcpy(d, &bits, sizeof(double));
+	return true;
+}
+
+static int lept_parse_number(lept_context* c, double* n) {
+	/*
+		grammar:
+			number = [ "-" ] int [ frac ] [ exp ]
+			int = "0" / digit1-9 *digit
+			frac = "." 1*digit
+			exp = ("e" / "E") ["-" / "+"] 1*digit
+	*/
+	const char* p = c->json, *end = c->end;
+	uint64_t m = 0;	/* the first 19 significant digits, read while validating */
+	int digits = 0;
+	long e10 = 0, e = 0;
+	bool truncated = false, negative = false;
+
+	if (CHAR_AT(p, end) == '-') p++;
+
+	if (CHAR_AT(p, end) == '0') p++;
+	else {
+		if (!ISDIGIT1TO9(CHAR_AT(p, end))) return LEPT_PARSE_INVALID_VALUE;
+		for (; ISDIGIT(CHAR_AT(p, end)); p++) {
+			if (digits < 19) {
+				m = m * 10 + (*p - '0');
+				digits++;
+			}
+			else {
+				e10++;
+				truncated |= *p != '0';
+			}
+		}
+	}
+
+	if (CHAR_AT(p, end) == '.') {
+		p++;
+		if (!ISDIGIT(CHAR_AT(p, end))) return LEPT_PARSE_INVALID_VALUE;
+		for (; ISDIGIT(CHAR_AT(p, end)); p++) {
+			if (digits < 19) {
+				m = m * 10 + (*p - '0');
+				e10--;
+				if (m)	/* leading zeros are not significant */
+					digits++;
+			}
+			else
+				truncated |= *p != '0';
+		}
+	}
+
+	if (CHAR_AT(p, end) == 'e' || CHAR_AT(p, end) == 'E') {
+		p++;
+		if (CHAR_AT(p, end) == '+' || CHAR_AT(p, end) == '-') negative = *p++ == '-';
+		if (!ISDIGIT(CHAR_AT(p, end))) return LEPT_PARSE_INVALID_VALUE;
+		for (; ISDIGIT(CHAR_AT(p, end)); p++)
+			if (e < 100000)	/* far beyond any double, and no overflow */
+				e = e * 10 + (*p - '0');
+		e10 += negative ? -e : e;
+	}
+	if (!lept_strtod(c->json, p, m, e10, truncated, n))
+		return LEPT_PARSE_NUMBER_TOO_BIG;
+	c->json = p;
+	return LEPT_PARSE_OK;
+}
+
+static const char* lept_parse_hex4(const char* p, const char* end, unsigned* u) {	// Read 4 bits of hexadecimal numbers
+	*u = 0;
+	if (end - p < 4)
+		return NULL;
+	for (int i = 0; i < 4; i++) {
+		char ch = *p++;
+		*u <<= 4;
+		if (ch >= '0'&&ch <= '9') *u |= ch - '0';
+		else if (ch >= 'A'&&ch <= 'F')*u |= ch - 'A' + 10;
+		else if (ch >= 'a'&&ch <= 'f')*u |= ch - 'a' + 10;
+		else return NULL;
+	}
+	return p;
+}
+
+/*
+BUG:
+static const char* lept_parse_hex4(const char* p, unsigned* u) {
+	char* end;
+	*u = (unsigned)strtol(p, &end, 16);
+	return end == p + 4 ? end : NULL;
+}
+note:	it would pass the invalid test case: "\u 123"
+		and it should add processing to determine whether there are spaces at the beginning. 
+*/
+
+static size_t lept_encode_utf8(char* buf, unsigned u) {	// Returns the number of bytes written to buf[4]
+	if (u <= 0x7F) {
+		buf[0] = (char)(u & 0xFF);
+		return 1;
+	}
+	else if (u <= 0x7FF) {
+		buf[0] = (char)(0xC0 | ((u >> 6) & 0x1F));
+		buf[1] = (char)(0x80 | (u & 0x3F));
+		return 2;
+	}
+	else if (u <= 0xFFFF) {
+		buf[0] = (char)(0xE0 | ((u >> 12) & 0x0F));
+		buf[1] = (char)(0x80 | ((u >> 6) & 0x3F));
+		buf[2] = (char)(0x80 | (u & 0x3F));
+		return 3;
+	}
+	else {
+		assert(u <= 0x10FFFF);
+		buf[0] = (char)(0xF0 | ((u >> 18) & 0x07));
+		buf[1] = (char)(0x80 | ((u >> 12) & 0x3F));
+		buf[2] = (char)(0x80 | ((u >> 6) & 0x3F));
+		buf[3] = (char)(0x80 | (u & 0x3F));
+		return 4;
 	}
 }
 
@@ -227,38 +1857,63 @@ static int lept_parse_string_raw(lept_context* c, char** str, size_t* len) {
 	size_t head = c->top;
 	unsigned u, u2;
 	const char* p;
+	char* w;	// In situ the decoded bytes are written back over the input, always behind p
+	char esc[4];
+	size_t n;
 	EXPECT(c, '\"');
 	p = c->json;
+	w = c->insitu ? (char*)p : NULL;
 	for (;;) {
+		const char* run = lept_scan_string(p, c->end);	// copy the whole run of unescaped characters with one push
+		if (run != p) {
+			if (!w)
+				PUTS(c, p, run - p);
+			else {
+				if (w != p)
+					memmove(w, p, run - p);
+				w += run - p;
+			}
+			p = run;
+		}
+		if (p == c->end)	// missing quotation mark (see test sample in "test_parse_missing_quotation_mark")
+			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
 		char ch = *p++;
 		switch (ch) {
 		case '\"':	// case 1Reading ending quotation marks
-			*len = c->top - head;
-			*str = (char*)lept_context_pop(c, *len);
+			if (!w) {
+				*len = c->top - head;
+				*str = (char*)lept_context_pop(c, *len);
+			}
+			else {
+				*str = (char*)c->json;
+				*len = w - *str;
+				*w = '\0';	// at most overwrites the closing quotation mark
+			}
 			c->json = p;
 			return LEPT_PARSE_OK;
 		case '\\':	// case 2Reading escape symbol
-			switch (*p++) {
-				case '\"': PUTC(c, '\"'); break;
-				case '\\': PUTC(c, '\\'); break;
-				case '/':  PUTC(c, '/'); break;
-				case 'b':  PUTC(c, '\b'); break;
-				case 'f':  PUTC(c, '\f'); break;
-				case 'n':  PUTC(c, '\n'); break;
-				case 'r':  PUTC(c, '\r'); break;
-				case 't':  PUTC(c, '\t'); break;
+			n = 1;
+			switch (p != c->end ? *p++ : '\0') {
+				case '\"': esc[0] = '\"'; break;
+				case '\\': esc[0] = '\\'; break;
+				case '/':  esc[0] = '/'; break;
+				case 'b':  esc[0] = '\b'; break;
+				case 'f':  esc[0] = '\f'; break;
+				case 'n':  esc[0] = '\n'; break;
+				case 'r':  esc[0] = '\r'; break;
+				case 't':  esc[0] = '\t'; break;
 				case 'u':
-					if (!(p = lept_parse_hex4(p, &u))) {
+					if (!(p = lept_parse_hex4(p, c->end, &u))) {
 						STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
 					}
 					if (u >= 0xD800 && u <= 0xDBFF) {
-						if (*p++ != '\\') {
+						if (p == c->end || *p++ != '\\') {
 							STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
 						}
-						if (*p++ != 'u') {
+						if (p == c->end || *p++ != 'u') {
 							STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_SURROGATE);
 						}
-						if (!(p = lept_parse_hex4(p, &u2))) {
+						if (!(p = lept_parse_hex4(p, c->end, &u2))) {
 							STRING_ERROR(LEPT_PARSE_INVALID_UNICODE_HEX);
 						}
 						if (u2 < 0xDC00 || u2 > 0xDFFF) {
@@ -266,365 +1921,4255 @@ static int lept_parse_string_raw(lept_context* c, char** str, size_t* len) {
 						}
 						u = (((u - 0xD800) << 10) | (u2 - 0xDC00)) + 0x10000;
 					}
-					lept_encode_utf8(c, u);
+					n = lept_encode_utf8(esc, u);
 					break;
 				default:	// invalid escape symbol
 					STRING_ERROR(LEPT_PARSE_INVALID_STRING_ESCAPE);
 			}
-			break;
-		case '\0':	// case 3missing quotation marksee test sample in "test_parse_missing_quotation_mark"
-			STRING_ERROR(LEPT_PARSE_MISS_QUOTATION_MARK);
-		default:	// case 4normal character
-			if ((unsigned char)ch < 0x20) {	// invalid character
-				STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
+			if (!w)
+				PUTS(c, esc, n);
+			else {
+				memcpy(w, esc, n);
+				w += n;
 			}
-			PUTC(c, ch);
+			break;
+		default:	// case 3: control character, an embedded '\0' included
+			assert((unsigned char)ch < 0x20);	// lept_scan_string() stops at nothing else
+			STRING_ERROR(LEPT_PARSE_INVALID_STRING_CHAR);
 		}
 	}
 }
 
-static int lept_parse_string(lept_context* c, lept_value* v) {
-	int ret;
-	char* s;
-	size_t len;
-	if ((ret = lept_parse_string_raw(c, &s, &len)) == LEPT_PARSE_OK)
-		lept_set_string(v, s, len);
-	return ret;
+/*
+	Object index: an open-addressing table of member positions for objects of at least
+	LEPT_OBJECT_INDEX_THRESHOLD members, smaller ones are scanned. It is built by the first lookup,
+	or during the parse into an arena since lept_free() never visits arena objects. Member order
+	is unchanged and a duplicated key finds its first member, as a scan would.
+*/
+const size_t LEPT_OBJECT_INDEX_THRESHOLD = 16;
+
+struct lept_object_index {
+	size_t mask;	/* capacity - 1, the capacity is a power of two at least twice the size */
+	lept_hash_cache hash;	/* of the object */
+	size_t slots[1];	/* member position + 1, 0 for an empty slot */
+};
+
+static size_t lept_hash_key(const char* k, size_t klen) {	// FNV-1a
+	uint64_t h = LEPT_U64(0xcbf29ce4, 0x84222325);
+	for (; klen; klen--)
+		h = (h ^ (unsigned char)*k++) * LEPT_U64(0x00000100, 0x000001b3);
+	return (size_t)(h ^ (h >> 32));
 }
 
-static int lept_parse_value(lept_context* c, lept_value* v); /* Forward Declaration */
-static int lept_parse_array(lept_context* c, lept_value* v) {
-	/*
-	grammar:
-		array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
-	*/
-	size_t size = 0;
-	int ret;
-	EXPECT(c, '[');
-	lept_parse_whitespace(c);
-	if (*c->json == ']') {
-		c->json++;
-		v->type = LEPT_ARRAY;
-		v->u.a.size = 0;
-		v->u.a.e = NULL;
-		return LEPT_PARSE_OK;
+template <class Key>	/* lept_member or lept_shape_key */
+inline bool lept_key_equal(const Key* m, const char* k, size_t klen) {
+	return m->klen == klen && memcmp(m->k, k, klen) == 0;
+}
+
+static size_t lept_object_index_bytes(size_t size) {
+	size_t capacity = 8;
+	while (capacity < 2 * size)
+		capacity <<= 1;
+	return sizeof(lept_object_index) + (capacity - 1) * sizeof(size_t);
+}
+
+/* mem holds lept_object_index_bytes(size) bytes */
+template <class Key>
+static lept_object_index* lept_object_index_build(void* mem, const Key* m, size_t size) {
+	lept_object_index* index = (lept_object_index*)mem;
+	size_t i, j;
+	index->mask = (lept_object_index_bytes(size) - sizeof(lept_object_index)) / sizeof(size_t);
+	index->hash.tree = 0;
+	memset(index->slots, 0, (index->mask + 1) * sizeof(size_t));
+	for (i = 0; i < size; i++) {
+		for (j = lept_hash_key(m[i].k, m[i].klen) & index->mask; index->slots[j]; j = (j + 1) & index->mask)
+			if (lept_key_equal(&m[index->slots[j] - 1], m[i].k, m[i].klen))
+				break;
+		if (!index->slots[j])
+			index->slots[j] = i + 1;
 	}
-	//BUG:
-	//for (;;) {
-	//	lept_value* e = lept_context_push(c, sizeof(lept_value));
-	//	lept_init(e);
-	//	size++;
-	//	if ((ret = lept_parse_value(c, e)) != LEPT_PARSE_OK)
-	//		return ret;
-	//	/* ... */
-	//}
-	for (;;) {
-		lept_value e;
-		lept_init(&e);
-		if ((ret = lept_parse_value(c, &e)) != LEPT_PARSE_OK) {
-			break;
-		}
-		memcpy(lept_context_push(c, sizeof(lept_value)), &e, sizeof(lept_value));
-		size++;
-		lept_parse_whitespace(c);
-		if (*c->json == ',') {
-			c->json++;
-			lept_parse_whitespace(c);
-		}
-		else if (*c->json == ']') {
-			c->json++;
-			v->type = LEPT_ARRAY;
-			v->u.a.size = size;
-			size *= sizeof(lept_value);
-			memcpy(v->u.a.e = (lept_value*)malloc(size), lept_context_pop(c, size), size);
-			return LEPT_PARSE_OK;
-		}
-		else {
-			ret = LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
-			break;
+	return index;
+}
+
+/*
+	Shapes (hidden classes): lept_parse_shaped() stores an object as its values and a pointer to a
+	reference-counted shape holding the keys, shared by every object of the document with the same
+	key sequence. Each key is first compared with the shape of the previous object at the same
+	depth, so the records of an array match without a copy of their keys; other objects find their
+	shape in a table interned per parse.
+*/
+struct lept_shape_key {
+	char* k;
+	size_t klen;
+};
+
+struct lept_shape {
+	size_t refs;
+	size_t size;
+	size_t hash;	/* of the key sequence */
+	lept_object_index* index;	/* NULL until a lookup needs it */
+	bool distinct;	/* no key repeats: objects of the shape compare member by member in order */
+	lept_shape_key keys[1];	/* followed by the NUL-terminated key bytes */
+};
+
+struct lept_shape_frame {
+	lept_shape* last;	/* the shape of the previous object at this depth */
+	size_t pos;	/* keys of the current object that matched last */
+	bool match;
+};
+
+struct lept_shape_builder {
+	lept_shape_frame* frames;
+	size_t depth, frame_capacity;
+	lept_shape** table;	/* open addressing, the shapes of this document, no references held */
+	size_t count, mask;
+};
+
+static void lept_shape_builder_init(lept_shape_builder* b) {
+	b->frames = NULL;
+	b->depth = b->frame_capacity = 0;
+	b->table = NULL;
+	b->count = b->mask = 0;
+}
+
+static void lept_shape_builder_free(lept_shape_builder* b) {
+	lept_mem_free(b->frames, 0);
+	lept_mem_free(b->table, 0);
+}
+
+static void lept_shape_release(lept_shape* shape) {
+	if (--shape->refs == 0) {
+		lept_mem_free(shape->index, 0);
+		lept_mem_free(shape, 0);
+	}
+}
+
+/* keys of the key/value pairs kv[0..2 * size) */
+static size_t lept_hash_keys(const lept_value* kv, size_t size) {
+	size_t h = size, i;
+	for (i = 0; i < size; i++)
+		h = (h ^ lept_hash_key(kv[2 * i].u.s.s, kv[2 * i].u.s.len)) * 1000003;
+	return h;
+}
+
+static bool lept_shape_equal(const lept_shape* shape, size_t hash, const lept_value* kv, size_t size) {
+	size_t i;
+	if (shape->hash != hash || shape->size != size)
+		return false;
+	for (i = 0; i < size; i++)
+		if (!lept_key_equal(&shape->keys[i], kv[2 * i].u.s.s, kv[2 * i].u.s.len))
+			return false;
+	return true;
+}
+
+template <class Key>
+static size_t lept_find_key(const Key* m, size_t size, lept_object_index** cache, const char* key, size_t klen);
+
+static lept_shape* lept_shape_create(size_t hash, const lept_value* kv, size_t size) {
+	size_t i, bytes = sizeof(lept_shape) + (size - 1) * sizeof(lept_shape_key);
+	lept_shape* shape;
+	char* p;
+	for (i = 0; i < size; i++)
+		bytes += kv[2 * i].u.s.len + 1;
+	shape = (lept_shape*)lept_mem_alloc(bytes);
+	assert(shape != NULL);
+	shape->refs = 0;
+	shape->size = size;
+	shape->hash = hash;
+	shape->index = NULL;
+	p = (char*)&shape->keys[size];
+	for (i = 0; i < size; i++) {
+		shape->keys[i].k = p;
+		shape->keys[i].klen = kv[2 * i].u.s.len;
+		memcpy(p, kv[2 * i].u.s.s, shape->keys[i].klen);
+		p += shape->keys[i].klen;
+		*p++ = '\0';
+	}
+	for (i = 0; i < size && lept_find_key(shape->keys, size, &shape->index, shape->keys[i].k, shape->keys[i].klen) == i; i++)
+		;
+	shape->distinct = i == size;	/* each key finds itself, not an earlier duplicate */
+	return shape;
+}
+
+/* The shape of the keys in kv, created if the document has none yet */
+static lept_shape* lept_shape_intern(lept_shape_builder* b, const lept_value* kv, size_t size) {
+	size_t hash = lept_hash_keys(kv, size), i;
+	lept_shape* shape;
+	if (2 * (b->count + 1) > b->mask) {	/* keep the table at most half full */
+		size_t mask = b->mask ? 2 * b->mask + 1 : 15;
+		lept_shape** table = (lept_shape**)lept_mem_calloc(mask + 1, sizeof(lept_shape*));
+		assert(table != NULL);
+		for (i = 0; i <= b->mask && b->table; i++) {
+			size_t j;
+			if (!b->table[i])
+				continue;
+			for (j = b->table[i]->hash & mask; table[j]; j = (j + 1) & mask);
+			table[j] = b->table[i];
 		}
+		lept_mem_free(b->table, 0);
+		b->table = table;
+		b->mask = mask;
 	}
-	/* Pop and free values on the stack */
-	for (int i = 0; i < size; i++)
-		lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
-	return ret;
+	for (i = hash & b->mask; (shape = b->table[i]) != NULL; i = (i + 1) & b->mask)
+		if (lept_shape_equal(shape, hash, kv, size))
+			return shape;
+	b->count++;
+	return b->table[i] = lept_shape_create(hash, kv, size);
 }
 
-static int lept_parse_object(lept_context* c, lept_value* v) {
+inline int lept_handled(bool proceed) {	// A handler returns false to stop the parse
+	return proceed ? LEPT_PARSE_OK : LEPT_PARSE_ABORTED;
+}
+
+/*
+	The raw text of every string, key and number is passed to lept_parse_token() after it is scanned.
+	Only the statistics handler overloads it, for every other handler the call is empty and compiled out.
+*/
+template <class Handler>
+inline void lept_parse_token(Handler&, const char*, const char*) {}
+
+template <class Inner> struct lept_stats_handler;
+template <class Inner>
+inline void lept_parse_token(lept_stats_handler<Inner>& h, const char* begin, const char* end) { h.token(begin, end); }
+
+/* The key of a member and the colon after it */
+template <class Handler>
+static int lept_parse_key(lept_context* c, Handler& h) {
 	/*
 	grammar:
 		member = string ws %x3A ws value
-		object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
 	*/
-	size_t size;
-	lept_member m;
+	const char* begin = c->json;
+	size_t klen;
+	char* k;
 	int ret;
-	EXPECT(c, '{');
+	if (!PEEK(c, '"'))
+		return LEPT_PARSE_MISS_KEY;
+	if ((ret = lept_parse_string_raw(c, &k, &klen)) != LEPT_PARSE_OK)
+		return ret;
+	lept_parse_token(h, begin, c->json);
+	if (!h.key(k, klen))
+		return LEPT_PARSE_ABORTED;
+	/* parse ws colon ws */
 	lept_parse_whitespace(c);
-	if (*c->json == '}') {
-		c->json++;
-		v->type = LEPT_OBJECT;
-		v->u.o.m = 0;
-		v->u.o.size = 0;
-		return LEPT_PARSE_OK;
+	if (!PEEK(c, ':'))
+		return LEPT_PARSE_MISS_COLON;
+	c->json++;
+	lept_parse_whitespace(c);
+	return LEPT_PARSE_OK;
+}
+
+template <class Handler>
+static int lept_parse_scalar(lept_context* c, Handler& h) {
+	const char* begin = c->json;
+	int ret;
+	double n;
+	char* s;
+	size_t len;
+	switch (*c->json) {
+		case 'n':
+			if ((ret = lept_parse_literal(c, "null")) != LEPT_PARSE_OK) return ret;
+			return lept_handled(h.null());
+		case 't':
+			if ((ret = lept_parse_literal(c, "true")) != LEPT_PARSE_OK) return ret;
+			return lept_handled(h.boolean(true));
+		case 'f':
+			if ((ret = lept_parse_literal(c, "false")) != LEPT_PARSE_OK) return ret;
+			return lept_handled(h.boolean(false));
+		case '"':
+			if ((ret = lept_parse_string_raw(c, &s, &len)) != LEPT_PARSE_OK) return ret;
+			lept_parse_token(h, begin, c->json);
+			return lept_handled(h.string(s, len));
+		default:	// 0-9 || -
+			if ((ret = lept_parse_number(c, &n)) != LEPT_PARSE_OK) return ret;
+			lept_parse_token(h, begin, c->json);
+			return lept_handled(h.number(n));
 	}
-	m.k = NULL;
-	size = 0;
+}
+
+/*
+	Parses one value without recursion: an array or object pushes a frame on the context and its
+	elements are parsed by the same loop, the frames above c->depth at the call are its own.
+	grammar:
+		array = %x5B ws [ value *( ws %x2C ws value ) ] ws %x5D
+		object = %x7B ws [ member *( ws %x2C ws member ) ] ws %x7D
+*/
+template <class Handler>
+static int lept_parse_nested(lept_context* c, Handler& h, size_t base) {
+	lept_parse_frame* f;
+	bool object;
+	int ret;
 	for (;;) {
-		char* str;
-		lept_init(&m.v);
-		/* parse key to m.k, m.klen */
-		if (*c->json != '"') {
-			ret = LEPT_PARSE_MISS_KEY;
-			break;
-		}
-		if ((ret = lept_parse_string_raw(c, &str, &m.klen)) != LEPT_PARSE_OK)
-			break;
-		memcpy(m.k = (char*)malloc(m.klen + 1), str, m.klen);
-		m.k[m.klen] = '\0';
-		/* parse ws colon ws */
-		lept_parse_whitespace(c);
-		if (*c->json != ':') {
-			ret = LEPT_PARSE_MISS_COLON;
-			break;
-		}
-		c->json++;
-		lept_parse_whitespace(c);
-		/* parse value */
-		if ((ret = lept_parse_value(c, &m.v)) != LEPT_PARSE_OK)
-			break;
-		memcpy(lept_context_push(c, sizeof(lept_member)), &m, sizeof(lept_member));
-		size++;
-		m.k = NULL; /* ownership is transferred to member on stack */
-		/* parse ws [comma | right-curly-brace] ws */
-		lept_parse_whitespace(c);
-		if (*c->json == ',') {
-			c->json++;
+		/* a value, the first element of a container that is not empty continues the loop */
+		if (c->json == c->end)
+			return LEPT_PARSE_EXPECT_VALUE;
+		if (*c->json == '[' || *c->json == '{') {
+			object = *c->json++ == '{';
+			if ((f = lept_context_open(c, object)) == NULL)
+				return LEPT_PARSE_TOO_DEEP;
+			if (!(object ? h.start_object() : h.start_array()))
+				return LEPT_PARSE_ABORTED;
 			lept_parse_whitespace(c);
-		}
-		else if (*c->json == '}') {
-			size_t s = sizeof(lept_member) * size;
+			if (!PEEK(c, object ? '}' : ']')) {
+				if (object && (ret = lept_parse_key(c, h)) != LEPT_PARSE_OK)
+					return ret;
+				continue;
+			}
 			c->json++;
-			v->type = LEPT_OBJECT;
-			v->u.o.size = size;
-			memcpy(v->u.o.m = (lept_member*)malloc(s), lept_context_pop(c, s), s);
-			return LEPT_PARSE_OK;
+			c->depth--;
+			if (!(object ? h.end_object(0) : h.end_array(0)))
+				return LEPT_PARSE_ABORTED;
 		}
-		else {
-			ret = LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
-			break;
+		else if ((ret = lept_parse_scalar(c, h)) != LEPT_PARSE_OK)
+			return ret;
+		/* the value is complete, so are the containers it is the last element of */
+		for (;;) {
+			if (c->depth == base)
+				return LEPT_PARSE_OK;
+			f = &c->frames[c->depth - 1];
+			f->size++;
+			lept_parse_whitespace(c);
+			if (PEEK(c, ',')) {
+				c->json++;
+				lept_parse_whitespace(c);
+				if (f->object && (ret = lept_parse_key(c, h)) != LEPT_PARSE_OK)
+					return ret;
+				break;
+			}
+			if (!PEEK(c, f->object ? '}' : ']'))
+				return f->object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+			c->json++;
+			c->depth--;
+			if (!(f->object ? h.end_object(f->size) : h.end_array(f->size)))
+				return LEPT_PARSE_ABORTED;
 		}
 	}
-	/* Pop and free members on the stack */
-	/* 5. Pop and free members on the stack */
-	free(m.k);
-	for (int i = 0; i < size; i++) {
-		lept_member* m = (lept_member*)lept_context_pop(c, sizeof(lept_member));
-		free(m->k);
-		lept_free(&m->v);
-	}
-	v->type = LEPT_NULL;
+}
+
+template <class Handler>
+static int lept_parse_value(lept_context* c, Handler& h) {
+	size_t base = c->depth;
+	int ret = lept_parse_nested(c, h, base);
+	c->depth = base;	/* an error leaves frames open */
 	return ret;
 }
 
-static int lept_parse_value(lept_context* c, lept_value* v) {
-	switch (*c->json) {
-		case 'n':  return lept_parse_literal(c, v, "null", LEPT_NULL);
-		case 't': return lept_parse_literal(c, v, "true", LEPT_TRUE);
-		case 'f': return lept_parse_literal(c, v, "false", LEPT_FALSE);
-		case '\0': return LEPT_PARSE_EXPECT_VALUE;
-		case '"': return lept_parse_string(c, v);
-		case '[': return lept_parse_array(c, v);
-		case '{': return lept_parse_object(c, v);
-		default:  return lept_parse_number(c, v);	// 0-9 || -
-	}
+template <class Handler>
+static int lept_parse_member(lept_context* c, Handler& h) {
+	int ret;
+	if ((ret = lept_parse_key(c, h)) != LEPT_PARSE_OK)
+		return ret;
+	return lept_parse_value(c, h);
 }
 
-int lept_parse(lept_value* v, const char* json) {
-	lept_context c;
+template <class Handler>
+static int lept_parse_document(lept_context* c, Handler& h) {
 	int ret;
-	assert(v != NULL);
-	c.json = json;
-	c.stack = NULL;
-	c.size = c.top = 0;
-	lept_init(v);
-	lept_parse_whitespace(&c);
-	ret = lept_parse_value(&c, v);
-	if (ret == LEPT_PARSE_OK) {
-		lept_parse_whitespace(&c);
-		if (*c.json != '\0') {
-			v->type = LEPT_NULL;
+	lept_parse_whitespace(c);
+	if ((ret = lept_parse_value(c, h)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(c);
+		if (c->json != c->end)
 			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
-		}
 	}
-	assert(c.top == 0);
-	free(c.stack);
 	return ret;
 }
 
-static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
-	static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
-	size_t i, size;
-	char* head, *p;
-	assert(s != NULL);
-	p = head = (char *)lept_context_push(c, size = len * 6 + 2); /* "\u00xx..." */
-	*p++ = '"';
-	for (i = 0; i < len; i++) {
-		unsigned char ch = (unsigned char)s[i];
-		switch (ch) {
-		case '\"': *p++ = '\\'; *p++ = '\"'; break;
-		case '\\': *p++ = '\\'; *p++ = '\\'; break;
-		case '\b': *p++ = '\\'; *p++ = 'b';  break;
-		case '\f': *p++ = '\\'; *p++ = 'f';  break;
-		case '\n': *p++ = '\\'; *p++ = 'n';  break;
-		case '\r': *p++ = '\\'; *p++ = 'r';  break;
-		case '\t': *p++ = '\\'; *p++ = 't';  break;
-		default:
-			if (ch < 0x20) {
-				*p++ = '\\'; *p++ = 'u'; *p++ = '0'; *p++ = '0';
-				*p++ = hex_digits[ch >> 4];
-				*p++ = hex_digits[ch & 15];
+/*
+	The DOM builder is a handler: every finished value is pushed on the context stack, keys wait there as
+	string values, and a container pops its elements (or key/value pairs) when it ends.
+*/
+struct lept_dom_handler {
+	lept_context* c;
+	size_t base;
+	lept_shape_builder* shapes;	/* NULL unless objects are shaped */
+
+	explicit lept_dom_handler(lept_context* c, lept_shape_builder* shapes = NULL) : c(c), base(c->top), shapes(shapes) {}
+
+	lept_value* push() {
+		lept_value* v = (lept_value*)lept_context_push(c, sizeof(lept_value));
+		lept_init(v);
+		return v;
+	}
+
+	bool null() { push(); return true; }
+	bool boolean(bool b) { push()->type = b ? LEPT_TRUE : LEPT_FALSE; return true; }
+
+	bool number(double n) {
+		lept_value* v = push();
+		v->type = LEPT_NUMBER;
+		v->u.n = n;
+		return true;
+	}
+
+	bool string(const char* s, size_t len) {
+		char* str = lept_context_strdup(c, s, len);	// s is scratch space the push below may overwrite
+		lept_value* v = push();
+		v->type = LEPT_STRING;
+		v->u.s.s = str;
+		v->u.s.len = len;
+		if (c->arena || c->insitu)
+			v->flags |= LEPT_FLAG_BORROWED;
+		return true;
+	}
+
+	bool key(const char* s, size_t len) {
+		if (shapes) {
+			lept_shape_frame* f = &shapes->frames[shapes->depth - 1];
+			if (f->match && f->last && f->pos < f->last->size && lept_key_equal(&f->last->keys[f->pos], s, len)) {
+				lept_value* v = push();	/* the shape has the key already */
+				v->type = LEPT_STRING;
+				v->u.s.s = f->last->keys[f->pos++].k;
+				v->u.s.len = len;
+				v->flags |= LEPT_FLAG_BORROWED;
+				return true;
 			}
-			else
-				*p++ = s[i];
+			f->match = false;
 		}
+		return string(s, len);
 	}
-	*p++ = '"';
-	c->top -= size - (p - head);
-}
 
-static void lept_stringify_value(lept_context* c, const lept_value* v) {
-	size_t i;
-	int ret;
-	switch (v->type) {
-		case LEPT_NULL:		PUTS(c, "null", 4); break;
-		case LEPT_FALSE:	PUTS(c, "false", 5); break;
-		case LEPT_TRUE:		PUTS(c, "true", 4); break;
-		case LEPT_NUMBER:	c->top -= 32 - sprintf((char *)lept_context_push(c, 32), "%.17g", v->u.n); break;
-		case LEPT_STRING:	lept_stringify_string(c, v->u.s.s, v->u.s.len); break;
-		case LEPT_ARRAY:
-			PUTC(c, '[');
-			for (i = 0; i < v->u.a.size; i++) {
-				if (i > 0)
-					PUTC(c, ',');
-				lept_stringify_value(c, &v->u.a.e[i]);
+	bool start_array() { return true; }
+
+	bool start_object() {
+		if (shapes) {
+			lept_shape_frame* f;
+			if (shapes->depth == shapes->frame_capacity) {
+				size_t capacity = shapes->frame_capacity ? 2 * shapes->frame_capacity : 16;
+				shapes->frames = (lept_shape_frame*)lept_mem_realloc(shapes->frames, 0, capacity * sizeof(lept_shape_frame));
+				assert(shapes->frames != NULL);
+				for (; shapes->frame_capacity < capacity; shapes->frame_capacity++)
+					shapes->frames[shapes->frame_capacity].last = NULL;
 			}
-			PUTC(c, ']');
-			break;
-		case LEPT_OBJECT:
-			PUTC(c, '{');
-			for (i = 0; i < v->u.o.size; i++) {
-				if (i > 0)
-					PUTC(c, ',');
-				lept_stringify_string(c, v->u.o.m[i].k, v->u.o.m[i].klen);
-				PUTC(c, ':');
-				lept_stringify_value(c, &v->u.o.m[i].v);
+			f = &shapes->frames[shapes->depth++];
+			f->pos = 0;
+			f->match = true;
+		}
+		return true;
+	}
+
+	bool end_array(size_t size) {
+		lept_value v;
+		size_t s = size * sizeof(lept_value);
+		lept_init(&v);
+		v.type = LEPT_ARRAY;
+		v.u.a.size = v.u.a.capacity = size;
+		v.u.a.hash = NULL;
+		v.u.a.e = NULL;
+		if (size)
+			memcpy(v.u.a.e = (lept_value*)lept_context_alloc(c, s), lept_context_pop(c, s), s);
+		if (c->arena)
+			v.flags |= LEPT_FLAG_BORROWED;
+		*push() = v;
+		return true;
+	}
+
+	bool end_object(size_t size) {
+		lept_value v;
+		lept_member* m;
+		const lept_value* kv;
+		size_t i;
+		if (shapes && size)
+			return end_shaped_object(size);
+		if (shapes)
+			shapes->depth--;
+		lept_init(&v);
+		v.type = LEPT_OBJECT;
+		v.u.o.size = v.u.o.capacity = size;
+		v.u.o.m = NULL;
+		v.u.o.index = NULL;
+		if (size) {
+			v.u.o.m = m = (lept_member*)lept_context_alloc(c, size * sizeof(lept_member));
+			kv = (const lept_value*)lept_context_pop(c, 2 * size * sizeof(lept_value));
+			for (i = 0; i < size; i++, kv += 2) {
+				m[i].k = kv[0].u.s.s;
+				m[i].klen = kv[0].u.s.len;
+				m[i].v = kv[1];
 			}
-			PUTC(c, '}');
-			break;
-		default: assert(0 && "invalid type");
+		}
+		if (c->arena) {
+			v.flags |= LEPT_FLAG_BORROWED;
+			if (size >= LEPT_OBJECT_INDEX_THRESHOLD)
+				v.u.o.index = lept_object_index_build(lept_arena_alloc(c->arena, lept_object_index_bytes(size)), m, size);
+		}
+		else if (c->insitu)
+			v.flags |= LEPT_FLAG_BORROWED_KEYS;
+		*push() = v;
+		return true;
 	}
-}
 
-char* lept_stringify(const lept_value* v, size_t* length) {
+	bool end_shaped_object(size_t size) {
+		lept_shape_frame* f = &shapes->frames[--shapes->depth];
+		lept_shape* shape;
+		lept_value v, *kv = (lept_value*)lept_context_pop(c, 2 * size * sizeof(lept_value));
+		size_t i;
+		if (f->match && f->pos == size && f->last->size == size)
+			shape = f->last;
+		else {
+			shape = lept_shape_intern(shapes, kv, size);
+			for (i = 0; i < size; i++)
+				lept_free(&kv[2 * i]);	/* the keys are in the shape now */
+		}
+		shape->refs++;
+		f->last = shape;
+		lept_init(&v);
+		v.type = LEPT_OBJECT;
+		v.flags |= LEPT_FLAG_SHAPED;
+		v.u.sh.size = size;
+		v.u.sh.shape = shape;
+		v.u.sh.hash = NULL;
+		v.u.sh.v = (lept_value*)lept_context_alloc(c, size * sizeof(lept_value));
+		for (i = 0; i < size; i++)
+			v.u.sh.v[i] = kv[2 * i + 1];
+		*push() = v;
+		return true;
+	}
+
+	void pop(lept_value* v) {
+		assert(c->top == base + sizeof(lept_value));
+		memcpy(v, lept_context_pop(c, sizeof(lept_value)), sizeof(lept_value));
+	}
+
+	void discard() {	// Pop and free the values of a failed parse
+		while (c->top > base)
+			lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));
+	}
+};
+
+/* Forwards the events to the callbacks of a lept_handler, a missing callback accepts the event */
+struct lept_sax_adapter {
+	const lept_handler* h;
+	void* user;
+
+	lept_sax_adapter(const lept_handler* h, void* user) : h(h), user(user) {}
+
+	bool null() { return !h->null || h->null(user); }
+	bool boolean(bool b) { return !h->boolean || h->boolean(user, b); }
+	bool number(double n) { return !h->number || h->number(user, n); }
+	bool string(const char* s, size_t len) { return !h->string || h->string(user, s, len); }
+	bool key(const char* s, size_t len) { return !h->key || h->key(user, s, len); }
+	bool start_array() { return !h->start_array || h->start_array(user); }
+	bool end_array(size_t size) { return !h->end_array || h->end_array(user, size); }
+	bool start_object() { return !h->start_object || h->start_object(user); }
+	bool end_object(size_t size) { return !h->end_object || h->end_object(user, size); }
+};
+
+/* Counts the shape of the document into a lept_parse_stats and forwards every event to the inner handler */
+template <class Inner>
+struct lept_stats_handler {
+	Inner& h;
+	lept_parse_stats* stats;
+	size_t depth;
+
+	lept_stats_handler(Inner& h, lept_parse_stats* stats) : h(h), stats(stats), depth(0) {}
+
+	void token(const char* begin, const char* end) {
+		const char* p;
+		if (*begin == '"') {
+			for (p = begin + 1; p < end; p++)
+				if (*p == '\\') {
+					stats->escapes++;
+					p++;
+				}
+		}
+		else {
+			for (p = begin; p < end && *p != '.' && *p != 'e' && *p != 'E'; p++)
+				;
+			if (p == end)
+				stats->integers++;
+			else
+				stats->non_integers++;
+		}
+	}
+
+	void open(lept_type type) {
+		stats->values[type]++;
+		if (++depth > stats->depth)
+			stats->depth = depth;
+	}
+
+	void close(size_t size, size_t* largest) {
+		depth--;
+		if (size > *largest)
+			*largest = size;
+	}
+
+	bool null() { stats->values[LEPT_NULL]++; return h.null(); }
+	bool boolean(bool b) { stats->values[b ? LEPT_TRUE : LEPT_FALSE]++; return h.boolean(b); }
+	bool number(double n) { stats->values[LEPT_NUMBER]++; return h.number(n); }
+
+	bool string(const char* s, size_t len) {
+		stats->values[LEPT_STRING]++;
+		stats->string_bytes += len;
+		return h.string(s, len);
+	}
+
+	bool key(const char* s, size_t len) {
+		stats->keys++;
+		stats->string_bytes += len;
+		return h.key(s, len);
+	}
+
+	bool start_array() { open(LEPT_ARRAY); return h.start_array(); }
+	bool end_array(size_t size) { close(size, &stats->largest_array); return h.end_array(size); }
+	bool start_object() { open(LEPT_OBJECT); return h.start_object(); }
+	bool end_object(size_t size) { close(size, &stats->largest_object); return h.end_object(size); }
+};
+
+static int lept_parse_root(lept_context* c, lept_value* v, lept_shape_builder* shapes = NULL) {
+	lept_dom_handler h(c, shapes);
+	int ret;
+	lept_init(v);
+	if ((ret = lept_parse_document(c, h)) == LEPT_PARSE_OK)
+		h.pop(v);
+	else
+		h.discard();
+	assert(c->top == 0);	/* the stack is kept for the next parse with this context */
+	return ret;
+}
+
+int lept_parse_sax(const char* json, size_t len, const lept_handler* handler, void* user) {
+	lept_context c;
+	lept_sax_adapter h(handler, user);
+	int ret;
+	assert(handler != NULL && (json != NULL || len == 0));
+	lept_context_init(&c, json, len);
+	ret = lept_parse_document(&c, h);
+	lept_context_free(&c);
+	return ret;
+}
+
+int lept_parse(lept_value* v, const char* json) {
+	assert(json != NULL);
+	return lept_parse_n(v, json, strlen(json));
+}
+
+int lept_parse_n(lept_value* v, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(v != NULL && (json != NULL || len == 0));
+	lept_context_init(&c, json, len);
+	ret = lept_parse_root(&c, v);
+	lept_context_free(&c);
+	return ret;
+}
+
+int lept_parse_ex(lept_value* v, const char* json, lept_parse_stats* stats) {
+	lept_context c;
+	int ret;
+	assert(v != NULL && json != NULL);
+	if (stats == NULL)
+		return lept_parse(v, json);
+	memset(stats, 0, sizeof(lept_parse_stats));
+	lept_context_init(&c, json, strlen(json));
+	lept_dom_handler dom(&c);
+	lept_stats_handler<lept_dom_handler> h(dom, stats);
+	lept_init(v);
+	if ((ret = lept_parse_document(&c, h)) == LEPT_PARSE_OK)
+		dom.pop(v);
+	else
+		dom.discard();
+	stats->bytes = c.json - json;
+	lept_context_free(&c);
+	return ret;
+}
+
+int lept_parse_shaped(lept_value* v, const char* json) {
+	lept_context c;
+	lept_shape_builder shapes;
+	int ret;
+	assert(v != NULL && json != NULL);
+	lept_context_init(&c, json, strlen(json));
+	lept_shape_builder_init(&shapes);
+	ret = lept_parse_root(&c, v, &shapes);
+	lept_shape_builder_free(&shapes);
+	lept_context_free(&c);
+	return ret;
+}
+
+int lept_parse_arena(lept_value* v, const char* json, lept_arena* a) {
+	lept_context c;
+	int ret;
+	assert(v != NULL && json != NULL && a != NULL);
+	lept_context_init(&c, json, strlen(json));
+	c.arena = a;
+	ret = lept_parse_root(&c, v);
+	lept_context_free(&c);
+	return ret;
+}
+
+int lept_parse_insitu(lept_value* v, char* json) {
+	lept_context c;
+	int ret;
+	assert(v != NULL && json != NULL);
+	lept_context_init(&c, json, strlen(json));
+	c.insitu = true;
+	ret = lept_parse_root(&c, v);
+	lept_context_free(&c);
+	return ret;
+}
+
+/* Cuts a kept stack back to keep bytes, it is empty between calls */
+static void lept_context_shrink(lept_context* c, size_t keep) {
+	assert(c->top == 0);
+	if (keep && c->size > keep) {
+		c->stack = (char*)lept_mem_realloc(c->stack, c->size, keep);
+		assert(c->stack != NULL);
+		c->size = keep;
+	}
+}
+
+struct lept_parser {
+	lept_context c;	/* the stack and frames outlive a parse */
+	size_t keep;
+};
+
+lept_parser* lept_parser_create(size_t keep) {
+	lept_parser* p = (lept_parser*)lept_mem_alloc(sizeof(lept_parser));
+	if (!p)
+		return NULL;
+	lept_context_init(&p->c, NULL, 0);
+	p->keep = keep;
+	return p;
+}
+
+void lept_parser_destroy(lept_parser* p) {
+	if (!p)
+		return;
+	lept_context_free(&p->c);
+	lept_mem_free(p, sizeof(lept_parser));
+}
+
+static void lept_parser_begin(lept_parser* p, const char* json, size_t len) {
+	p->c.json = json;
+	p->c.end = json + len;
+	p->c.max_depth = lept_get_max_depth();
+}
+
+int lept_parser_parse(lept_parser* p, lept_value* v, const char* json, size_t len) {
+	int ret;
+	assert(p != NULL && v != NULL && (json != NULL || len == 0));
+	lept_parser_begin(p, json, len);
+	ret = lept_parse_root(&p->c, v);
+	lept_context_shrink(&p->c, p->keep);
+	return ret;
+}
+
+/*
+	The DOM builder of lept_parse_into(), which takes the old value apart in document order: the old
+	value at the place of each new one lends it its storage or is freed. The old containers being
+	taken apart are the frames of a walk (NULL where the old value was not a container of the same
+	type), i is their next element or member. A slot whose value is taken is left a null value.
+*/
+struct lept_reuse_handler {
+	lept_dom_handler dom;
+	lept_value old;	/* the old root until it is taken */
+	lept_walk w;
+
+	lept_reuse_handler(lept_context* c, lept_value* v) : dom(c), old(*v) {
+		lept_init(v);
+		lept_walk_init(&w);
+	}
+
+	~lept_reuse_handler() {
+		lept_value* o;
+		while (w.depth)	/* the parse failed */
+			if ((o = close()) != NULL)
+				lept_free(o);
+		lept_free(&old);
+		lept_walk_free(&w);
+	}
+
+	/* The old value at the place of the next new one, or NULL */
+	lept_value* take() {
+		lept_walk_frame* f;
+		lept_value* o;
+		lept_member* m;
+		if (w.depth == 0)
+			return old.type != LEPT_NULL ? &old : NULL;
+		f = &w.frames[w.depth - 1];
+		if ((o = (lept_value*)f->v) == NULL)
+			return NULL;
+		if (o->type == LEPT_ARRAY)
+			return f->i < o->u.a.size ? &o->u.a.e[f->i++] : NULL;
+		if (f->i == o->u.o.size)
+			return NULL;
+		m = &o->u.o.m[f->i++];
+		if (m->k)	/* NULL once the new key took it */
+			lept_mem_free(m->k, m->klen + 1);
+		return &m->v;
+	}
+
+	void drop() {
+		lept_value* o = take();
+		if (o)
+			lept_free(o);
+	}
+
+	void open(lept_type type) {
+		lept_value* o = take();
+		if (o && (o->type != type || (o->flags & LEPT_FLAG_MASK))) {	/* borrowed, shaped or in-situ storage is not reused */
+			lept_free(o);
+			o = NULL;
+		}
+		lept_walk_push(&w, o);
+	}
+
+	/* Frees what is left of the innermost old container and returns it, emptied, or NULL */
+	lept_value* close() {
+		lept_value* o = (lept_value*)w.frames[w.depth - 1].v, *e;
+		while ((e = take()) != NULL)
+			lept_free(e);
+		w.depth--;
+		if (o && o->type == LEPT_ARRAY)
+			o->u.a.size = 0;
+		else if (o) {
+			o->u.o.size = 0;
+			lept_mem_free(o->u.o.index, 0);
+			o->u.o.index = NULL;
+		}
+		return o;
+	}
+
+	void push_string(char* s, size_t len) {
+		lept_value* v = dom.push();
+		v->type = LEPT_STRING;
+		v->u.s.s = s;
+		v->u.s.len = len;
+	}
+
+	bool null() { drop(); return dom.null(); }
+	bool boolean(bool b) { drop(); return dom.boolean(b); }
+	bool number(double n) { drop(); return dom.number(n); }
+
+	bool string(const char* s, size_t len) {
+		lept_value* o = take();
+		if (o && o->type == LEPT_STRING && !(o->flags & LEPT_FLAG_MASK) && o->u.s.len >= len) {
+			if (len)
+				memcpy(o->u.s.s, s, len);	/* before the push, s is on the stack */
+			o->u.s.s[len] = '\0';
+			push_string(o->u.s.s, len);
+			lept_init(o);
+			return true;
+		}
+		if (o)
+			lept_free(o);
+		return dom.string(s, len);
+	}
+
+	bool key(const char* s, size_t len) {
+		lept_walk_frame* f = &w.frames[w.depth - 1];
+		lept_value* o = (lept_value*)f->v;
+		if (o && f->i < o->u.o.size && o->u.o.m[f->i].klen == len && memcmp(o->u.o.m[f->i].k, s, len) == 0) {
+			push_string(o->u.o.m[f->i].k, len);
+			o->u.o.m[f->i].k = NULL;
+			return true;
+		}
+		return dom.key(s, len);
+	}
+
+	bool start_array() { open(LEPT_ARRAY); return dom.start_array(); }
+	bool start_object() { open(LEPT_OBJECT); return dom.start_object(); }
+
+	bool end_array(size_t size) {
+		lept_value* o = close(), v;
+		if (!o || o->u.a.capacity < size) {
+			if (o)
+				lept_free(o);
+			return dom.end_array(size);
+		}
+		v = *o;
+		v.u.a.size = size;
+		if (size)
+			memcpy(v.u.a.e, lept_context_pop(dom.c, size * sizeof(lept_value)), size * sizeof(lept_value));
+		lept_init(o);
+		*dom.push() = v;
+		return true;
+	}
+
+	bool end_object(size_t size) {
+		lept_value* o = close(), v;
+		const lept_value* kv;
+		size_t i;
+		if (!o || o->u.o.capacity < size) {
+			if (o)
+				lept_free(o);
+			return dom.end_object(size);
+		}
+		v = *o;
+		v.u.o.size = size;
+		kv = (const lept_value*)lept_context_pop(dom.c, 2 * size * sizeof(lept_value));
+		for (i = 0; i < size; i++, kv += 2) {
+			v.u.o.m[i].k = kv[0].u.s.s;
+			v.u.o.m[i].klen = kv[0].u.s.len;
+			v.u.o.m[i].v = kv[1];
+		}
+		lept_init(o);
+		*dom.push() = v;
+		return true;
+	}
+};
+
+int lept_parse_into(lept_parser* p, lept_value* v, const char* json, size_t len) {
+	lept_context local, *c = p ? &p->c : &local;
+	int ret;
+	assert(v != NULL && (json != NULL || len == 0));
+	lept_hash_invalidate(v);	/* the old value is taken apart */
+	if (p)
+		lept_parser_begin(p, json, len);
+	else
+		lept_context_init(&local, json, len);
+	{
+		lept_reuse_handler h(c, v);
+		if ((ret = lept_parse_document(c, h)) == LEPT_PARSE_OK)
+			h.dom.pop(v);
+		else
+			h.dom.discard();
+	}
+	if (p)
+		lept_context_shrink(c, p->keep);
+	else
+		lept_context_free(c);
+	return ret;
+}
+
+/* A read-only view of a whole file, data is "" for an empty file (which cannot be mapped) */
+struct lept_mapping {
+	const char* data;
+	size_t len;
+};
+
+#if defined(_WIN32)
+static bool lept_map_file(lept_mapping* m, const char* path) {
+	HANDLE file, mapping;
+	LARGE_INTEGER size;
+	bool ok = false;
+	file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+	if (file == INVALID_HANDLE_VALUE)
+		return false;
+	if (GetFileSizeEx(file, &size) && (LONGLONG)(size_t)size.QuadPart == size.QuadPart) {
+		m->data = "";
+		m->len = (size_t)size.QuadPart;
+		if (m->len == 0)
+			ok = true;
+		else if ((mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL)) != NULL) {
+			ok = (m->data = (const char*)MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0)) != NULL;
+			CloseHandle(mapping);	// the view keeps the mapping alive
+		}
+	}
+	CloseHandle(file);
+	return ok;
+}
+
+static void lept_unmap_file(lept_mapping* m) {
+	if (m->len)
+		UnmapViewOfFile(m->data);
+}
+#else
+static bool lept_map_file(lept_mapping* m, const char* path) {
+	struct stat st;
+	void* data;
+	int fd;
+	bool ok = false;
+	if ((fd = open(path, O_RDONLY)) < 0)
+		return false;
+	if (fstat(fd, &st) == 0 && (off_t)(size_t)st.st_size == st.st_size) {
+		m->data = "";
+		m->len = (size_t)st.st_size;
+		if (m->len == 0)
+			ok = true;
+		else if ((data = mmap(NULL, m->len, PROT_READ, MAP_PRIVATE, fd, 0)) != MAP_FAILED) {
+			madvise(data, m->len, MADV_SEQUENTIAL);
+			m->data = (const char*)data;
+			ok = true;
+		}
+	}
+	close(fd);	// the mapping stays valid
+	return ok;
+}
+
+static void lept_unmap_file(lept_mapping* m) {
+	if (m->len)
+		munmap((void*)m->data, m->len);
+}
+#endif
+
+int lept_parse_file(lept_value* v, const char* path) {
+	lept_mapping m;
+	int ret;
+	assert(v != NULL && path != NULL);
+	lept_init(v);
+	if (!lept_map_file(&m, path))
+		return LEPT_PARSE_FILE_ERROR;
+	ret = lept_parse_n(v, m.data, m.len);
+	lept_unmap_file(&m);
+	return ret;
+}
+
+/*
+	Threads: a job shares one mutex and condition variable between its workers. Without threads
+	(Windows) the workers run one after the other in the calling thread and the lock is a no-op.
+*/
+#if !defined(_WIN32)
+#define LEPT_THREADS
+#endif
+
+struct lept_sync {
+#ifdef LEPT_THREADS
+	pthread_mutex_t mutex;
+	pthread_cond_t cond;
+#else
+	int unused;
+#endif
+};
+
+static void lept_sync_init(lept_sync* s) {
+#ifdef LEPT_THREADS
+	pthread_mutex_init(&s->mutex, NULL);
+	pthread_cond_init(&s->cond, NULL);
+#else
+	(void)s;
+#endif
+}
+
+static void lept_sync_free(lept_sync* s) {
+#ifdef LEPT_THREADS
+	pthread_cond_destroy(&s->cond);
+	pthread_mutex_destroy(&s->mutex);
+#else
+	(void)s;
+#endif
+}
+
+inline void lept_lock(lept_sync* s) {
+#ifdef LEPT_THREADS
+	pthread_mutex_lock(&s->mutex);
+#else
+	(void)s;
+#endif
+}
+
+inline void lept_unlock(lept_sync* s) {
+#ifdef LEPT_THREADS
+	pthread_mutex_unlock(&s->mutex);
+#else
+	(void)s;
+#endif
+}
+
+/* A lone thread never waits: everything it could wait for is its own work, already done */
+inline void lept_wait(lept_sync* s) {
+#ifdef LEPT_THREADS
+	pthread_cond_wait(&s->cond, &s->mutex);
+#else
+	(void)s;
+	assert(0);
+#endif
+}
+
+inline void lept_broadcast(lept_sync* s) {
+#ifdef LEPT_THREADS
+	pthread_cond_broadcast(&s->cond);
+#else
+	(void)s;
+#endif
+}
+
+static unsigned lept_online_processors() {
+#ifdef LEPT_THREADS
+	long n = sysconf(_SC_NPROCESSORS_ONLN);
+	return n > 0 ? (unsigned)n : 1;
+#else
+	return 1;
+#endif
+}
+
+/* Runs worker(arg) on up to threads threads, the calling thread being one of them, and joins them */
+static void lept_run_workers(unsigned threads, void* (*worker)(void*), void* arg) {
+	lept_select_kernels();	/* before the workers race to do it */
+#ifdef LEPT_THREADS
+	if (threads > 1) {
+		pthread_t* workers = (pthread_t*)lept_mem_alloc((threads - 1) * sizeof(pthread_t));
+		unsigned t;
+		for (t = 0; t < threads - 1; t++)
+			if (pthread_create(workers + t, NULL, worker, arg) != 0)
+				break;	/* go on with the threads there are */
+		worker(arg);
+		while (t > 0)
+			pthread_join(workers[--t], NULL);
+		lept_mem_free(workers, 0);
+		return;
+	}
+#endif
+	(void)threads;
+	worker(arg);
+}
+
+/*
+	NDJSON: the input is cut after newlines into chunks that worker threads take in turn. A worker
+	first counts the lines of its chunk and publishes the count, so the first line number of every
+	chunk is soon known, then parses the lines with its own context (whose stack is reused from line
+	to line) and keeps the results until the chunk is delivered. Chunks are delivered whole, in input
+	order unless unordered delivery is asked for, and one at a time: callbacks are never concurrent.
+	Ordered workers stay at most a few chunks ahead of delivery, which bounds the memory held by
+	results of a slow consumer.
+*/
+const size_t LEPT_NDJSON_CHUNK_SIZE = 1 << 20;
+
+struct lept_ndjson_result {
+	size_t line;	/* 0-based inside the chunk */
+	int status;
+	lept_value v;
+};
+
+struct lept_ndjson_chunk {
+	const char* begin, *end;
+	size_t lines, first_line;	/* first_line is known once every earlier chunk is counted */
+	lept_ndjson_result* results;
+	size_t count, capacity;
+	bool counted, done;
+};
+
+struct lept_ndjson_job {
+	lept_ndjson_chunk* chunks;
+	size_t nchunks;
+	size_t next;	/* next chunk to parse */
+	size_t counted;	/* chunks [0, counted) know their first line */
+	size_t delivered;	/* ordered: chunks [0, delivered) are delivered */
+	size_t ahead;	/* ordered: chunks parsed ahead of delivery */
+	bool unordered, delivering, stop;
+	lept_ndjson_callback callback;
+	void* user;
+	lept_sync sync;
+};
+
+static void lept_ndjson_parse_chunk(lept_context* c, lept_ndjson_chunk* chunk) {
+	const char* p = chunk->begin, *eol, *end;
+	size_t line;
+	for (line = 0; p != chunk->end; line++) {
+		eol = (const char*)memchr(p, '\n', chunk->end - p);
+		end = eol ? eol : chunk->end;
+		if (lept_skip_whitespace(p, end) != end) {	/* blank lines are skipped */
+			lept_ndjson_result* r;
+			if (chunk->count == chunk->capacity) {
+				chunk->capacity += chunk->capacity / 2 + 16;
+				chunk->results = (lept_ndjson_result*)lept_mem_realloc(chunk->results, 0, chunk->capacity * sizeof(lept_ndjson_result));
+			}
+			r = chunk->results + chunk->count++;
+			r->line = line;
+			c->json = p;
+			c->end = end;
+			r->status = lept_parse_root(c, &r->v);
+		}
+		p = eol ? eol + 1 : chunk->end;
+	}
+}
+
+/* Called unlocked by the thread that holds the delivery token, frees the results */
+static bool lept_ndjson_deliver(lept_ndjson_job* job, lept_ndjson_chunk* chunk, bool stop) {
+	size_t i;
+	for (i = 0; i < chunk->count; i++) {
+		lept_ndjson_result* r = chunk->results + i;
+		if (!stop && !job->callback(job->user, chunk->first_line + r->line, r->status, &r->v))
+			stop = true;
+		lept_free(&r->v);
+	}
+	lept_mem_free(chunk->results, 0);
+	chunk->results = NULL;
+	chunk->count = 0;
+	return stop;
+}
+
+static void* lept_ndjson_worker(void* arg) {
+	lept_ndjson_job* job = (lept_ndjson_job*)arg;
+	lept_ndjson_chunk* chunk;
+	lept_context c;
+	const char* p;
+	size_t i;
+	lept_context_init(&c, NULL, 0);
+	lept_lock(&job->sync);
+	for (;;) {
+		while (!job->stop && !job->unordered && job->next < job->nchunks && job->next >= job->delivered + job->ahead)
+			lept_wait(&job->sync);
+		if (job->stop || job->next == job->nchunks)
+			break;
+		chunk = job->chunks + (i = job->next++);
+		lept_unlock(&job->sync);
+
+		for (p = chunk->begin; p != chunk->end && (p = (const char*)memchr(p, '\n', chunk->end - p)) != NULL; p++)
+			chunk->lines++;
+		if (chunk->end > chunk->begin && chunk->end[-1] != '\n')
+			chunk->lines++;	/* the last line of the input has no newline */
+		lept_lock(&job->sync);
+		chunk->counted = true;
+		while (job->counted < job->nchunks && job->chunks[job->counted].counted) {
+			lept_ndjson_chunk* next = job->chunks + job->counted++;
+			if (job->counted < job->nchunks)
+				job->chunks[job->counted].first_line = next->first_line + next->lines;
+		}
+		lept_broadcast(&job->sync);
+		lept_unlock(&job->sync);
+
+		lept_ndjson_parse_chunk(&c, chunk);
+		lept_lock(&job->sync);
+		chunk->done = true;
+		if (job->unordered) {
+			while (job->delivering || job->counted <= i)
+				lept_wait(&job->sync);
+			job->delivering = true;
+			bool stop = job->stop;
+			lept_unlock(&job->sync);
+			stop = lept_ndjson_deliver(job, chunk, stop);
+			lept_lock(&job->sync);
+			job->stop = job->stop || stop;
+			job->delivering = false;
+			lept_broadcast(&job->sync);
+		}
+		else if (!job->delivering) {
+			/* take the token and deliver every finished chunk in order, including those finished meanwhile */
+			job->delivering = true;
+			while (job->delivered < job->nchunks && job->chunks[job->delivered].done) {
+				chunk = job->chunks + job->delivered;
+				bool stop = job->stop;
+				lept_unlock(&job->sync);
+				stop = lept_ndjson_deliver(job, chunk, stop);
+				lept_lock(&job->sync);
+				job->stop = job->stop || stop;
+				job->delivered++;
+				lept_broadcast(&job->sync);
+			}
+			job->delivering = false;
+		}
+	}
+	lept_unlock(&job->sync);
+	lept_context_free(&c);
+	return NULL;
+}
+
+int lept_parse_ndjson(const char* json, size_t len, const lept_ndjson_options* options, lept_ndjson_callback callback, void* user) {
+	lept_ndjson_job job;
+	size_t chunk_size = LEPT_NDJSON_CHUNK_SIZE, capacity = 0, i;
+	unsigned threads = 0;
+	const char* p, *end = json + len;
+	assert((json != NULL || len == 0) && callback != NULL);
+	if (options) {
+		threads = options->threads;
+		if (options->chunk_size)
+			chunk_size = options->chunk_size;
+	}
+	if (threads == 0)
+		threads = lept_online_processors();
+
+	/* chunks end just after a newline, or at the end of the input */
+	memset(&job, 0, sizeof(job));
+	for (p = json; p != end; ) {
+		const char* q = (size_t)(end - p) > chunk_size ? (const char*)memchr(p + chunk_size - 1, '\n', end - (p + chunk_size - 1)) : NULL;
+		q = q ? q + 1 : end;
+		if (job.nchunks == capacity) {
+			capacity += capacity / 2 + 16;
+			job.chunks = (lept_ndjson_chunk*)lept_mem_realloc(job.chunks, 0, capacity * sizeof(lept_ndjson_chunk));
+		}
+		memset(job.chunks + job.nchunks, 0, sizeof(lept_ndjson_chunk));
+		job.chunks[job.nchunks].begin = p;
+		job.chunks[job.nchunks++].end = q;
+		p = q;
+	}
+	if (job.nchunks)
+		job.chunks[0].first_line = 1;
+	if ((size_t)threads > job.nchunks)
+		threads = job.nchunks ? (unsigned)job.nchunks : 1;
+	job.ahead = 2 * (size_t)threads;
+	job.unordered = options && options->unordered;
+	job.callback = callback;
+	job.user = user;
+
+	lept_sync_init(&job.sync);
+	lept_run_workers(threads, lept_ndjson_worker, &job);
+	lept_sync_free(&job.sync);
+
+	for (i = 0; i < job.nchunks; i++)	/* results left undelivered by a stop */
+		lept_ndjson_deliver(&job, job.chunks + i, true);
+	lept_mem_free(job.chunks, 0);
+	return job.stop ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK;
+}
+
+int lept_parse_ndjson_file(const char* path, const lept_ndjson_options* options, lept_ndjson_callback callback, void* user) {
+	lept_mapping m;
+	int ret;
+	assert(path != NULL && callback != NULL);
+	if (!lept_map_file(&m, path))
+		return LEPT_PARSE_FILE_ERROR;
+	ret = lept_parse_ndjson(m.data, m.len, options, callback, user);
+	lept_unmap_file(&m);
+	return ret;
+}
+
+/*
+	Parallel parse of one large array or object, in two stages.
+	Stage 1 classifies the input in 64-byte blocks into bit masks of quotes, backslashes and
+	structural characters. Quotes escaped by an odd run of backslashes are dropped, a prefix xor of
+	the others marks the bytes inside strings, and the structural characters left are walked to track
+	the nesting depth. This finds the end of the root container and the commas between its elements,
+	of which one every LEPT_PARALLEL_RUN_SIZE bytes or so is kept as a split point.
+	Stage 2 parses the runs of elements between split points on several threads, each with its own
+	context, and joins them into the container lept_parse_n() would have built. The ordinary parser
+	checks every run, so a wrong split point can only make a run fail. On any failure, and for input
+	that does not have enough elements to split, the document is parsed again by lept_parse_n(), which
+	gives the exact status.
+*/
+const size_t LEPT_PARALLEL_RUN_SIZE = 64 << 10;	/* smallest run, in input bytes */
+
+struct lept_split_index {
+	size_t root_end;	/* offset of the closing bracket of the root */
+	size_t* splits;	/* offsets of the commas that split the runs */
+	size_t count, capacity;
+};
+
+inline uint64_t lept_prefix_xor(uint64_t x) {	/* bit i: xor of bits [0, i] */
+	x ^= x << 1;
+	x ^= x << 2;
+	x ^= x << 4;
+	x ^= x << 8;
+	x ^= x << 16;
+	x ^= x << 32;
+	return x;
+}
+
+/*
+	Bytes that follow an odd run of backslashes. Adding the start of a run to the run carries
+	just past its end, runs starting on even and odd bits are added separately and the parity of the
+	end bit gives the parity of the run. *carry is 1 when the block ends inside an odd run.
+*/
+inline uint64_t lept_escaped_bytes(uint64_t backslash, uint64_t* carry) {
+	const uint64_t even = LEPT_U64(0x55555555, 0x55555555), odd = ~even;
+	uint64_t starts = backslash & ~(backslash << 1);
+	uint64_t even_start = even ^ *carry;	/* a run carried over starts on an odd bit in effect */
+	uint64_t even_starts = starts & even_start, odd_starts = starts & ~even_start;
+	uint64_t even_carries = backslash + even_starts;
+	uint64_t odd_carries = backslash + odd_starts;
+	bool overflow = odd_carries < backslash;
+	odd_carries |= *carry;
+	*carry = overflow ? 1 : 0;
+	return ((even_carries & ~backslash) & odd) | ((odd_carries & ~backslash) & even);
+}
+
+/* structural: '[', ']', '{', '}' and ',', plus a few bytes (Y _ y DEL) that stage 1 ignores */
+static void lept_classify_block(const char* p, uint64_t* quote, uint64_t* backslash, uint64_t* structural) {
+	uint64_t q = 0, b = 0, s = 0;
+	int i;
+#ifdef LEPT_SSE2
+	const __m128i quotes = _mm_set1_epi8('"'), backslashes = _mm_set1_epi8('\\'), commas = _mm_set1_epi8(',');
+	const __m128i fold = _mm_set1_epi8(0x26), brackets = _mm_set1_epi8(0x7F);	/* [ ] { } | 0x26 == 0x7F */
+	for (i = 0; i < 4; i++) {
+		__m128i x = _mm_loadu_si128((const __m128i*)(p + 16 * i));
+		__m128i t = _mm_or_si128(_mm_cmpeq_epi8(x, commas), _mm_cmpeq_epi8(_mm_or_si128(x, fold), brackets));
+		q |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, quotes)) << (16 * i);
+		b |= (uint64_t)(unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(x, backslashes)) << (16 * i);
+		s |= (uint64_t)(unsigned)_mm_movemask_epi8(t) << (16 * i);
+	}
+#else
+	for (i = 0; i < 64; i++) {
+		char ch = p[i];
+		q |= (uint64_t)(ch == '"') << i;
+		b |= (uint64_t)(ch == '\\') << i;
+		s |= (uint64_t)(ch == ',' || ch == '[' || ch == ']' || ch == '{' || ch == '}') << i;
+	}
+#endif
+	*quote = q;
+	*backslash = b;
+	*structural = s;
+}
+
+/* Stage 1 from the opening bracket of the root at json[0], false if its end is not found */
+static bool lept_split_document(const char* json, size_t len, size_t run, lept_split_index* index) {
+	uint64_t carry = 0, in_string = 0, quote, backslash, structural;
+	size_t off, last = 0, depth = 0;
+	char block[64];
+	const char* p;
+	for (off = 0; off < len; off += 64) {
+		p = json + off;
+		if (len - off < 64) {
+			memset(block, ' ', sizeof(block));
+			memcpy(block, p, len - off);
+			p = block;
+		}
+		lept_classify_block(p, &quote, &backslash, &structural);
+		quote &= ~lept_escaped_bytes(backslash, &carry);
+		in_string = lept_prefix_xor(quote) ^ in_string;
+		structural &= ~in_string;
+		in_string = 0 - (in_string >> 63);	/* all ones if the block ends inside a string */
+		for (; structural; structural &= structural - 1) {
+			unsigned i = lept_ctz64(structural);
+			switch (p[i]) {
+				case '[': case '{':
+					depth++;
+					break;
+				case ']': case '}':
+					if (--depth == 0) {
+						index->root_end = off + i;
+						return true;
+					}
+					break;
+				case ',':
+					if (depth == 1 && off + i - last >= run) {
+						if (index->count == index->capacity) {
+							index->capacity += index->capacity / 2 + 16;
+							index->splits = (size_t*)lept_mem_realloc(index->splits, 0, index->capacity * sizeof(size_t));
+						}
+						index->splits[index->count++] = last = off + i;
+					}
+					break;
+			}
+		}
+	}
+	return false;
+}
+
+/* The elements (or members) of a container between its brackets, cut between two of them */
+template <class Handler>
+static int lept_parse_run(lept_context* c, Handler& h, bool object) {
+	int ret;
+	for (;;) {
+		lept_parse_whitespace(c);
+		if ((ret = object ? lept_parse_member(c, h) : lept_parse_value(c, h)) != LEPT_PARSE_OK)
+			return ret;
+		lept_parse_whitespace(c);
+		if (c->json == c->end)
+			return LEPT_PARSE_OK;
+		if (!PEEK(c, ','))
+			return object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+		c->json++;
+	}
+}
+
+struct lept_parallel_run {
+	const char* begin, *end;
+	lept_value* values;	/* elements, or alternating keys and values */
+	size_t count;
+};
+
+struct lept_parallel_job {
+	lept_parallel_run* runs;
+	size_t nruns, next;
+	bool object, failed;
+	lept_sync sync;
+};
+
+static void* lept_parallel_worker(void* arg) {
+	lept_parallel_job* job = (lept_parallel_job*)arg;
+	lept_parallel_run* run;
+	lept_context c;
+	lept_context_init(&c, NULL, 0);
+	c.max_depth--;	/* the runs are inside the root container */
+	lept_lock(&job->sync);
+	while (!job->failed && job->next < job->nruns) {
+		run = job->runs + job->next++;
+		lept_unlock(&job->sync);
+		lept_dom_handler h(&c);
+		c.json = run->begin;
+		c.end = run->end;
+		bool ok = lept_parse_run(&c, h, job->object) == LEPT_PARSE_OK;
+		if (ok) {
+			run->count = c.top / sizeof(lept_value);
+			run->values = (lept_value*)lept_mem_alloc(c.top);
+			memcpy(run->values, lept_context_pop(&c, c.top), run->count * sizeof(lept_value));
+		}
+		else
+			h.discard();
+		lept_lock(&job->sync);
+		job->failed = job->failed || !ok;
+	}
+	lept_unlock(&job->sync);
+	lept_context_free(&c);
+	return NULL;
+}
+
+int lept_parse_parallel(lept_value* v, const char* json, size_t len, unsigned threads) {
+	lept_split_index index;
+	lept_parallel_job job;
+	const char* root, *end = json + len;
+	size_t run, i, j, size;
+	assert(v != NULL && (json != NULL || len == 0));
+	if (threads == 0)
+		threads = lept_online_processors();
+	root = lept_skip_whitespace(json, end);
+	if (threads < 2 || end - root < 2 * (ptrdiff_t)LEPT_PARALLEL_RUN_SIZE || (*root != '[' && *root != '{'))
+		return lept_parse_n(v, json, len);
+
+	/* stage 1, run is chosen for a few runs per thread */
+	run = (size_t)(end - root) / (4 * (size_t)threads);
+	if (run < LEPT_PARALLEL_RUN_SIZE)
+		run = LEPT_PARALLEL_RUN_SIZE;
+	memset(&index, 0, sizeof(index));
+	if (!lept_split_document(root, end - root, run, &index) || index.count == 0
+		|| root[index.root_end] != *root + 2	/* ']' follows '[' and '}' follows '{' by two */
+		|| lept_skip_whitespace(root + index.root_end + 1, end) != end) {
+		lept_mem_free(index.splits, 0);
+		return lept_parse_n(v, json, len);
+	}
+
+	/* stage 2 */
+	memset(&job, 0, sizeof(job));
+	job.nruns = index.count + 1;
+	job.runs = (lept_parallel_run*)lept_mem_calloc(job.nruns, sizeof(lept_parallel_run));
+	job.object = *root == '{';
+	for (i = 0; i < job.nruns; i++) {
+		job.runs[i].begin = i == 0 ? root + 1 : root + index.splits[i - 1] + 1;
+		job.runs[i].end = i == index.count ? root + index.root_end : root + index.splits[i];
+	}
+	lept_mem_free(index.splits, 0);
+	lept_sync_init(&job.sync);
+	lept_run_workers(threads < job.nruns ? threads : (unsigned)job.nruns, lept_parallel_worker, &job);
+	lept_sync_free(&job.sync);
+
+	lept_init(v);
+	if (job.failed) {
+		for (i = 0; i < job.nruns; i++) {
+			for (j = 0; j < job.runs[i].count; j++)
+				lept_free(&job.runs[i].values[j]);
+			lept_mem_free(job.runs[i].values, 0);
+		}
+		lept_mem_free(job.runs, 0);
+		return lept_parse_n(v, json, len);
+	}
+	for (i = size = 0; i < job.nruns; i++)
+		size += job.runs[i].count;
+	if (job.object) {
+		v->type = LEPT_OBJECT;
+		v->u.o.size = v->u.o.capacity = size /= 2;
+		v->u.o.m = (lept_member*)lept_mem_alloc(size * sizeof(lept_member));
+		v->u.o.index = NULL;
+		for (i = size = 0; i < job.nruns; i++)
+			for (j = 0; j < job.runs[i].count; j += 2, size++) {
+				v->u.o.m[size].k = job.runs[i].values[j].u.s.s;
+				v->u.o.m[size].klen = job.runs[i].values[j].u.s.len;
+				v->u.o.m[size].v = job.runs[i].values[j + 1];
+			}
+	}
+	else {
+		v->type = LEPT_ARRAY;
+		v->u.a.size = v->u.a.capacity = size;
+		v->u.a.hash = NULL;
+		v->u.a.e = (lept_value*)lept_mem_alloc(size * sizeof(lept_value));
+		for (i = size = 0; i < job.nruns; size += job.runs[i++].count)
+			memcpy(v->u.a.e + size, job.runs[i].values, job.runs[i].count * sizeof(lept_value));
+	}
+	for (i = 0; i < job.nruns; i++)
+		lept_mem_free(job.runs[i].values, 0);
+	lept_mem_free(job.runs, 0);
+	return LEPT_PARSE_OK;
+}
+
+/*
+	Push parser: the same grammar as lept_parse_value(), driven by an explicit state machine so that
+	it can stop at the end of any chunk. Frames of the open containers and their finished elements
+	live on the context stack (a frame is followed by its values, keys are string values in between)
+	and the DOM handler builds the containers from them. A string, number or literal that is cut by
+	the end of a chunk is carried over in a side buffer and handed to the ordinary token parsers once
+	its end is known.
+*/
+enum lept_push_state {
+	LEPT_PUSH_VALUE,	/* expecting a value */
+	LEPT_PUSH_ARRAY_FIRST,	/* after '[': a value or ']' */
+	LEPT_PUSH_OBJECT_FIRST,	/* after '{': a key or '}' */
+	LEPT_PUSH_KEY,	/* after ',' in an object */
+	LEPT_PUSH_COLON,
+	LEPT_PUSH_AFTER_VALUE,	/* ',' or the closing bracket of the innermost container */
+	LEPT_PUSH_DONE,	/* the root value is complete, only whitespace may follow */
+	LEPT_PUSH_STRING,	/* carrying a string (or a key) over chunks */
+	LEPT_PUSH_NUMBER,	/* carrying a number */
+	LEPT_PUSH_LITERAL	/* carrying null/true/false */
+};
+
+const size_t LEPT_PUSH_NO_FRAME = (size_t)-1;
+
+struct lept_push_frame {
+	size_t prev;	/* stack offset of the enclosing frame */
+	size_t size;	/* finished elements or members above the frame */
+	lept_type type;	/* LEPT_ARRAY or LEPT_OBJECT */
+	bool key;	/* a member with a key but no value yet is on top of the elements */
+};
+
+struct lept_push_parser {
+	lept_context c;
+	size_t frame;	/* stack offset of the innermost frame */
+	size_t depth;	/* open containers, at most c.max_depth */
+	int state, status;
+	lept_value root;
+	char* carry;	/* bytes of a token cut by the end of a chunk */
+	size_t carry_len, carry_size;
+	bool carry_key;	/* the carried string is a member key */
+	bool escaped;	/* the carried string ends with a pending backslash */
+};
+
+inline bool ISNUMBERCHAR(char ch) {
+	return ISDIGIT(ch) || ch == '-' || ch == '+' || ch == '.' || ch == 'e' || ch == 'E';
+}
+
+inline lept_push_frame* lept_push_top(lept_push_parser* p) {
+	return (lept_push_frame*)(p->c.stack + p->frame);
+}
+
+static void lept_push_reset(lept_push_parser* p) {
+	/* Pop and free whatever was built so far */
+	while (p->frame != LEPT_PUSH_NO_FRAME) {
+		lept_push_frame f = *lept_push_top(p);
+		size_t i, n = f.type == LEPT_ARRAY ? f.size : 2 * f.size + (f.key ? 1 : 0);
+		for (i = 0; i < n; i++)
+			lept_free((lept_value*)lept_context_pop(&p->c, sizeof(lept_value)));
+		lept_context_pop(&p->c, sizeof(lept_push_frame));
+		p->frame = f.prev;
+	}
+	assert(p->c.top == 0);
+	p->depth = 0;
+	lept_free(&p->root);
+	p->state = LEPT_PUSH_VALUE;
+	p->status = LEPT_PARSE_OK;
+	p->carry_len = 0;
+	p->escaped = false;
+}
+
+static void lept_push_error(lept_push_parser* p, int status) {
+	lept_push_reset(p);
+	p->status = status;
+}
+
+lept_push_parser* lept_push_parser_create() {
+	lept_push_parser* p = (lept_push_parser*)lept_mem_alloc(sizeof(lept_push_parser));
+	if (!p)
+		return NULL;
+	lept_context_init(&p->c, NULL, 0);
+	lept_init(&p->root);
+	p->frame = LEPT_PUSH_NO_FRAME;
+	p->carry = NULL;
+	p->carry_size = 0;
+	lept_push_reset(p);
+	return p;
+}
+
+void lept_push_parser_destroy(lept_push_parser* p) {
+	if (!p)
+		return;
+	lept_push_reset(p);
+	lept_context_free(&p->c);
+	lept_mem_free(p->carry, 0);
+	lept_mem_free(p, 0);
+}
+
+static void lept_push_append(lept_push_parser* p, const char* s, size_t len) {
+	if (p->carry_len + len > p->carry_size) {
+		size_t size = p->carry_size ? p->carry_size : LEPT_PARSE_STACK_INIT_SIZE;
+		while (p->carry_len + len > size)
+			size += size >> 1;
+		p->carry = (char*)lept_mem_realloc(p->carry, 0, size);
+		p->carry_size = size;
+	}
+	memcpy(p->carry + p->carry_len, s, len);
+	p->carry_len += len;
+}
+
+static void lept_push_open(lept_push_parser* p, lept_type type) {
+	size_t offset = p->c.top;
+	lept_push_frame* f;
+	if (p->depth == p->c.max_depth) {
+		lept_push_error(p, LEPT_PARSE_TOO_DEEP);
+		return;
+	}
+	p->depth++;
+	f = (lept_push_frame*)lept_context_push(&p->c, sizeof(lept_push_frame));
+	f->prev = p->frame;
+	f->size = 0;
+	f->type = type;
+	f->key = false;
+	p->frame = offset;
+	p->state = type == LEPT_ARRAY ? LEPT_PUSH_ARRAY_FIRST : LEPT_PUSH_OBJECT_FIRST;
+}
+
+/* A value is complete: it becomes the root, the next element or the value of the pending member */
+static void lept_push_emit(lept_push_parser* p, const lept_value* v) {
+	lept_push_frame* f;
+	if (p->frame == LEPT_PUSH_NO_FRAME) {
+		p->root = *v;
+		p->state = LEPT_PUSH_DONE;
+		return;
+	}
+	memcpy(lept_context_push(&p->c, sizeof(lept_value)), v, sizeof(lept_value));
+	f = lept_push_top(p);
+	assert(f->type == LEPT_ARRAY || f->key);
+	f->key = false;
+	f->size++;
+	p->state = LEPT_PUSH_AFTER_VALUE;
+}
+
+static void lept_push_close(lept_push_parser* p) {
+	lept_push_frame f = *lept_push_top(p);
+	lept_dom_handler h(&p->c);
+	lept_value v;
+	if (f.type == LEPT_ARRAY)
+		h.end_array(f.size);
+	else
+		h.end_object(f.size);
+	memcpy(&v, lept_context_pop(&p->c, sizeof(lept_value)), sizeof(lept_value));
+	lept_context_pop(&p->c, sizeof(lept_push_frame));
+	p->frame = f.prev;
+	p->depth--;
+	lept_push_emit(p, &v);
+}
+
+/* Parses a complete token in [s, end) and returns where the token parser stopped */
+static const char* lept_push_token(lept_push_parser* p, const char* s, const char* end, bool key) {
+	int ret;
+	p->c.json = s;
+	p->c.end = end;
+	lept_dom_handler h(&p->c);
+	if (key) {
+		char* str;
+		size_t len;
+		if ((ret = lept_parse_string_raw(&p->c, &str, &len)) == LEPT_PARSE_OK) {
+			h.key(str, len);
+			lept_push_top(p)->key = true;
+			p->state = LEPT_PUSH_COLON;
+		}
+	}
+	else if ((ret = lept_parse_value(&p->c, h)) == LEPT_PARSE_OK) {
+		lept_value v;
+		h.pop(&v);
+		lept_push_emit(p, &v);
+	}
+	if (ret != LEPT_PARSE_OK)
+		lept_push_error(p, ret);
+	return p->c.json;
+}
+
+static const char* lept_push_run(lept_push_parser* p, const char* s, const char* end);
+
+/* The carried token is complete (or the input has ended): parse it from the carry buffer */
+static void lept_push_carried(lept_push_parser* p) {
+	const char* carry_end = p->carry + p->carry_len;
+	const char* s = lept_push_token(p, p->carry, carry_end, p->state == LEPT_PUSH_STRING && p->carry_key);
+	if (p->status == LEPT_PARSE_OK && s != carry_end)
+		lept_push_run(p, s, carry_end);	// a number followed by number characters: this is an error
+	p->carry_len = 0;
+}
+
+/* Finds the end of the token starting at s; a token that runs into the end of the chunk is carried */
+static const char* lept_push_start_token(lept_push_parser* p, const char* s, const char* end, int state, bool key) {
+	const char* q = s + 1;
+	switch (state) {
+		case LEPT_PUSH_STRING:
+			for (;;) {
+				q = lept_scan_string(q, end);
+				if (q == end)
+					break;
+				if (*q != '\\')	// a closing quotation mark, or a control character the string parser rejects
+					return lept_push_token(p, s, q + 1, key);
+				if (++q == end) {
+					p->escaped = true;
+					break;
+				}
+				q++;
+			}
+			break;
+		case LEPT_PUSH_NUMBER:
+			while (q != end && ISNUMBERCHAR(*q))
+				q++;
+			if (q != end)
+				return lept_push_token(p, s, q, key);
+			break;
+		default: {
+			size_t n = *s == 'f' ? 5 : 4;
+			if ((size_t)(end - s) >= n)
+				return lept_push_token(p, s, s + n, key);
+			q = end;
+		}
+	}
+	p->state = state;
+	p->carry_key = key;
+	lept_push_append(p, s, end - s);
+	return end;
+}
+
+static const char* lept_push_continue_token(lept_push_parser* p, const char* s, const char* end) {
+	const char* q = s;
+	switch (p->state) {
+		case LEPT_PUSH_STRING:
+			for (;;) {
+				if (p->escaped) {
+					if (q == end)
+						break;
+					p->escaped = false;
+					q++;
+				}
+				q = lept_scan_string(q, end);
+				if (q == end)
+					break;
+				if (*q++ != '\\') {
+					lept_push_append(p, s, q - s);
+					lept_push_carried(p);
+					return q;
+				}
+				p->escaped = true;
+			}
+			break;
+		case LEPT_PUSH_NUMBER:
+			while (q != end && ISNUMBERCHAR(*q))
+				q++;
+			if (q != end) {
+				lept_push_append(p, s, q - s);
+				lept_push_carried(p);
+				return q;
+			}
+			break;
+		default: {
+			size_t n = (p->carry[0] == 'f' ? 5 : 4) - p->carry_len;
+			if ((size_t)(end - s) >= n) {
+				lept_push_append(p, s, n);
+				lept_push_carried(p);
+				return s + n;
+			}
+		}
+	}
+	lept_push_append(p, s, end - s);
+	return end;
+}
+
+static const char* lept_push_run(lept_push_parser* p, const char* s, const char* end) {
+	while (s != end && p->status == LEPT_PARSE_OK) {
+		if (p->state >= LEPT_PUSH_STRING) {
+			s = lept_push_continue_token(p, s, end);
+			continue;
+		}
+		if ((s = lept_skip_whitespace(s, end)) == end)
+			break;
+		switch (p->state) {
+			case LEPT_PUSH_ARRAY_FIRST:
+				if (*s == ']') {
+					lept_push_close(p);
+					s++;
+					break;
+				}
+				/* fall through */
+			case LEPT_PUSH_VALUE:
+				switch (*s) {
+					case '[': lept_push_open(p, LEPT_ARRAY); s++; break;
+					case '{': lept_push_open(p, LEPT_OBJECT); s++; break;
+					case '"': s = lept_push_start_token(p, s, end, LEPT_PUSH_STRING, false); break;
+					case 'n': case 't': case 'f': s = lept_push_start_token(p, s, end, LEPT_PUSH_LITERAL, false); break;
+					default: s = lept_push_start_token(p, s, end, LEPT_PUSH_NUMBER, false); break;
+				}
+				break;
+			case LEPT_PUSH_OBJECT_FIRST:
+				if (*s == '}') {
+					lept_push_close(p);
+					s++;
+					break;
+				}
+				/* fall through */
+			case LEPT_PUSH_KEY:
+				if (*s != '"')
+					lept_push_error(p, LEPT_PARSE_MISS_KEY);
+				else
+					s = lept_push_start_token(p, s, end, LEPT_PUSH_STRING, true);
+				break;
+			case LEPT_PUSH_COLON:
+				if (*s != ':')
+					lept_push_error(p, LEPT_PARSE_MISS_COLON);
+				else {
+					p->state = LEPT_PUSH_VALUE;
+					s++;
+				}
+				break;
+			case LEPT_PUSH_AFTER_VALUE: {
+				bool array = lept_push_top(p)->type == LEPT_ARRAY;
+				if (*s == ',') {
+					p->state = array ? LEPT_PUSH_VALUE : LEPT_PUSH_KEY;
+					s++;
+				}
+				else if (*s == (array ? ']' : '}')) {
+					lept_push_close(p);
+					s++;
+				}
+				else
+					lept_push_error(p, array ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET);
+				break;
+			}
+			default:
+				assert(p->state == LEPT_PUSH_DONE);
+				lept_push_error(p, LEPT_PARSE_ROOT_NOT_SINGULAR);
+		}
+	}
+	return s;
+}
+
+int lept_push_parser_feed(lept_push_parser* p, const char* chunk, size_t len) {
+	assert(p != NULL && (chunk != NULL || len == 0));
+	if (p->status == LEPT_PARSE_OK)
+		lept_push_run(p, chunk, chunk + len);
+	return p->status;
+}
+
+int lept_push_parser_finish(lept_push_parser* p, lept_value* v) {
+	int ret;
+	assert(p != NULL && v != NULL);
+	lept_init(v);
+	if (p->status == LEPT_PARSE_OK && p->state >= LEPT_PUSH_STRING)
+		lept_push_carried(p);	// the end of the input also ends the carried token
+	if (p->status == LEPT_PARSE_OK) {
+		switch (p->state) {
+			case LEPT_PUSH_VALUE:
+			case LEPT_PUSH_ARRAY_FIRST: p->status = LEPT_PARSE_EXPECT_VALUE; break;
+			case LEPT_PUSH_OBJECT_FIRST:
+			case LEPT_PUSH_KEY: p->status = LEPT_PARSE_MISS_KEY; break;
+			case LEPT_PUSH_COLON: p->status = LEPT_PARSE_MISS_COLON; break;
+			case LEPT_PUSH_AFTER_VALUE:
+				p->status = lept_push_top(p)->type == LEPT_ARRAY ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+				break;
+			default:
+				assert(p->state == LEPT_PUSH_DONE);
+				*v = p->root;
+				lept_init(&p->root);
+		}
+	}
+	ret = p->status;
+	lept_push_reset(p);	// ready for the next document
+	return ret;
+}
+
+/*
+	Double to decimal: the shortest digits that parse back to the same double (Schubfach, with
+	the ceiling of the power-of-ten table above), laid out like printf("%.17g").
+*/
+inline uint64_t lept_round_to_odd(uint64_t g_hi, uint64_t g_lo, uint64_t cp) {	// floor(g * cp / 2^128), sticky
+	uint64_t x_hi, y_hi, y_lo, z_hi, z_lo;
+	lept_mul128(g_lo, cp, &x_hi);
+	y_lo = lept_mul128(g_hi, cp, &y_hi);
+	z_lo = y_lo + x_hi;
+	z_hi = y_hi + (z_lo < y_lo);
+	return z_hi | (z_lo > 1);
+}
+
+/* The shortest digits * 10^exponent of the positive finite double with these bits */
+static uint64_t lept_shortest_decimal(uint64_t bits, int* exponent) {
+	uint64_t fraction = bits & LEPT_U64(0x000FFFFF, 0xFFFFFFFF), c, g_hi, g_lo, vbl, vb, vbr, lower, upper, s, sp;
+	int e = (int)(bits >> 52), q, k, h;
+	bool even, closer = fraction == 0 && e > 1, u_inside, w_inside;
+	const uint64_t* pow;
+	if (e) {
+		c = fraction | ((uint64_t)1 << 52);
+		q = e - 1075;
+		if (q <= 0 && q > -53 && !(c & (((uint64_t)1 << -q) - 1))) {	/* an integer below 2^53 */
+			*exponent = 0;
+			return c >> -q;
+		}
+	}
+	else {
+		c = fraction;
+		q = -1074;
+	}
+	even = !(c & 1);
+	k = (q * 1262611 - (closer ? 524031 : 0)) >> 22;	/* floor(log10(2^q)), or of 3/4 2^q */
+	h = q + ((-k * 1741647) >> 19) + 1;	/* q + floor(log2(10^-k)) + 1, in [1, 4] */
+	pow = lept_pow10_128[-k - LEPT_POW10_MIN];
+	g_hi = pow[0];
+	g_lo = pow[1];
+	if (-k < 0 || -k > 55) {	/* the table is truncated, the exact powers 5^0..5^55 fit */
+		if (++g_lo == 0)
+			g_hi++;
+	}
+	vbl = lept_round_to_odd(g_hi, g_lo, (4 * c - 2 + closer) << h);
+	vb = lept_round_to_odd(g_hi, g_lo, (4 * c) << h);
+	vbr = lept_round_to_odd(g_hi, g_lo, (4 * c + 2) << h);
+	lower = vbl + !even;
+	upper = vbr - !even;
+	s = vb / 4;
+	if (s >= 10) {	/* one digit less, if exactly one of its neighbours is inside the interval */
+		sp = s / 10;
+		u_inside = lower <= 40 * sp;
+		w_inside = 40 * sp + 40 <= upper;
+		if (u_inside != w_inside) {
+			*exponent = k + 1;
+			return sp + w_inside;
+		}
+	}
+	u_inside = lower <= 4 * s;
+	w_inside = 4 * s + 4 <= upper;
+	*exponent = k;
+	if (u_inside != w_inside)
+		return s + w_inside;
+	return s + (vb > 4 * s + 2 || (vb == 4 * s + 2 && (s & 1)));	/* the closer one, ties to even */
+}
+
+/* Writes at most 25 characters, no terminator, returns the length */
+static int lept_format_double(char* buf, double d) {
+	char buf_digits[20], *digits = buf_digits + sizeof(buf_digits), *p = buf;
+	uint64_t bits, m;
+	int n = 0, k, x, i;
+	memcpy(&bits, &d, sizeof(double));
+	if ((bits >> 52 & 0x7FF) == 0x7FF)
+		return sprintf(buf, "%.17g", d);	/* not JSON anyway */
+	if (bits >> 63)
+		*p++ = '-';
+	bits &= LEPT_U64(0x7FFFFFFF, 0xFFFFFFFF);
+	if (bits == 0) {
+		*p++ = '0';
+		return (int)(p - buf);
+	}
+	for (m = lept_shortest_decimal(bits, &k); m % 10 == 0; m /= 10)
+		k++;
+	do {
+		*--digits = (char)('0' + m % 10);
+		n++;
+	} while (m /= 10);
+	x = n + k - 1;	/* the exponent of the first digit */
+	if (x >= -4 && x < 17) {
+		if (x < 0) {	/* 0.000ddd */
+			*p++ = '0';
+			*p++ = '.';
+			for (i = x; ++i < 0; )
+				*p++ = '0';
+			memcpy(p, digits, n);
+			p += n;
+		}
+		else if (x >= n - 1) {	/* ddd000 */
+			memcpy(p, digits, n);
+			p += n;
+			for (i = x - n + 1; i > 0; i--)
+				*p++ = '0';
+		}
+		else {	/* dd.ddd */
+			memcpy(p, digits, x + 1);
+			p += x + 1;
+			*p++ = '.';
+			memcpy(p, digits + x + 1, n - x - 1);
+			p += n - x - 1;
+		}
+		return (int)(p - buf);
+	}
+	*p++ = digits[0];	/* d.ddde+xx */
+	if (n > 1) {
+		*p++ = '.';
+		memcpy(p, digits + 1, n - 1);
+		p += n - 1;
+	}
+	*p++ = 'e';
+	*p++ = x < 0 ? '-' : '+';
+	if (x < 0)
+		x = -x;
+	if (x >= 100)
+		*p++ = (char)('0' + x / 100);
+	*p++ = (char)('0' + x / 10 % 10);
+	*p++ = (char)('0' + x % 10);
+	return (int)(p - buf);
+}
+
+static void lept_stringify_flush(lept_context* c) {
+	assert(c->sink != NULL);
+	if (c->top && !c->sink_failed && !c->sink->write(c->sink->user, c->stack, c->top))
+		c->sink_failed = true;	/* the rest of the output is dropped */
+	c->top = 0;
+}
+
+/* Called between pieces of bounded size, so that a sink never needs more than a fixed buffer */
+inline void lept_stringify_check(lept_context* c) {
+	if (c->sink && c->top >= LEPT_STRINGIFY_FLUSH_SIZE)
+		lept_stringify_flush(c);
+}
+
+/* Writes the escape of a '"', '\\' or control character, returns the end */
+static char* lept_escape_char(char* p, unsigned char ch) {
+	static const char hex_digits[] = { '0', '1', '2', '3', '4', '5', '6', '7', '8', '9', 'A', 'B', 'C', 'D', 'E', 'F' };
+	*p++ = '\\';
+	switch (ch) {
+		case '\"': *p++ = '\"'; break;
+		case '\\': *p++ = '\\'; break;
+		case '\b': *p++ = 'b';  break;
+		case '\f': *p++ = 'f';  break;
+		case '\n': *p++ = 'n';  break;
+		case '\r': *p++ = 'r';  break;
+		case '\t': *p++ = 't';  break;
+		default:
+			*p++ = 'u'; *p++ = '0'; *p++ = '0';
+			*p++ = hex_digits[ch >> 4];
+			*p++ = hex_digits[ch & 15];
+	}
+	return p;
+}
+
+/*
+	A string is escaped in chunks: a first pass counts the bytes to escape to reserve their room,
+	a second copies 16-byte blocks and stops only at '"', '\\' and control characters.
+*/
+static size_t lept_escaped_size(const char* s, const char* end) {	// An upper bound
+	size_t size = end - s;
+#ifdef LEPT_SSE2
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+	for (; end - s >= 16; s += 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)s);
+		unsigned escaped = (unsigned)_mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)));
+		unsigned control = (unsigned)_mm_movemask_epi8(_mm_cmpeq_epi8(_mm_max_epu8(x, ctrl), ctrl));
+		size += lept_popcount(escaped) + 5 * lept_popcount(control);
+	}
+#endif
+	for (; s != end; s++)
+		if (ISSTRINGSTOP(*s))
+			size += (unsigned char)*s < 0x20 ? 5 : 1;
+	return size;
+}
+
+static char* lept_escape(char* p, const char* s, const char* end) {	// p has lept_escaped_size() + 16 bytes
+#ifdef LEPT_SSE2
+	const __m128i quote = _mm_set1_epi8('"'), backslash = _mm_set1_epi8('\\'), ctrl = _mm_set1_epi8(0x1F);
+	while (end - s >= 16) {
+		__m128i x = _mm_loadu_si128((const __m128i*)s);
+		__m128i stop = _mm_or_si128(_mm_or_si128(_mm_cmpeq_epi8(x, quote), _mm_cmpeq_epi8(x, backslash)),
+			_mm_cmpeq_epi8(_mm_max_epu8(x, ctrl), ctrl));
+		unsigned mask = (unsigned)_mm_movemask_epi8(stop), n;
+		_mm_storeu_si128((__m128i*)p, x);	/* the bytes after a stop are rewritten below */
+		if (!mask) {
+			s += 16;
+			p += 16;
+			continue;
+		}
+		n = lept_ctz(mask);
+		p = lept_escape_char(p + n, (unsigned char)s[n]);
+		s += n + 1;
+	}
+#endif
+	for (; s != end; s++) {
+		if (ISSTRINGSTOP(*s))
+			p = lept_escape_char(p, (unsigned char)*s);
+		else
+			*p++ = *s;
+	}
+	return p;
+}
+
+static void lept_stringify_string(lept_context* c, const char* s, size_t len) {
+	const char* end = s + len, *chunk;
+	size_t size;
+	char* head;
+	assert(s != NULL);
+	PUTC(c, '"');
+	for (; s != end; s = chunk) {
+		chunk = (size_t)(end - s) < LEPT_STRINGIFY_STRING_CHUNK ? end : s + LEPT_STRINGIFY_STRING_CHUNK;
+		lept_stringify_check(c);
+		head = (char*)lept_context_push(c, size = lept_escaped_size(s, chunk) + 16);
+		c->top -= size - (lept_escape(head, s, chunk) - head);
+	}
+	PUTC(c, '"');
+}
+
+static void lept_stringify_value(lept_context* c, const lept_value* v) {
+	lept_walk w;
+	lept_walk_frame* f;
+	lept_walk_init(&w);
+	for (;;) {
+		lept_stringify_check(c);
+		switch (v->type) {
+			case LEPT_NULL:		PUTS(c, "null", 4); break;
+			case LEPT_FALSE:	PUTS(c, "false", 5); break;
+			case LEPT_TRUE:		PUTS(c, "true", 4); break;
+			case LEPT_NUMBER:	c->top -= 32 - lept_format_double((char *)lept_context_push(c, 32), v->u.n); break;
+			case LEPT_STRING:	lept_stringify_string(c, v->u.s.s, v->u.s.len); break;
+			case LEPT_ARRAY:	PUTC(c, '['); lept_walk_push(&w, v); break;
+			case LEPT_OBJECT:	PUTC(c, '{'); lept_walk_push(&w, v); break;
+			default: assert(0 && "invalid type");
+		}
+		/* the next element or member, after closing the containers that are done */
+		for (v = NULL; v == NULL; ) {
+			if (w.depth == 0) {
+				lept_walk_free(&w);
+				return;
+			}
+			f = &w.frames[w.depth - 1];
+			if (f->v->type == LEPT_ARRAY ? f->i == f->v->u.a.size : f->i == lept_get_object_size(f->v)) {
+				lept_stringify_check(c);
+				PUTC(c, f->v->type == LEPT_ARRAY ? ']' : '}');
+				w.depth--;
+				continue;
+			}
+			if (f->i > 0)
+				PUTC(c, ',');
+			if (f->v->type == LEPT_ARRAY)
+				v = &f->v->u.a.e[f->i++];
+			else {
+				lept_stringify_string(c, lept_get_object_key(f->v, f->i), lept_get_object_key_length(f->v, f->i));
+				PUTC(c, ':');
+				v = lept_get_object_value(f->v, f->i++);
+			}
+		}
+	}
+}
+
+int lept_stringify_to(const lept_value* v, const lept_sink* sink) {
+	lept_context c;
+	assert(v != NULL && sink != NULL && sink->write != NULL);
+	lept_context_init(&c, NULL, 0);
+	c.sink = sink;
+	/* the last check before a flush may be followed by one string chunk or a few short tokens */
+	c.stack = (char*)lept_mem_alloc(c.size = LEPT_STRINGIFY_FLUSH_SIZE + LEPT_STRINGIFY_STRING_CHUNK * 6 + 256);
+	lept_count_stack(c.size);
+	lept_stringify_value(&c, v);
+	lept_stringify_flush(&c);
+	lept_context_free(&c);
+	return c.sink_failed ? LEPT_STRINGIFY_SINK_ERROR : LEPT_STRINGIFY_OK;
+}
+
+/* The same writer without a sink: the output grows on the stack and becomes the returned string */
+char* lept_stringify(const lept_value* v, size_t* length) {
+	lept_context c;
+	assert(v != NULL);
+	lept_context_init(&c, NULL, 0);
+	c.stack = (char*)lept_mem_alloc(c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
+	lept_count_stack(c.size);
+	lept_stringify_value(&c, v);
+	if (length)
+		*length = c.top;
+	PUTC(&c, '\0');
+	return c.stack;
+}
+
+struct lept_writer {
+	lept_context c;	/* the output of the last call stays on the stack */
+	size_t keep;
+};
+
+lept_writer* lept_writer_create(size_t keep) {
+	lept_writer* w = (lept_writer*)lept_mem_alloc(sizeof(lept_writer));
+	if (!w)
+		return NULL;
+	lept_context_init(&w->c, NULL, 0);
+	w->keep = keep;
+	return w;
+}
+
+void lept_writer_destroy(lept_writer* w) {
+	if (!w)
+		return;
+	lept_context_free(&w->c);
+	lept_mem_free(w, sizeof(lept_writer));
+}
+
+const char* lept_writer_stringify(lept_writer* w, const lept_value* v, size_t* length) {
+	assert(w != NULL && v != NULL);
+	w->c.top = 0;	/* the last output is done with now */
+	lept_context_shrink(&w->c, w->keep);
+	if (!w->c.stack) {
+		w->c.stack = (char*)lept_mem_alloc(w->c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
+		lept_count_stack(w->c.size);
+	}
+	lept_stringify_value(&w->c, v);
+	if (length)
+		*length = w->c.top;
+	PUTC(&w->c, '\0');
+	return w->c.stack;
+}
+
+static bool lept_write_file(void* user, const char* data, size_t len) {
+	return fwrite(data, 1, len, (FILE*)user) == len;
+}
+
+static bool lept_write_fd(void* user, const char* data, size_t len) {
+	int fd = (int)(intptr_t)user;
+	while (len) {
+#if defined(_WIN32)
+		int n = _write(fd, data, (unsigned)(len < 0x40000000 ? len : 0x40000000));
+#else
+		ssize_t n = write(fd, data, len);
+		if (n < 0 && errno == EINTR)
+			continue;
+#endif
+		if (n <= 0)
+			return false;
+		data += n;
+		len -= (size_t)n;
+	}
+	return true;
+}
+
+lept_sink lept_sink_file(FILE* fp) {
+	lept_sink sink;
+	assert(fp != NULL);
+	sink.write = lept_write_file;
+	sink.user = fp;
+	return sink;
+}
+
+lept_sink lept_sink_fd(int fd) {
+	lept_sink sink;
+	sink.write = lept_write_fd;
+	sink.user = (void*)(intptr_t)fd;
+	return sink;
+}
+
+lept_type lept_get_type(const lept_value* v) {
+	assert(v != NULL);
+	return v->type;
+}
+
+void lept_set_null(lept_value* v) {
+	assert(v != NULL);
+	lept_free(v);
+}
+
+bool lept_get_boolean(const lept_value* v) {
+	assert(v != NULL && (v->type == LEPT_TRUE || v->type == LEPT_FALSE));
+	return v->type == LEPT_TRUE;
+}
+
+void lept_set_boolean(lept_value* v, bool b) {
+	lept_free(v);
+	v->type = b ? LEPT_TRUE : LEPT_FALSE;
+}
+
+double lept_get_number(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_NUMBER);
+	return v->u.n;
+}
+
+void lept_set_number(lept_value* v, double n) {
+	lept_free(v);
+	v->type = LEPT_NUMBER;
+	v->u.n = n;
+}
+
+const char* lept_get_string(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_STRING);
+	return v->u.s.s;
+}
+
+size_t lept_get_string_length(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_STRING);
+	return v->u.s.len;
+}
+
+void lept_set_string(lept_value* v, const char* s, size_t len) {
+	assert(v != NULL && (s != NULL || len == 0));
+	lept_free(v);
+	v->type = LEPT_STRING;
+	v->u.s.s = (char*)lept_mem_alloc(len + 1);
+	memcpy(v->u.s.s, s, len);	// 滻memcpy_s?
+	v->u.s.s[len] = '\0';
+	v->u.s.len = len;
+}
+
+size_t lept_get_array_size(const lept_value* v)
+{
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	return v->u.a.size;
+}
+
+lept_value* lept_get_array_element(const lept_value* v, size_t index)
+{
+	assert(v != NULL&&v->type == LEPT_ARRAY);
+	assert(index < v->u.a.size);
+	return &v->u.a.e[index];
+}
+
+void lept_set_array(lept_value* v, size_t capacity) {
+	assert(v != NULL);
+	lept_free(v);
+	v->type = LEPT_ARRAY;
+	v->u.a.size = 0;
+	v->u.a.capacity = capacity;
+	v->u.a.hash = NULL;
+	v->u.a.e = capacity ? (lept_value*)lept_mem_alloc(capacity * sizeof(lept_value)) : NULL;
+}
+
+size_t lept_get_array_capacity(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	return v->u.a.capacity;
+}
+
+/* Moves the elements to a buffer of its own with this capacity */
+static void lept_array_resize(lept_value* v, size_t capacity) {
+	lept_value* e = v->u.a.e;
+	assert(capacity >= v->u.a.size);
+	if (v->flags & LEPT_FLAG_BORROWED) {	/* the elements stay in the arena */
+		v->u.a.e = capacity ? (lept_value*)lept_mem_alloc(capacity * sizeof(lept_value)) : NULL;
+		if (v->u.a.size)
+			memcpy(v->u.a.e, e, v->u.a.size * sizeof(lept_value));
+		v->flags &= ~LEPT_FLAG_BORROWED;
+	}
+	else if (capacity)
+		v->u.a.e = (lept_value*)lept_mem_realloc(e, v->u.a.capacity * sizeof(lept_value), capacity * sizeof(lept_value));
+	else {
+		lept_mem_free(e, 0);
+		v->u.a.e = NULL;
+	}
+	v->u.a.capacity = capacity;
+}
+
+/* Room for size elements, in a buffer of its own */
+static void lept_array_reserve(lept_value* v, size_t size) {
+	size_t capacity = v->u.a.capacity;
+	if (size > capacity) {
+		capacity += capacity / 2 + 4;
+		lept_array_resize(v, size > capacity ? size : capacity);
+	}
+	else if (v->flags & LEPT_FLAG_BORROWED)
+		lept_array_resize(v, capacity);
+}
+
+void lept_reserve_array(lept_value* v, size_t capacity) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	if (capacity > v->u.a.capacity)
+		lept_array_resize(v, capacity);
+}
+
+void lept_shrink_array(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	if (v->u.a.capacity > v->u.a.size)
+		lept_array_resize(v, v->u.a.size);
+}
+
+void lept_clear_array(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	lept_erase_array_element(v, 0, v->u.a.size);
+}
+
+lept_value* lept_pushback_array_element(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY);
+	lept_array_reserve(v, v->u.a.size + 1);
+	lept_init(&v->u.a.e[v->u.a.size]);
+	lept_hash_invalidate(v);
+	return &v->u.a.e[v->u.a.size++];
+}
+
+void lept_popback_array_element(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_ARRAY && v->u.a.size > 0);
+	lept_free(&v->u.a.e[--v->u.a.size]);
+	lept_hash_invalidate(v);
+}
+
+lept_value* lept_insert_array_element(lept_value* v, size_t index) {
+	assert(v != NULL && v->type == LEPT_ARRAY && index <= v->u.a.size);
+	lept_array_reserve(v, v->u.a.size + 1);
+	memmove(&v->u.a.e[index + 1], &v->u.a.e[index], (v->u.a.size++ - index) * sizeof(lept_value));
+	lept_init(&v->u.a.e[index]);
+	lept_hash_invalidate(v);
+	return &v->u.a.e[index];
+}
+
+void lept_erase_array_element(lept_value* v, size_t index, size_t count) {
+	size_t i;
+	assert(v != NULL && v->type == LEPT_ARRAY && count <= v->u.a.size && index <= v->u.a.size - count);
+	if (count == 0)
+		return;
+	for (i = index; i < index + count; i++)
+		lept_free(&v->u.a.e[i]);
+	memmove(&v->u.a.e[index], &v->u.a.e[index + count], (v->u.a.size - index - count) * sizeof(lept_value));
+	v->u.a.size -= count;
+	lept_hash_invalidate(v);
+}
+
+size_t lept_get_object_size(const lept_value* v)
+{
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	return v->flags & LEPT_FLAG_SHAPED ? v->u.sh.size : v->u.o.size;
+}
+
+const char* lept_get_object_key(const lept_value* v, size_t index)
+{
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	assert(index < lept_get_object_size(v));
+	if (v->flags & LEPT_FLAG_SHAPED)
+		return v->u.sh.shape->keys[index].k;
+	return v->u.o.m[index].k;
+}
+
+size_t lept_get_object_key_length(const lept_value * v, size_t index)
+{
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	assert(index < lept_get_object_size(v));
+	if (v->flags & LEPT_FLAG_SHAPED)
+		return v->u.sh.shape->keys[index].klen;
+	return v->u.o.m[index].klen;
+}
+
+lept_value* lept_get_object_value(const lept_value* v, size_t index)
+{
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	assert(index < lept_get_object_size(v));
+	if (v->flags & LEPT_FLAG_SHAPED)
+		return &v->u.sh.v[index];
+	return &v->u.o.m[index].v;
+}
+
+template <class Key>
+static size_t lept_find_key(const Key* m, size_t size, lept_object_index** cache, const char* key, size_t klen) {
+	const lept_object_index* index;
+	size_t i;
+	if (size >= LEPT_OBJECT_INDEX_THRESHOLD && cache && !*cache) {
+		void* mem = lept_mem_alloc(lept_object_index_bytes(size));
+		if (mem)
+			*cache = lept_object_index_build(mem, m, size);
+	}
+	if (cache && (index = *cache) != NULL) {
+		for (i = lept_hash_key(key, klen) & index->mask; index->slots[i]; i = (i + 1) & index->mask)
+			if (lept_key_equal(&m[index->slots[i] - 1], key, klen))
+				return index->slots[i] - 1;
+		return LEPT_KEY_NOT_EXIST;
+	}
+	for (i = 0; i < size; i++)
+		if (lept_key_equal(&m[i], key, klen))
+			return i;
+	return LEPT_KEY_NOT_EXIST;
+}
+
+size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen)
+{
+	/* an index is a cache, building it does not change the value */
+	lept_value* cache = const_cast<lept_value*>(v);
+	assert(v != NULL && v->type == LEPT_OBJECT && (key != NULL || klen == 0));
+	if (v->flags & LEPT_FLAG_SHAPED)	/* all the objects of a shape share its index */
+		return lept_find_key(v->u.sh.shape->keys, v->u.sh.size, &v->u.sh.shape->index, key, klen);
+	if (v->flags & LEPT_FLAG_BORROWED && !v->u.o.index)	/* small arena object, nowhere to keep an index */
+		return lept_find_key(v->u.o.m, v->u.o.size, (lept_object_index**)NULL, key, klen);
+	return lept_find_key(v->u.o.m, v->u.o.size, &cache->u.o.index, key, klen);
+}
+
+lept_value* lept_find_object_value(lept_value* v, const char* key, size_t klen)
+{
+	size_t index = lept_find_object_index(v, key, klen);
+	return index != LEPT_KEY_NOT_EXIST ? lept_get_object_value(v, index) : NULL;
+}
+
+const lept_shape* lept_get_object_shape(const lept_value* v)
+{
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	return v->flags & LEPT_FLAG_SHAPED ? v->u.sh.shape : NULL;
+}
+
+void lept_set_object(lept_value* v, size_t capacity) {
+	assert(v != NULL);
+	lept_free(v);
+	v->type = LEPT_OBJECT;
+	v->u.o.size = 0;
+	v->u.o.capacity = capacity;
+	v->u.o.index = NULL;
+	v->u.o.m = capacity ? (lept_member*)lept_mem_alloc(capacity * sizeof(lept_member)) : NULL;
+}
+
+size_t lept_get_object_capacity(const lept_value* v) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	return v->flags & LEPT_FLAG_SHAPED ? v->u.sh.size : v->u.o.capacity;
+}
+
+/*
+	Moves the members to a buffer of their own with this capacity. A shaped, arena or in-situ object
+	becomes an ordinary one with copies of its keys and no index; the index of a member position
+	remains valid otherwise.
+*/
+static void lept_object_resize(lept_value* v, size_t capacity) {
+	size_t size = lept_get_object_size(v), i;
+	lept_member* m;
+	assert(capacity >= size);
+	if (!(v->flags & (LEPT_FLAG_SHAPED | LEPT_FLAG_BORROWED | LEPT_FLAG_BORROWED_KEYS))) {
+		if (capacity)
+			v->u.o.m = (lept_member*)lept_mem_realloc(v->u.o.m, v->u.o.capacity * sizeof(lept_member), capacity * sizeof(lept_member));
+		else {
+			lept_mem_free(v->u.o.m, 0);
+			v->u.o.m = NULL;
+		}
+		v->u.o.capacity = capacity;
+		return;
+	}
+	m = capacity ? (lept_member*)lept_mem_alloc(capacity * sizeof(lept_member)) : NULL;
+	for (i = 0; i < size; i++) {
+		m[i].klen = lept_get_object_key_length(v, i);
+		m[i].k = (char*)lept_mem_alloc(m[i].klen + 1);
+		memcpy(m[i].k, lept_get_object_key(v, i), m[i].klen);
+		m[i].k[m[i].klen] = '\0';
+		m[i].v = *lept_get_object_value(v, i);
+	}
+	if (!(v->flags & LEPT_FLAG_BORROWED)) {	/* the members of an arena object stay in the arena */
+		if (v->flags & LEPT_FLAG_SHAPED) {
+			lept_mem_free(v->u.sh.v, 0);
+			lept_mem_free(v->u.sh.hash, 0);
+			lept_shape_release(v->u.sh.shape);
+		}
+		else {
+			lept_mem_free(v->u.o.m, 0);
+			lept_mem_free(v->u.o.index, 0);
+		}
+	}
+	v->u.o.m = m;
+	v->u.o.size = size;
+	v->u.o.capacity = capacity;
+	v->u.o.index = NULL;
+	v->flags &= ~LEPT_FLAG_MASK;	/* still in its tree */
+}
+
+/* Room for size members, in a buffer of their own */
+static void lept_object_reserve(lept_value* v, size_t size) {
+	size_t capacity = lept_get_object_capacity(v);
+	if (size > capacity) {
+		capacity += capacity / 2 + 4;
+		lept_object_resize(v, size > capacity ? size : capacity);
+	}
+	else if (v->flags & (LEPT_FLAG_SHAPED | LEPT_FLAG_BORROWED | LEPT_FLAG_BORROWED_KEYS))
+		lept_object_resize(v, capacity);
+}
+
+void lept_reserve_object(lept_value* v, size_t capacity) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	if (capacity > lept_get_object_capacity(v))
+		lept_object_resize(v, capacity);
+}
+
+void lept_shrink_object(lept_value* v) {
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	if (lept_get_object_capacity(v) > lept_get_object_size(v))
+		lept_object_resize(v, lept_get_object_size(v));
+}
+
+void lept_clear_object(lept_value* v) {
+	size_t i;
+	assert(v != NULL && v->type == LEPT_OBJECT);
+	lept_object_reserve(v, 0);
+	for (i = 0; i < v->u.o.size; i++) {
+		lept_mem_free(v->u.o.m[i].k, 0);
+		lept_free(&v->u.o.m[i].v);
+	}
+	v->u.o.size = 0;
+	lept_mem_free(v->u.o.index, 0);
+	v->u.o.index = NULL;
+	lept_hash_invalidate(v);
+}
+
+lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen) {
+	size_t i = lept_find_object_index(v, key, klen), j;
+	lept_object_index* index;
+	lept_member* m;
+	lept_hash_invalidate(v);
+	if (i != LEPT_KEY_NOT_EXIST)	/* the value is about to change */
+		return lept_get_object_value(v, i);
+	lept_object_reserve(v, lept_get_object_size(v) + 1);
+	i = v->u.o.size++;
+	m = &v->u.o.m[i];
+	m->k = (char*)lept_mem_alloc(klen + 1);
+	memcpy(m->k, key, klen);
+	m->k[klen] = '\0';
+	m->klen = klen;
+	lept_init(&m->v);
+	if ((index = v->u.o.index) != NULL) {	/* the key is new: it is added, or the index rebuilt later at twice the size */
+		if (2 * v->u.o.size > index->mask + 1) {
+			lept_mem_free(index, 0);
+			v->u.o.index = NULL;
+		}
+		else {
+			for (j = lept_hash_key(key, klen) & index->mask; index->slots[j]; j = (j + 1) & index->mask)
+				;
+			index->slots[j] = i + 1;
+		}
+	}
+	return &m->v;
+}
+
+void lept_remove_object_value(lept_value* v, size_t index) {
+	assert(v != NULL && v->type == LEPT_OBJECT && index < lept_get_object_size(v));
+	lept_object_reserve(v, 0);
+	lept_mem_free(v->u.o.m[index].k, 0);
+	lept_free(&v->u.o.m[index].v);
+	memmove(&v->u.o.m[index], &v->u.o.m[index + 1], (--v->u.o.size - index) * sizeof(lept_member));
+	lept_hash_invalidate(v);
+	lept_mem_free(v->u.o.index, 0);	/* the members after it have moved */
+	v->u.o.index = NULL;
+}
+
+/* Hashing: a string hash over 8-byte words, and the finalizer of MurmurHash3 to mix */
+inline uint64_t lept_mix(uint64_t h) {
+	h = (h ^ (h >> 33)) * LEPT_U64(0xff51afd7, 0xed558ccd);
+	h = (h ^ (h >> 33)) * LEPT_U64(0xc4ceb9fe, 0x1a85ec53);
+	return h ^ (h >> 33);
+}
+
+static uint64_t lept_hash_bytes(uint64_t h, const char* s, size_t len) {
+	uint64_t w;
+	size_t i;
+	for (i = 0; i + 8 <= len; i += 8) {
+		memcpy(&w, s + i, 8);
+		h = (h ^ w) * LEPT_U64(0x9e3779b9, 0x7f4a7c15);
+		h ^= h >> 29;
+	}
+	for (w = 0; i < len; i++)
+		w = w << 8 | (unsigned char)s[i];
+	return lept_mix(h ^ w ^ len);
+}
+
+/* The current hash cached in a container, 0 if there is none; with a tree other than 0, only one cached in that tree */
+static uint64_t lept_cached_hash(const lept_value* v, unsigned tree) {
+	const lept_hash_cache* cache;
+	if (v->type == LEPT_ARRAY)
+		cache = v->u.a.hash;
+	else if (v->type != LEPT_OBJECT)
+		return 0;
+	else if (v->flags & LEPT_FLAG_SHAPED)
+		cache = v->u.sh.hash;
+	else
+		cache = v->u.o.index ? &v->u.o.index->hash : NULL;
+	if (!cache || !cache->tree || cache->tree != lept_tree(v) || (tree && cache->tree != tree))
+		return 0;
+	return cache->generation == (uint64_t)lept_atomic_load(&lept_tree_generations[cache->tree]) ? cache->hash : 0;
+}
+
+/*
+	Caches the hash of a container of at least LEPT_OBJECT_INDEX_THRESHOLD elements or members,
+	in the index of an ordinary object. Like an object index, a cached hash does not change the value.
+*/
+static void lept_cache_hash(const lept_value* v, uint64_t h, unsigned tree, uint64_t generation) {
+	lept_value* c = const_cast<lept_value*>(v);
+	lept_hash_cache** cache;
+	if ((v->type == LEPT_ARRAY ? v->u.a.size : lept_get_object_size(v)) < LEPT_OBJECT_INDEX_THRESHOLD)
+		return;
+	if (v->type == LEPT_OBJECT && !(v->flags & LEPT_FLAG_SHAPED)) {
+		if (!v->u.o.index && !(v->flags & LEPT_FLAG_BORROWED)) {
+			void* mem = lept_mem_alloc(lept_object_index_bytes(v->u.o.size));
+			if (mem)
+				c->u.o.index = lept_object_index_build(mem, v->u.o.m, v->u.o.size);
+		}
+		if (v->u.o.index) {
+			v->u.o.index->hash.hash = h;
+			v->u.o.index->hash.generation = generation;
+			v->u.o.index->hash.tree = tree;
+		}
+		return;
+	}
+	if (v->flags & LEPT_FLAG_BORROWED)	/* lept_free() would not release it */
+		return;
+	cache = v->type == LEPT_ARRAY ? &c->u.a.hash : &c->u.sh.hash;
+	if (!*cache && (*cache = (lept_hash_cache*)lept_mem_alloc(sizeof(lept_hash_cache))) == NULL)
+		return;
+	(*cache)->hash = h;
+	(*cache)->generation = generation;
+	(*cache)->tree = tree;
+}
+
+inline size_t lept_children(const lept_value* v) {	/* of an array or an object */
+	return v->type == LEPT_ARRAY ? v->u.a.size : lept_get_object_size(v);
+}
+
+inline const lept_value* lept_child(const lept_value* v, size_t i) {
+	return v->type == LEPT_ARRAY ? &v->u.a.e[i] : lept_get_object_value(v, i);
+}
+
+static uint64_t lept_hash_scalar(const lept_value* v) {
+	uint64_t h;
+	double n;
+	switch (v->type) {
+		case LEPT_NUMBER:
+			n = v->u.n == 0.0 ? 0.0 : v->u.n;	/* -0 == 0 */
+			memcpy(&h, &n, sizeof(h));
+			return lept_mix(h ^ LEPT_NUMBER);
+		case LEPT_STRING:
+			return lept_hash_bytes(LEPT_STRING, v->u.s.s, v->u.s.len);
+		default:
+			return lept_mix(v->type + 1);
+	}
+}
+
+/* Adds the hash c of element or member i of v to h, the hash of those before it */
+inline uint64_t lept_hash_add(const lept_value* v, size_t i, uint64_t h, uint64_t c) {
+	if (v->type == LEPT_ARRAY)
+		return lept_mix(h + c);
+	return h + lept_mix(lept_hash_bytes(LEPT_OBJECT, lept_get_object_key(v, i), lept_get_object_key_length(v, i))
+		+ c * LEPT_U64(0x9e3779b9, 0x7f4a7c15));	/* a sum does not depend on the order */
+}
+
+/*
+	Hashes v without recursion, the enclosing containers wait on a walk. With a tree other than 0,
+	the values are labeled with it and the hashes of the containers are cached in it, stamped with
+	its generation; a container cached in another tree is hashed again. With 0, nothing is written.
+*/
+static uint64_t lept_hash_value(const lept_value* v, unsigned tree, uint64_t generation) {
+	lept_walk w;
+	lept_walk_frame* f;
+	const lept_value* e;
+	uint64_t h;
+	if (v->type != LEPT_ARRAY && v->type != LEPT_OBJECT)
+		return lept_hash_scalar(v);
+	if ((h = lept_cached_hash(v, tree)) != 0)
+		return h;
+	lept_walk_init(&w);
+	lept_walk_push(&w, v);
+	w.frames[0].hash = v->type == LEPT_ARRAY ? LEPT_ARRAY : 0;
+	for (;;) {
+		f = &w.frames[w.depth - 1];
+		if (f->i < lept_children(f->v)) {
+			e = lept_child(f->v, f->i);
+			if (tree)
+				lept_set_tree(e, tree);
+			if (e->type != LEPT_ARRAY && e->type != LEPT_OBJECT)
+				h = lept_hash_scalar(e);
+			else if ((h = lept_cached_hash(e, tree)) == 0) {
+				lept_walk_push(&w, e);
+				w.frames[w.depth - 1].hash = e->type == LEPT_ARRAY ? LEPT_ARRAY : 0;
+				continue;
+			}
+			f->hash = lept_hash_add(f->v, f->i, f->hash, h);
+			f->i++;
+			continue;
+		}
+		h = f->v->type == LEPT_ARRAY ? f->hash : lept_mix(f->hash ^ f->i);
+		h = h ? h : 1;	/* 0 is not cached */
+		if (tree)
+			lept_cache_hash(f->v, h, tree, generation);
+		if (--w.depth == 0)
+			break;
+		f = &w.frames[w.depth - 1];
+		f->hash = lept_hash_add(f->v, f->i, f->hash, h);
+		f->i++;
+	}
+	lept_walk_free(&w);
+	return h;
+}
+
+/* A tree keeps its number, a new one is numbered: the generation is read before the stamps are written */
+uint64_t lept_hash(const lept_value* v) {
+	unsigned tree;
+	assert(v != NULL);
+	if (v->type != LEPT_ARRAY && v->type != LEPT_OBJECT)
+		return lept_hash_scalar(v);
+	if ((tree = lept_tree(v)) == 0) {
+		tree = (unsigned)(lept_atomic_increment(&lept_tree_count) % (LEPT_TREES - 1)) + 1;
+		lept_set_tree(v, tree);
+	}
+	return lept_hash_value(v, tree, (uint64_t)lept_atomic_load(&lept_tree_generations[tree]));
+}
+
+/*
+	Equality. lept_is_equal() walks both trees without recursion: a frame holds two containers
+	compared element by element from i, or, with i == LEPT_EQUAL_PAIR, two values still to compare.
+	Two objects with different key orders are compared member by member once the members of each
+	are sorted by key, and the members of a duplicated key by the hash of their value.
+*/
+const size_t LEPT_EQUAL_PAIR = (size_t)-1;
+const size_t LEPT_EQUAL_LOCAL_MEMBERS = 16;	/* objects of up to this many members are sorted on the stack */
+
+struct lept_equal_member {
+	size_t index;
+	uint64_t hash;	/* of the value, for a duplicated key only */
+};
+
+static int lept_key_compare(const lept_value* a, size_t i, const lept_value* b, size_t j) {
+	size_t alen = lept_get_object_key_length(a, i), blen = lept_get_object_key_length(b, j);
+	int d = memcmp(lept_get_object_key(a, i), lept_get_object_key(b, j), alen < blen ? alen : blen);
+	return d ? d : (alen > blen) - (alen < blen);
+}
+
+struct lept_member_key_less {
+	const lept_value* v;
+	bool operator()(const lept_equal_member& x, const lept_equal_member& y) const {
+		return lept_key_compare(v, x.index, v, y.index) < 0;
+	}
+};
+
+struct lept_member_hash_less {
+	bool operator()(const lept_equal_member& x, const lept_equal_member& y) const {
+		return x.hash < y.hash;
+	}
+};
+
+template <class Less>
+static void lept_sift_down(lept_equal_member* m, size_t i, size_t n, const Less& less) {
+	lept_equal_member t = m[i];
+	size_t c;
+	for (; (c = 2 * i + 1) < n; i = c) {
+		if (c + 1 < n && less(m[c], m[c + 1]))
+			c++;
+		if (!less(t, m[c]))
+			break;
+		m[i] = m[c];
+	}
+	m[i] = t;
+}
+
+template <class Less>
+static void lept_heap_sort(lept_equal_member* m, size_t n, const Less& less) {
+	lept_equal_member t;
+	size_t i;
+	for (i = n / 2; i > 0; i--)
+		lept_sift_down(m, i - 1, n, less);
+	for (i = n; i > 1; i--) {
+		t = m[0];
+		m[0] = m[i - 1];
+		m[i - 1] = t;
+		lept_sift_down(m, 0, i - 1, less);
+	}
+}
+
+static void lept_sort_members(const lept_value* v, lept_equal_member* m, size_t n) {
+	lept_member_key_less by_key = { v };
+	size_t i, j, k;
+	for (i = 0; i < n; i++) {
+		m[i].index = i;
+		m[i].hash = 0;
+	}
+	lept_heap_sort(m, n, by_key);
+	for (i = 0; i < n; i = j) {
+		for (j = i + 1; j < n && lept_key_compare(v, m[i].index, v, m[j].index) == 0; j++)
+			;
+		if (j - i > 1) {
+			for (k = i; k < j; k++)	/* not cached: a comparison does not change the values */
+				m[k].hash = lept_hash_value(lept_get_object_value(v, m[k].index), 0, 0);
+			lept_heap_sort(m + i, j - i, lept_member_hash_less());
+		}
+	}
+}
+
+static void lept_equal_push(lept_walk* w, const lept_value* a, const lept_value* b, size_t i) {
+	lept_walk_push(w, a);
+	w->frames[w->depth - 1].w = b;
+	w->frames[w->depth - 1].i = i;
+}
+
+/* Without memory: the k-th member of a key in a pairs with the k-th of that key in b, in the same order */
+static bool lept_equal_members_scan(lept_walk* w, const lept_value* a, const lept_value* b) {
+	size_t n = lept_get_object_size(a), i, j, k, rank;
+	for (i = 0; i < n; i++) {
+		for (rank = 0, k = 0; k < i; k++)
+			rank += lept_key_compare(a, k, a, i) == 0;
+		for (j = 0; j < n; j++)
+			if (lept_key_compare(b, j, a, i) == 0 && rank-- == 0)
+				break;
+		if (j == n)
+			return false;
+		lept_equal_push(w, lept_get_object_value(a, i), lept_get_object_value(b, j), LEPT_EQUAL_PAIR);
+	}
+	return true;
+}
+
+/* Pushes the pairs of members of two objects of the same size, false if their keys differ */
+static bool lept_equal_members(lept_walk* w, const lept_value* a, const lept_value* b) {
+	lept_equal_member local[2 * LEPT_EQUAL_LOCAL_MEMBERS], *m = local;
+	size_t n = lept_get_object_size(a), i;
+	bool equal = true;
+	if (n > LEPT_EQUAL_LOCAL_MEMBERS && (m = (lept_equal_member*)lept_mem_alloc(2 * n * sizeof(lept_equal_member))) == NULL)
+		return lept_equal_members_scan(w, a, b);
+	lept_sort_members(a, m, n);
+	lept_sort_members(b, m + n, n);
+	for (i = 0; i < n && equal; i++) {
+		if (lept_key_compare(a, m[i].index, b, m[n + i].index) != 0 || m[i].hash != m[n + i].hash)
+			equal = false;
+		else
+			lept_equal_push(w, lept_get_object_value(a, m[i].index), lept_get_object_value(b, m[n + i].index), LEPT_EQUAL_PAIR);
+	}
+	if (m != local)
+		lept_mem_free(m, 2 * n * sizeof(lept_equal_member));
+	return equal;
+}
+
+/* Containers with different cached hashes differ */
+inline bool lept_hash_differs(const lept_value* a, const lept_value* b) {
+	uint64_t ha = lept_cached_hash(a, 0), hb;
+	return ha && (hb = lept_cached_hash(b, 0)) != 0 && ha != hb;
+}
+
+/* 0: a and b differ, 1: they are equal, 2: they are containers of the same size, to compare their elements */
+static int lept_equal_shallow(const lept_value* a, const lept_value* b) {
+	if (a == b)
+		return 1;
+	if (a->type != b->type)
+		return 0;
+	switch (a->type) {
+		case LEPT_NUMBER:
+			return a->u.n == b->u.n;
+		case LEPT_STRING:
+			return a->u.s.len == b->u.s.len && memcmp(a->u.s.s, b->u.s.s, a->u.s.len) == 0;
+		case LEPT_ARRAY:
+		case LEPT_OBJECT:
+			if (lept_children(a) != lept_children(b) || lept_hash_differs(a, b))
+				return 0;
+			return lept_children(a) ? 2 : 1;
+		default:
+			return 1;
+	}
+}
+
+/* Pushes the comparison of the elements or members of two containers of the same size */
+static bool lept_equal_open(lept_walk* w, const lept_value* a, const lept_value* b) {
+	if (a->type == LEPT_OBJECT && !((a->flags & b->flags & LEPT_FLAG_SHAPED) && a->u.sh.shape == b->u.sh.shape && a->u.sh.shape->distinct))
+		return lept_equal_members(w, a, b);
+	lept_equal_push(w, a, b, 0);	/* arrays, or objects with the same distinct keys in the same order */
+	return true;
+}
+
+bool lept_is_equal(const lept_value* a, const lept_value* b) {
+	lept_walk w;
+	lept_walk_frame* f;
+	const lept_value* x, *y;
+	bool equal;
+	int r;
+	assert(a != NULL && b != NULL);
+	if ((r = lept_equal_shallow(a, b)) != 2)
+		return r == 1;
+	lept_walk_init(&w);
+	equal = lept_equal_open(&w, a, b);
+	while (equal && w.depth) {
+		f = &w.frames[w.depth - 1];
+		if (f->i == LEPT_EQUAL_PAIR) {
+			x = f->v;
+			y = f->w;
+			w.depth--;
+		}
+		else if (f->i < lept_children(f->v)) {
+			x = lept_child(f->v, f->i);
+			y = lept_child(f->w, f->i++);
+		}
+		else {
+			w.depth--;
+			continue;
+		}
+		if ((r = lept_equal_shallow(x, y)) == 2)
+			equal = lept_equal_open(&w, x, y);
+		else
+			equal = r == 1;
+	}
+	lept_walk_free(&w);
+	return equal;
+}
+
+/*
+	Flat document. A node is a tape word whose top byte is a lept_type, or the end of a container:
+	- null, false, true: one word;
+	- number: one word, then the bits of the double;
+	- string: one word with the offset of the string in the side buffer, where it is stored as its
+	  length (a size_t), its bytes and a terminator;
+	- array, object: one word with the offset just past the container, its elements (or alternating
+	  keys and values), then an end word with the number of elements (or members).
+	Skipping a node is one read, and parsing appends to two buffers that are kept between parses.
+*/
+enum {
+	LEPT_TAPE_ARRAY_END = LEPT_OBJECT + 1,
+	LEPT_TAPE_OBJECT_END
+};
+
+const unsigned LEPT_TAPE_SHIFT = 56;
+const uint64_t LEPT_TAPE_PAYLOAD = ((uint64_t)1 << LEPT_TAPE_SHIFT) - 1;
+
+struct lept_document {
+	uint64_t* tape;
+	size_t size, capacity;
+	char* strings;
+	size_t strings_size, strings_capacity;
+};
+
+/* Appends the tape, the context stack holds the tape offsets of the open containers */
+struct lept_tape_handler {
+	lept_context* c;
+	lept_document* d;
+
+	lept_tape_handler(lept_context* c, lept_document* d) : c(c), d(d) {}
+
+	void put_word(uint64_t w) {
+		if (d->size == d->capacity) {
+			d->capacity += d->capacity / 2 + 64;
+			d->tape = (uint64_t*)lept_mem_realloc(d->tape, 0, d->capacity * sizeof(uint64_t));
+			assert(d->tape != NULL);
+		}
+		d->tape[d->size++] = w;
+	}
+
+	void put(unsigned tag, uint64_t payload) { put_word((uint64_t)tag << LEPT_TAPE_SHIFT | payload); }
+
+	bool null() { put(LEPT_NULL, 0); return true; }
+	bool boolean(bool b) { put(b ? LEPT_TRUE : LEPT_FALSE, 0); return true; }
+
+	bool number(double n) {
+		uint64_t bits;
+		memcpy(&bits, &n, sizeof(bits));
+		put(LEPT_NUMBER, 0);
+		put_word(bits);
+		return true;
+	}
+
+	bool string(const char* s, size_t len) {
+		size_t need = d->strings_size + sizeof(size_t) + len + 1;
+		char* p;
+		if (need > d->strings_capacity) {
+			d->strings_capacity += d->strings_capacity / 2 + 256;
+			if (d->strings_capacity < need)
+				d->strings_capacity = need;
+			d->strings = (char*)lept_mem_realloc(d->strings, 0, d->strings_capacity);
+			assert(d->strings != NULL);
+		}
+		put(LEPT_STRING, d->strings_size);
+		p = d->strings + d->strings_size;
+		memcpy(p, &len, sizeof(size_t));
+		if (len)	// an empty string may come from a stack that was never allocated
+			memcpy(p + sizeof(size_t), s, len);
+		p[sizeof(size_t) + len] = '\0';
+		d->strings_size = need;
+		return true;
+	}
+
+	bool key(const char* s, size_t len) { return string(s, len); }
+
+	bool start(unsigned tag) {
+		*(size_t*)lept_context_push(c, sizeof(size_t)) = d->size;
+		put(tag, 0);
+		return true;
+	}
+
+	bool end(unsigned tag, size_t size) {
+		size_t open = *(size_t*)lept_context_pop(c, sizeof(size_t));
+		put(tag, size);
+		d->tape[open] |= d->size;
+		return true;
+	}
+
+	bool start_array() { return start(LEPT_ARRAY); }
+	bool end_array(size_t size) { return end(LEPT_TAPE_ARRAY_END, size); }
+	bool start_object() { return start(LEPT_OBJECT); }
+	bool end_object(size_t size) { return end(LEPT_TAPE_OBJECT_END, size); }
+};
+
+lept_document* lept_document_create() {
+	lept_document* d = (lept_document*)lept_mem_alloc(sizeof(lept_document));
+	if (!d)
+		return NULL;
+	memset(d, 0, sizeof(lept_document));
+	return d;
+}
+
+void lept_document_destroy(lept_document* d) {
+	if (!d)
+		return;
+	lept_mem_free(d->tape, 0);
+	lept_mem_free(d->strings, 0);
+	lept_mem_free(d, 0);
+}
+
+int lept_document_parse(lept_document* d, const char* json, size_t len) {
+	lept_context c;
+	int ret;
+	assert(d != NULL && (json != NULL || len == 0));
+	lept_context_init(&c, json, len);
+	lept_tape_handler h(&c, d);
+	d->size = d->strings_size = 0;
+	if ((ret = lept_parse_document(&c, h)) != LEPT_PARSE_OK)
+		d->size = d->strings_size = 0;
+	lept_context_free(&c);
+	return ret;
+}
+
+inline unsigned lept_tape_tag(const lept_document* d, size_t node) {
+	assert(d != NULL && node < d->size);
+	return (unsigned)(d->tape[node] >> LEPT_TAPE_SHIFT);
+}
+
+inline size_t lept_tape_payload(const lept_document* d, size_t node) {
+	return (size_t)(d->tape[node] & LEPT_TAPE_PAYLOAD);
+}
+
+size_t lept_document_next(const lept_document* d, size_t node) {
+	switch (lept_tape_tag(d, node)) {
+		case LEPT_NUMBER: return node + 2;
+		case LEPT_ARRAY:
+		case LEPT_OBJECT: return lept_tape_payload(d, node);
+		default: return node + 1;
+	}
+}
+
+/* The i-th node inside a container, found by skipping the ones before it */
+static size_t lept_document_child(const lept_document* d, size_t node, size_t i) {
+	for (node++; i > 0; i--)
+		node = lept_document_next(d, node);
+	return node;
+}
+
+lept_type lept_document_get_type(const lept_document* d, size_t node) {
+	unsigned tag = lept_tape_tag(d, node);
+	assert(tag <= LEPT_OBJECT);
+	return (lept_type)tag;
+}
+
+bool lept_document_get_boolean(const lept_document* d, size_t node) {
+	unsigned tag = lept_tape_tag(d, node);
+	assert(tag == LEPT_TRUE || tag == LEPT_FALSE);
+	return tag == LEPT_TRUE;
+}
+
+double lept_document_get_number(const lept_document* d, size_t node) {
+	double n;
+	assert(lept_tape_tag(d, node) == LEPT_NUMBER);
+	memcpy(&n, &d->tape[node + 1], sizeof(n));
+	return n;
+}
+
+const char* lept_document_get_string(const lept_document* d, size_t node) {
+	assert(lept_tape_tag(d, node) == LEPT_STRING);
+	return d->strings + lept_tape_payload(d, node) + sizeof(size_t);
+}
+
+size_t lept_document_get_string_length(const lept_document* d, size_t node) {
+	size_t len;
+	assert(lept_tape_tag(d, node) == LEPT_STRING);
+	memcpy(&len, d->strings + lept_tape_payload(d, node), sizeof(size_t));
+	return len;
+}
+
+size_t lept_document_get_array_size(const lept_document* d, size_t node) {
+	assert(lept_tape_tag(d, node) == LEPT_ARRAY);
+	return lept_tape_payload(d, lept_tape_payload(d, node) - 1);
+}
+
+size_t lept_document_get_array_element(const lept_document* d, size_t node, size_t index) {
+	assert(index < lept_document_get_array_size(d, node));
+	return lept_document_child(d, node, index);
+}
+
+size_t lept_document_get_object_size(const lept_document* d, size_t node) {
+	assert(lept_tape_tag(d, node) == LEPT_OBJECT);
+	return lept_tape_payload(d, lept_tape_payload(d, node) - 1);
+}
+
+const char* lept_document_get_object_key(const lept_document* d, size_t node, size_t index) {
+	assert(index < lept_document_get_object_size(d, node));
+	return lept_document_get_string(d, lept_document_child(d, node, 2 * index));
+}
+
+size_t lept_document_get_object_key_length(const lept_document* d, size_t node, size_t index) {
+	assert(index < lept_document_get_object_size(d, node));
+	return lept_document_get_string_length(d, lept_document_child(d, node, 2 * index));
+}
+
+size_t lept_document_get_object_value(const lept_document* d, size_t node, size_t index) {
+	assert(index < lept_document_get_object_size(d, node));
+	return lept_document_child(d, node, 2 * index + 1);
+}
+
+/*
+	On-demand values. A lept_lazy is the span of a value in the input; the root span is found by
+	matching brackets with the stage 1 scanner of the parallel parse. A container is split into the
+	spans of its elements (and its keys) on first access, and a scalar is decoded by its first
+	getter, both with the ordinary token parsers. The result or the error is kept in the node.
+*/
+typedef struct lept_lazy_doc lept_lazy_doc;
+
+struct lept_lazy_key {
+	const char* s;
+	size_t len;
+	char* owned;	/* the decoded key if it has escapes */
+};
+
+struct lept_lazy {
+	const char* json, *end;	/* the bytes of the value */
+	lept_lazy_doc* doc;
+	bool done;	/* the value is decoded or split, status is known */
+	int status;
+	union {
+		double n;
+		struct { const char* s; size_t len; char* owned; } s;
+		struct { lept_lazy* e; lept_lazy_key* k; size_t size; } c;	/* elements or member values, keys of an object */
+	} u;
+};
+
+struct lept_lazy_doc {
+	lept_lazy root;
+	lept_context c;	/* scratch for the token parsers */
+};
+
+/* p is at '"', returns the byte after the closing quotation mark, or NULL */
+static const char* lept_skip_string(const char* p, const char* end) {
+	for (p++; ; p++) {
+		if ((p = lept_scan_string(p, end)) == end)
+			return NULL;
+		if (*p == '"')
+			return p + 1;
+		if (*p == '\\' && ++p == end)
+			return NULL;
+	}
+}
+
+/* Moves *p past the value at *p without decoding it */
+static int lept_skip_value(const char** p, const char* end) {
+	const char* q = *p;
+	lept_split_index index;
+	if (q == end)
+		return LEPT_PARSE_INVALID_VALUE;
+	switch (*q) {
+		case '"':
+			if (!(q = lept_skip_string(q, end)))
+				return LEPT_PARSE_MISS_QUOTATION_MARK;
+			break;
+		case '[':
+		case '{':
+			memset(&index, 0, sizeof(index));	/* no split point is ever far enough */
+			if (!lept_split_document(q, end - q, (size_t)-1, &index) || q[index.root_end] != *q + 2)
+				return *q == '[' ? LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET : LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET;
+			q += index.root_end + 1;
+			break;
+		default:	/* a number or literal runs to the next delimiter */
+			while (q != end && !ISWHITESPACE(*q) && *q != ',' && *q != ']' && *q != '}')
+				q++;
+			if (q == *p)
+				return LEPT_PARSE_INVALID_VALUE;
+	}
+	*p = q;
+	return LEPT_PARSE_OK;
+}
+
+/* The string token [p, end): borrowed from the input unless it has escapes */
+static int lept_lazy_string(lept_lazy_doc* d, const char* p, const char* end, const char** s, size_t* len, char** owned) {
+	const char* q = lept_scan_string(p + 1, end);
+	char* str;
+	int ret;
+	if (q == end - 1 && *q == '"') {
+		*s = p + 1;
+		*len = q - *s;
+		return LEPT_PARSE_OK;
+	}
+	d->c.json = p;
+	d->c.end = end;
+	if ((ret = lept_parse_string_raw(&d->c, &str, len)) != LEPT_PARSE_OK)
+		return ret;
+	*owned = (char*)lept_mem_alloc(*len + 1);
+	if (*len)
+		memcpy(*owned, str, *len);
+	(*owned)[*len] = '\0';
+	*s = *owned;
+	return LEPT_PARSE_OK;
+}
+
+static void lept_lazy_init(lept_lazy* v, lept_lazy_doc* d, const char* json, const char* end) {
+	v->json = json;
+	v->end = end;
+	v->doc = d;
+	v->done = false;
+	v->status = LEPT_PARSE_OK;
+	v->u.s.owned = NULL;
+}
+
+static void lept_lazy_release(lept_lazy* v) {
+	size_t i;
+	if (!v->done)
+		return;
+	switch (*v->json) {
+		case '"':
+			lept_mem_free(v->u.s.owned, 0);
+			break;
+		case '[':
+		case '{':
+			for (i = 0; i < v->u.c.size; i++) {
+				lept_lazy_release(&v->u.c.e[i]);
+				if (v->u.c.k)
+					lept_mem_free(v->u.c.k[i].owned, 0);
+			}
+			lept_mem_free(v->u.c.e, 0);
+			lept_mem_free(v->u.c.k, 0);
+			break;
+	}
+}
+
+/* Splits a container into the spans of its elements, or of its keys and values */
+static int lept_lazy_split(lept_lazy* v) {
+	const char* end = v->end - 1, *p = lept_skip_whitespace(v->json + 1, end), *q;
+	bool object = *v->json == '{';
+	lept_lazy* e = NULL;
+	lept_lazy_key* k = NULL;
+	size_t size = 0, capacity = 0, i;
+	int ret = LEPT_PARSE_OK;
+	while (p != end) {
+		if (size == capacity) {
+			capacity += capacity / 2 + 8;
+			e = (lept_lazy*)lept_mem_realloc(e, 0, capacity * sizeof(lept_lazy));
+			if (object)
+				k = (lept_lazy_key*)lept_mem_realloc(k, 0, capacity * sizeof(lept_lazy_key));
+		}
+		if (object) {
+			if (*p != '"') {
+				ret = LEPT_PARSE_MISS_KEY;
+				break;
+			}
+			if (!(q = lept_skip_string(p, end))) {
+				ret = LEPT_PARSE_MISS_QUOTATION_MARK;
+				break;
+			}
+			k[size].owned = NULL;
+			if ((ret = lept_lazy_string(v->doc, p, q, &k[size].s, &k[size].len, &k[size].owned)) != LEPT_PARSE_OK)
+				break;
+			p = lept_skip_whitespace(q, end);
+			if (p == end || *p != ':') {
+				lept_mem_free(k[size].owned, 0);
+				ret = LEPT_PARSE_MISS_COLON;
+				break;
+			}
+			p = lept_skip_whitespace(p + 1, end);
+		}
+		q = p;
+		if ((ret = lept_skip_value(&q, end)) != LEPT_PARSE_OK) {
+			if (object)
+				lept_mem_free(k[size].owned, 0);
+			break;
+		}
+		lept_lazy_init(&e[size++], v->doc, p, q);
+		if ((p = lept_skip_whitespace(q, end)) == end)
+			break;
+		if (*p != ',') {
+			ret = object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+			break;
+		}
+		if ((p = lept_skip_whitespace(p + 1, end)) == end)	/* a comma before the closing bracket */
+			ret = object ? LEPT_PARSE_MISS_KEY : LEPT_PARSE_INVALID_VALUE;
+	}
+	if (ret != LEPT_PARSE_OK) {	/* the elements were never accessed, only keys may own memory */
+		for (i = 0; k && i < size; i++)
+			lept_mem_free(k[i].owned, 0);
+		lept_mem_free(e, 0);
+		lept_mem_free(k, 0);
+		e = NULL;
+		k = NULL;
+		size = 0;
+	}
+	v->u.c.e = e;
+	v->u.c.k = k;
+	v->u.c.size = size;
+	v->done = true;
+	return v->status = ret;
+}
+
+int lept_lazy_parse(lept_lazy** root, const char* json, size_t len) {
+	lept_lazy_doc* d;
+	const char* end = json + len, *p, *q;
+	int ret;
+	assert(root != NULL && (json != NULL || len == 0));
+	*root = NULL;
+	p = lept_skip_whitespace(json, end);
+	if (p == end)
+		return LEPT_PARSE_EXPECT_VALUE;
+	q = p;
+	if ((ret = lept_skip_value(&q, end)) != LEPT_PARSE_OK)
+		return ret;
+	if (lept_skip_whitespace(q, end) != end)
+		return LEPT_PARSE_ROOT_NOT_SINGULAR;
+	d = (lept_lazy_doc*)lept_mem_alloc(sizeof(lept_lazy_doc));
+	lept_context_init(&d->c, NULL, 0);
+	lept_lazy_init(&d->root, d, p, q);
+	*root = &d->root;
+	return LEPT_PARSE_OK;
+}
+
+void lept_lazy_free(lept_lazy* root) {
+	if (!root)
+		return;
+	assert(root == &root->doc->root);
+	lept_lazy_release(root);
+	lept_context_free(&root->doc->c);
+	lept_mem_free(root->doc, 0);
+}
+
+lept_type lept_lazy_get_type(const lept_lazy* v) {
+	assert(v != NULL);
+	switch (*v->json) {
+		case 'n': return LEPT_NULL;
+		case 't': return LEPT_TRUE;
+		case 'f': return LEPT_FALSE;
+		case '"': return LEPT_STRING;
+		case '[': return LEPT_ARRAY;
+		case '{': return LEPT_OBJECT;
+		default: return LEPT_NUMBER;
+	}
+}
+
+int lept_lazy_get_boolean(const lept_lazy* v, bool* b) {
+	size_t len;
+	assert(v != NULL && b != NULL && (*v->json == 't' || *v->json == 'f'));
+	len = v->end - v->json;
+	*b = *v->json == 't';
+	if (len != (*b ? 4 : 5) || memcmp(v->json, *b ? "true" : "false", len) != 0)
+		return LEPT_PARSE_INVALID_VALUE;
+	return LEPT_PARSE_OK;
+}
+
+int lept_lazy_get_number(lept_lazy* v, double* n) {
+	lept_context* c;
+	assert(v != NULL && n != NULL && lept_lazy_get_type(v) == LEPT_NUMBER);
+	if (!v->done) {
+		c = &v->doc->c;
+		c->json = v->json;
+		c->end = v->end;
+		if ((v->status = lept_parse_number(c, &v->u.n)) == LEPT_PARSE_OK && c->json != c->end)
+			v->status = LEPT_PARSE_INVALID_VALUE;
+		if (v->status != LEPT_PARSE_OK)
+			v->u.n = 0.0;
+		v->done = true;
+	}
+	*n = v->u.n;
+	return v->status;
+}
+
+int lept_lazy_get_string(lept_lazy* v, const char** s, size_t* len) {
+	assert(v != NULL && s != NULL && len != NULL && lept_lazy_get_type(v) == LEPT_STRING);
+	if (!v->done) {
+		v->u.s.s = NULL;
+		v->u.s.len = 0;
+		v->status = lept_lazy_string(v->doc, v->json, v->end, &v->u.s.s, &v->u.s.len, &v->u.s.owned);
+		v->done = true;
+	}
+	*s = v->u.s.s;
+	*len = v->u.s.len;
+	return v->status;
+}
+
+int lept_lazy_get_array_size(lept_lazy* v, size_t* size) {
+	assert(v != NULL && size != NULL && lept_lazy_get_type(v) == LEPT_ARRAY);
+	if (!v->done)
+		lept_lazy_split(v);
+	*size = v->u.c.size;
+	return v->status;
+}
+
+int lept_lazy_get_array_element(lept_lazy* v, size_t index, lept_lazy** e) {
+	size_t size;
+	int ret = lept_lazy_get_array_size(v, &size);
+	assert(e != NULL);
+	*e = NULL;
+	if (ret == LEPT_PARSE_OK) {
+		assert(index < size);
+		*e = &v->u.c.e[index];
+	}
+	return ret;
+}
+
+int lept_lazy_get_object_size(lept_lazy* v, size_t* size) {
+	assert(v != NULL && size != NULL && lept_lazy_get_type(v) == LEPT_OBJECT);
+	if (!v->done)
+		lept_lazy_split(v);
+	*size = v->u.c.size;
+	return v->status;
+}
+
+int lept_lazy_get_object_key(lept_lazy* v, size_t index, const char** key, size_t* klen) {
+	size_t size;
+	int ret = lept_lazy_get_object_size(v, &size);
+	assert(key != NULL && klen != NULL);
+	if (ret == LEPT_PARSE_OK) {
+		assert(index < size);
+		*key = v->u.c.k[index].s;
+		*klen = v->u.c.k[index].len;
+	}
+	return ret;
+}
+
+int lept_lazy_get_object_value(lept_lazy* v, size_t index, lept_lazy** value) {
+	size_t size;
+	int ret = lept_lazy_get_object_size(v, &size);
+	assert(value != NULL);
+	*value = NULL;
+	if (ret == LEPT_PARSE_OK) {
+		assert(index < size);
+		*value = &v->u.c.e[index];
+	}
+	return ret;
+}
+
+int lept_lazy_find_object_value(lept_lazy* v, const char* key, size_t klen, lept_lazy** value) {
+	size_t size, i;
+	int ret = lept_lazy_get_object_size(v, &size);
+	assert(value != NULL && (key != NULL || klen == 0));
+	*value = NULL;
+	for (i = 0; ret == LEPT_PARSE_OK && i < size; i++)
+		if (v->u.c.k[i].len == klen && memcmp(v->u.c.k[i].s, key, klen) == 0) {
+			*value = &v->u.c.e[i];
+			break;
+		}
+	return ret;
+}
+
+int lept_lazy_get_value(const lept_lazy* v, lept_value* out) {
+	assert(v != NULL && out != NULL);
+	return lept_parse_n(out, v->json, v->end - v->json);
+}
+
+/*
+	JSON Pointer (RFC 6901). A path set is a trie of reference tokens; a node reached by a whole
+	pointer takes its subtree whole. A "*" token also matches every array element: when the set is
+	compiled, an index sibling gets a copy of itself merged with the "*" subtree, which decides the
+	element of that index, while the index node alone still decides an object member of that key.
+*/
+struct lept_path_node {
+	char* token;
+	size_t len;
+	size_t index;	/* the token as an array index, or LEPT_KEY_NOT_EXIST */
+	bool whole;
+	lept_path_node** children;
+	size_t count;
+	lept_path_node* element;	/* for an array element, with the "*" sibling merged in; NULL: this node */
+};
+
+struct lept_path_set {
+	lept_path_node root;
+};
+
+/* A token is an array index when it is "0" or digits without a leading zero */
+static size_t lept_pointer_index(const char* s, size_t len) {
+	size_t i, index = 0;
+	if (len == 0 || (s[0] == '0' && len > 1) || len > 18)
+		return LEPT_KEY_NOT_EXIST;
+	for (i = 0; i < len; i++) {
+		if (!ISDIGIT(s[i]))
+			return LEPT_KEY_NOT_EXIST;
+		index = index * 10 + (s[i] - '0');
+	}
+	return index;
+}
+
+/* Pushes the decoded token that starts at p on the stack and returns its end, or NULL on a bad escape */
+static const char* lept_pointer_token(lept_context* c, const char* p) {
+	for (; *p && *p != '/'; p++) {
+		if (*p != '~')
+			PUTC(c, *p);
+		else if (p[1] == '0' || p[1] == '1')
+			PUTC(c, *++p == '0' ? '~' : '/');
+		else
+			return NULL;
+	}
+	return p;
+}
+
+static lept_path_node* lept_path_new(const char* token, size_t len) {
+	lept_path_node* node = (lept_path_node*)lept_mem_calloc(1, sizeof(lept_path_node));
+	node->token = (char*)lept_mem_alloc(len + 1);
+	memcpy(node->token, token, len);
+	node->token[len] = '\0';
+	node->len = len;
+	node->index = lept_pointer_index(token, len);
+	return node;
+}
+
+static lept_path_node* lept_path_child(lept_path_node* node, const char* token, size_t len) {
+	size_t i;
+	for (i = 0; i < node->count; i++)
+		if (node->children[i]->len == len && memcmp(node->children[i]->token, token, len) == 0)
+			return node->children[i];
+	node->children = (lept_path_node**)lept_mem_realloc(node->children, 0, (node->count + 1) * sizeof(lept_path_node*));
+	return node->children[node->count++] = lept_path_new(token, len);
+}
+
+static void lept_path_merge(lept_path_node* dst, const lept_path_node* src) {
+	size_t i;
+	dst->whole = dst->whole || src->whole;
+	for (i = 0; i < src->count; i++)
+		lept_path_merge(lept_path_child(dst, src->children[i]->token, src->children[i]->len), src->children[i]);
+}
+
+/* Before the subtrees of node are finished: the merges copy their children only */
+static void lept_path_finish(lept_path_node* node) {
+	lept_path_node* child;
+	size_t i, j;
+	for (i = 0; i < node->count; i++)
+		if (node->children[i]->len == 1 && node->children[i]->token[0] == '*')
+			for (j = 0; j < node->count; j++)
+				if ((child = node->children[j])->index != LEPT_KEY_NOT_EXIST) {
+					child->element = lept_path_new(child->token, child->len);
+					lept_path_merge(child->element, child);
+					lept_path_merge(child->element, node->children[i]);
+				}
+	for (i = 0; i < node->count; i++) {
+		lept_path_finish(node->children[i]);
+		if (node->children[i]->element)
+			lept_path_finish(node->children[i]->element);
+	}
+}
+
+static void lept_path_free(lept_path_node* node) {
+	size_t i;
+	for (i = 0; i < node->count; i++) {
+		lept_path_free(node->children[i]);
+		lept_mem_free(node->children[i], 0);
+	}
+	if (node->element) {
+		lept_path_free(node->element);
+		lept_mem_free(node->element, 0);
+	}
+	lept_mem_free(node->children, 0);
+	lept_mem_free(node->token, 0);
+}
+
+lept_path_set* lept_path_set_create(const char* const* pointers, size_t count) {
+	lept_path_set* s = (lept_path_set*)lept_mem_calloc(1, sizeof(lept_path_set));
+	lept_path_node* node;
+	lept_context c;
+	const char* p;
+	size_t i, len;
+	assert(pointers != NULL || count == 0);
+	lept_context_init(&c, NULL, 0);
+	s->root.index = LEPT_KEY_NOT_EXIST;
+	for (i = 0; i < count; i++) {
+		if (*(p = pointers[i]) != '\0' && *p != '/')
+			break;
+		for (node = &s->root; *p; node = lept_path_child(node, len ? (const char*)lept_context_pop(&c, len) : "", len)) {
+			if (!(p = lept_pointer_token(&c, p + 1)))
+				break;
+			len = c.top;
+		}
+		if (!p)
+			break;
+		node->whole = true;
+	}
+	lept_context_free(&c);
+	if (i < count) {
+		lept_path_set_destroy(s);
+		return NULL;
+	}
+	lept_path_finish(&s->root);
+	return s;
+}
+
+void lept_path_set_destroy(lept_path_set* s) {
+	if (!s)
+		return;
+	lept_path_free(&s->root);
+	lept_mem_free(s, 0);
+}
+
+static const lept_path_node* lept_path_element(const lept_path_node* node, size_t index) {
+	const lept_path_node* wildcard = NULL;
+	size_t i;
+	for (i = 0; i < node->count; i++) {
+		if (node->children[i]->index == index)
+			return node->children[i]->element ? node->children[i]->element : node->children[i];
+		if (node->children[i]->len == 1 && node->children[i]->token[0] == '*')
+			wildcard = node->children[i];
+	}
+	return wildcard;
+}
+
+/* The child of a member key and its index among the children, NULL if there is none */
+static const lept_path_node* lept_path_member(const lept_path_node* node, const char* key, size_t klen, size_t* at) {
+	size_t i;
+	for (i = 0; i < node->count; i++)
+		if (node->children[i]->len == klen && memcmp(node->children[i]->token, key, klen) == 0) {
+			*at = i;
+			return node->children[i];
+		}
+	return NULL;
+}
+
+static int lept_skip_projected(lept_context* c) {
+	const char* p = c->json;
+	int ret = lept_skip_value(&p, c->end);
+	c->json = p;
+	return ret;
+}
+
+/*
+	Parses the value at c->json and keeps what lies on the paths below node. Values off the paths
+	are skipped without being decoded, and a scalar where a path goes deeper is skipped too: *kept
+	tells whether a value was pushed. An array element on a path keeps its index, the elements
+	before it that are off the paths become null. Like lept_pointer_get(), a path follows the first
+	member of its key only: the later ones are skipped, kept or not.
+*/
+static int lept_parse_projected_value(lept_context* c, lept_dom_handler& h, const lept_path_node* node, bool* kept) {
+	const lept_path_node* child;
+	size_t size = 0, i, klen, at;
+	uint64_t seen = 0;	/* the children met in an object, more than 64 are marked in many */
+	bool* many = NULL;
+	char* k;
+	bool object, child_kept;
+	int ret;
+	*kept = false;
+	if (node->whole) {
+		*kept = true;
+		return lept_parse_value(c, h);
+	}
+	if (c->json == c->end)
+		return LEPT_PARSE_EXPECT_VALUE;
+	if (*c->json != '[' && *c->json != '{')
+		return lept_skip_projected(c);
+	object = *c->json++ == '{';
+	lept_parse_whitespace(c);
+	if (object && node->count > 64) {
+		many = (bool*)lept_mem_calloc(node->count, sizeof(bool));
+		assert(many != NULL);
+	}
+	ret = LEPT_PARSE_OK;
+	if (!PEEK(c, object ? '}' : ']')) {
+		for (i = 0; ; i++) {
+			if (object) {
+				if (!PEEK(c, '"')) {
+					ret = LEPT_PARSE_MISS_KEY;
+					break;
+				}
+				if ((ret = lept_parse_string_raw(c, &k, &klen)) != LEPT_PARSE_OK)
+					break;
+				if ((child = lept_path_member(node, k, klen, &at)) != NULL) {
+					if (many ? many[at] : (seen >> at & 1) != 0)
+						child = NULL;
+					else if (many)
+						many[at] = true;
+					else
+						seen |= (uint64_t)1 << at;
+				}
+				if (child)
+					h.key(k, klen);
+				lept_parse_whitespace(c);
+				if (!PEEK(c, ':')) {
+					ret = LEPT_PARSE_MISS_COLON;
+					break;
+				}
+				c->json++;
+				lept_parse_whitespace(c);
+			}
+			else if ((child = lept_path_element(node, i)) != NULL)
+				for (; size < i; size++)
+					h.null();
+			if (!child)
+				ret = lept_skip_projected(c);
+			else if ((ret = lept_parse_projected_value(c, h, child, &child_kept)) == LEPT_PARSE_OK) {
+				if (child_kept)
+					size++;
+				else if (object)
+					lept_free((lept_value*)lept_context_pop(c, sizeof(lept_value)));	/* its key */
+				else {
+					h.null();
+					size++;
+				}
+			}
+			if (ret != LEPT_PARSE_OK)
+				break;
+			lept_parse_whitespace(c);
+			if (PEEK(c, ',')) {
+				c->json++;
+				lept_parse_whitespace(c);
+			}
+			else if (PEEK(c, object ? '}' : ']'))
+				break;
+			else {
+				ret = object ? LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET : LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET;
+				break;
+			}
+		}
+	}
+	if (many)
+		lept_mem_free(many, node->count * sizeof(bool));
+	if (ret != LEPT_PARSE_OK)
+		return ret;
+	c->json++;
+	*kept = true;
+	return lept_handled(object ? h.end_object(size) : h.end_array(size));
+}
+
+int lept_parse_projected(lept_value* v, const char* json, size_t len, const lept_path_set* paths) {
+	lept_context c;
+	bool kept;
+	int ret;
+	assert(v != NULL && (json != NULL || len == 0) && paths != NULL);
+	lept_init(v);
+	lept_context_init(&c, json, len);
+	lept_dom_handler h(&c);
+	lept_parse_whitespace(&c);
+	if ((ret = lept_parse_projected_value(&c, h, &paths->root, &kept)) == LEPT_PARSE_OK) {
+		lept_parse_whitespace(&c);
+		if (c.json != c.end)
+			ret = LEPT_PARSE_ROOT_NOT_SINGULAR;
+	}
+	if (ret == LEPT_PARSE_OK && kept)
+		h.pop(v);
+	else
+		h.discard();
+	lept_context_free(&c);
+	return ret;
+}
+
+lept_value* lept_pointer_get(const lept_value* v, const char* pointer) {
+	lept_context c;
+	size_t len, index;
+	const char* key;
+	assert(v != NULL && pointer != NULL);
+	if (*pointer != '\0' && *pointer != '/')
+		return NULL;
+	lept_context_init(&c, NULL, 0);
+	while (v && *pointer) {
+		if (!(pointer = lept_pointer_token(&c, pointer + 1))) {
+			v = NULL;
+			break;
+		}
+		len = c.top;
+		key = len ? (const char*)lept_context_pop(&c, len) : "";
+		if (v->type == LEPT_OBJECT)
+			v = (index = lept_find_object_index(v, key, len)) != LEPT_KEY_NOT_EXIST ? lept_get_object_value(v, index) : NULL;
+		else if (v->type == LEPT_ARRAY)
+			v = (index = lept_pointer_index(key, len)) < v->u.a.size ? &v->u.a.e[index] : NULL;
+		else
+			v = NULL;
+	}
+	lept_context_free(&c);
+	return (lept_value*)v;
+}
+
+/*
+	Binary snapshot, all integers little-endian and every item 8-byte aligned:
+	  header: "LJSB", u32 version, u64 size, u64 root, u64 checksum
+	  number: the bits of the double
+	  string: u64 length, the bytes, a terminator, padding
+	  array:  u64 count, then a node per element
+	  object: u64 count, then (u64 offset of the key string, node of the value) per member
+	A node is the offset of its item (0 for null, false and true) or'ed with its lept_type. Items
+	refer to each other by offsets from the start, so the snapshot can be used wherever it is loaded,
+	and the tables give any element or member in O(1). Equal keys share one string. Children come
+	after their container, which lets lept_load_binary() rule out cycles.
+	The checksum is a multiply-xor hash of every word but its own.
+*/
+const unsigned LEPT_BINARY_VERSION = 1;
+const size_t LEPT_BINARY_HEADER_SIZE = 32;
+
+inline void lept_put_u64(char* p, uint64_t x) {
+	int i;
+	for (i = 0; i < 8; i++)
+		p[i] = (char)(x >> (8 * i));
+}
+
+inline uint64_t lept_get_u64(const char* p) {
+	uint64_t x = 0;
+	int i;
+	for (i = 7; i >= 0; i--)
+		x = x << 8 | (unsigned char)p[i];
+	return x;
+}
+
+static uint64_t lept_checksum(uint64_t h, const char* p, size_t words) {
+	for (; words; words--, p += 8) {
+		h = (h ^ lept_get_u64(p)) * LEPT_U64(0x9e3779b9, 0x7f4a7c15);
+		h ^= h >> 29;
+	}
+	return h;
+}
+
+static uint64_t lept_binary_checksum(const char* data, size_t size) {
+	return lept_checksum(lept_checksum(LEPT_BINARY_VERSION, data, 3), data + LEPT_BINARY_HEADER_SIZE, (size - LEPT_BINARY_HEADER_SIZE) / 8);
+}
+
+/* Keys written so far, by offset + 1 in the output (0: empty slot) */
+struct lept_binary_keys {
+	size_t* slots;
+	size_t mask, count;
+};
+
+/* Zeroed, aligned room at the end of the output, returns its offset */
+static size_t lept_binary_reserve(lept_context* c, size_t size) {
+	size_t off = c->top;
+	memset(lept_context_push(c, size), 0, size);
+	return off;
+}
+
+static size_t lept_binary_string(lept_context* c, const char* s, size_t len) {
+	size_t off = lept_binary_reserve(c, 8 + ((len + 8) & ~(size_t)7));	/* the terminator is in the padding */
+	lept_put_u64(c->stack + off, len);
+	if (len)
+		memcpy(c->stack + off + 8, s, len);
+	return off;
+}
+
+static size_t lept_binary_key(lept_context* c, lept_binary_keys* keys, const char* k, size_t klen) {
+	size_t i, j, off;
+	if (2 * (keys->count + 1) > keys->mask + 1) {
+		lept_binary_keys grown;
+		grown.mask = keys->mask ? 2 * keys->mask + 1 : 255;
+		grown.slots = (size_t*)lept_mem_calloc(grown.mask + 1, sizeof(size_t));
+		for (i = 0; keys->slots && i <= keys->mask; i++)
+			if ((off = keys->slots[i]) != 0) {
+				const char* p = c->stack + off - 1;
+				for (j = lept_hash_key(p + 8, (size_t)lept_get_u64(p)) & grown.mask; grown.slots[j]; j = (j + 1) & grown.mask)
+					;
+				grown.slots[j] = off;
+			}
+		lept_mem_free(keys->slots, 0);
+		keys->slots = grown.slots;
+		keys->mask = grown.mask;
+	}
+	for (i = lept_hash_key(k, klen) & keys->mask; (off = keys->slots[i]) != 0; i = (i + 1) & keys->mask) {
+		const char* p = c->stack + off - 1;
+		if (lept_get_u64(p) == klen && memcmp(p + 8, k, klen) == 0)
+			return off - 1;
+	}
+	off = lept_binary_string(c, k, klen);
+	keys->slots[i] = off + 1;
+	keys->count++;
+	return off;
+}
+
+/* The item of v, a container with its table only: returns its node */
+static uint64_t lept_binary_item(lept_context* c, const lept_value* v) {
+	size_t off, n;
+	uint64_t bits;
+	switch (v->type) {
+		case LEPT_NUMBER:
+			off = lept_binary_reserve(c, 8);
+			memcpy(&bits, &v->u.n, sizeof(bits));
+			lept_put_u64(c->stack + off, bits);
+			break;
+		case LEPT_STRING:
+			off = lept_binary_string(c, v->u.s.s, v->u.s.len);
+			break;
+		case LEPT_ARRAY:
+			n = v->u.a.size;
+			off = lept_binary_reserve(c, 8 + 8 * n);
+			lept_put_u64(c->stack + off, n);
+			break;
+		case LEPT_OBJECT:
+			n = lept_get_object_size(v);
+			off = lept_binary_reserve(c, 8 + 16 * n);
+			lept_put_u64(c->stack + off, n);
+			break;
+		default:
+			off = 0;
+	}
+	return (uint64_t)off | v->type;
+}
+
+/* Writes the items in pre-order: a container, then each key the first time it is used and each value */
+static uint64_t lept_binary_value(lept_context* c, lept_binary_keys* keys, const lept_value* v) {
+	lept_walk w;
+	uint64_t root = lept_binary_item(c, v), bits;
+	lept_walk_init(&w);
+	if (v->type == LEPT_ARRAY || v->type == LEPT_OBJECT) {
+		lept_walk_push(&w, v);
+		w.frames[0].off = (size_t)(root & ~(uint64_t)7);
+	}
+	while (w.depth) {
+		lept_walk_frame* f = &w.frames[w.depth - 1];
+		const lept_value* e;
+		size_t off = f->off;	/* the output may move, so tables are written by offset */
+		if (f->i == (f->v->type == LEPT_ARRAY ? f->v->u.a.size : lept_get_object_size(f->v))) {
+			w.depth--;
+			continue;
+		}
+		if (f->v->type == LEPT_ARRAY) {
+			bits = lept_binary_item(c, e = &f->v->u.a.e[f->i]);
+			lept_put_u64(c->stack + off + 8 + 8 * f->i, bits);
+		}
+		else {
+			bits = lept_binary_key(c, keys, lept_get_object_key(f->v, f->i), lept_get_object_key_length(f->v, f->i));
+			lept_put_u64(c->stack + off + 8 + 16 * f->i, bits);
+			bits = lept_binary_item(c, e = lept_get_object_value(f->v, f->i));
+			lept_put_u64(c->stack + off + 16 + 16 * f->i, bits);
+		}
+		f->i++;
+		if (e->type == LEPT_ARRAY || e->type == LEPT_OBJECT) {
+			lept_walk_push(&w, e);
+			w.frames[w.depth - 1].off = (size_t)(bits & ~(uint64_t)7);
+		}
+	}
+	lept_walk_free(&w);
+	return root;
+}
+
+char* lept_serialize_binary(const lept_value* v, size_t* size) {
 	lept_context c;
+	lept_binary_keys keys;
+	uint64_t root;
 	assert(v != NULL);
-	c.stack = (char*)malloc(c.size = LEPT_PARSE_STRINGIFY_INIT_SIZE);
-	c.top = 0;
-	lept_stringify_value(&c, v);
-	if (length)
-		*length = c.top;
-	PUTC(&c, '\0');
+	lept_context_init(&c, NULL, 0);
+	keys.slots = NULL;
+	keys.mask = keys.count = 0;
+	lept_binary_reserve(&c, LEPT_BINARY_HEADER_SIZE);
+	root = lept_binary_value(&c, &keys, v);
+	lept_mem_free(keys.slots, 0);
+	memcpy(c.stack, "LJSB", 4);
+	c.stack[4] = (char)LEPT_BINARY_VERSION;
+	lept_put_u64(c.stack + 8, c.top);
+	lept_put_u64(c.stack + 16, root);
+	lept_put_u64(c.stack + 24, lept_binary_checksum(c.stack, c.top));
+	if (size)
+		*size = c.top;
 	return c.stack;
 }
 
-lept_type lept_get_type(const lept_value* v) {
-	assert(v != NULL);
-	return v->type;
+int lept_binary_open(lept_binary_view* b, const void* data, size_t size) {
+	const char* p = (const char*)data;
+	assert(b != NULL && (data != NULL || size == 0));
+	if (size < LEPT_BINARY_HEADER_SIZE || size % 8 != 0 || memcmp(p, "LJSB", 4) != 0
+		|| lept_get_u64(p + 4) << 32 != (uint64_t)LEPT_BINARY_VERSION << 32	/* the u32 version */
+		|| lept_get_u64(p + 8) != size || lept_get_u64(p + 16) >= size
+		|| lept_get_u64(p + 24) != lept_binary_checksum(p, size))
+		return LEPT_BINARY_INVALID;
+	b->data = p;
+	b->size = size;
+	b->root = (size_t)lept_get_u64(p + 16);
+	return LEPT_BINARY_OK;
 }
 
-void lept_set_null(lept_value* v) {
-	assert(v != NULL);
-	lept_free(v);
+/*
+	Loads the item of a node into v: a scalar, or a container with room for its elements or members.
+	The items must be where lept_serialize_binary() writes them, each at *next, so that no value is
+	referenced twice and a snapshot cannot expand; only keys point back at strings written before.
+*/
+static bool lept_binary_load_item(const lept_binary_view* b, uint64_t node, size_t* next, lept_value* v) {
+	size_t off = (size_t)(node & ~(uint64_t)7), n, len;
+	const char* p = b->data + off;
+	lept_init(v);
+	if ((node & 7) > LEPT_OBJECT || (off == 0) != ((node & 7) < LEPT_NUMBER) || (off != 0 && (off != *next || off == b->size)))
+		return false;
+	switch (node & 7) {
+		case LEPT_NUMBER:
+			lept_set_number(v, lept_binary_get_number(b, (size_t)node));
+			*next = off + 8;
+			return true;
+		case LEPT_STRING:
+			if ((len = (size_t)lept_get_u64(p)) >= b->size - off - 8)
+				return false;
+			lept_set_string(v, p + 8, len);
+			*next = off + 8 + ((len + 8) & ~(size_t)7);
+			return true;
+		case LEPT_ARRAY:
+			if ((n = (size_t)lept_get_u64(p)) > (b->size - off - 8) / 8)
+				return false;
+			v->type = LEPT_ARRAY;
+			v->u.a.size = 0;
+			v->u.a.capacity = n;
+			v->u.a.hash = NULL;
+			v->u.a.e = n ? (lept_value*)lept_mem_alloc(n * sizeof(lept_value)) : NULL;
+			*next = off + 8 + 8 * n;
+			return true;
+		case LEPT_OBJECT:
+			if ((n = (size_t)lept_get_u64(p)) > (b->size - off - 8) / 16)
+				return false;
+			v->type = LEPT_OBJECT;
+			v->u.o.size = 0;
+			v->u.o.capacity = n;
+			v->u.o.index = NULL;
+			v->u.o.m = n ? (lept_member*)lept_mem_alloc(n * sizeof(lept_member)) : NULL;
+			*next = off + 8 + 16 * n;
+			return true;
+		default:
+			v->type = (lept_type)(node & 7);
+			return true;
+	}
 }
 
-bool lept_get_boolean(const lept_value* v) {
-	assert(v != NULL && (v->type == LEPT_TRUE || v->type == LEPT_FALSE));
-	return v->type == LEPT_TRUE;
+/* A key is the string at *next, or one written before: returns it or NULL */
+static const char* lept_binary_load_key(const lept_binary_view* b, uint64_t k, size_t* next, size_t* len) {
+	size_t off = (size_t)k;
+	if ((k & 7) != 0 || off < LEPT_BINARY_HEADER_SIZE || off > *next || off == b->size
+		|| (*len = (size_t)lept_get_u64(b->data + off)) >= b->size - off - 8)
+		return NULL;
+	if (off == *next)
+		*next = off + 8 + ((*len + 8) & ~(size_t)7);
+	return b->data + off + 8;
 }
 
-void lept_set_boolean(lept_value* v, bool b) {
-	lept_free(v);
-	v->type = b ? LEPT_TRUE : LEPT_FALSE;
+/* Rebuilds a value in pre-order without recursion, the containers nested at most max depth deep */
+static bool lept_binary_load(const lept_binary_view* b, lept_value* v) {
+	lept_walk w;
+	size_t next = LEPT_BINARY_HEADER_SIZE, max_depth = lept_get_max_depth();
+	uint64_t node = b->root;
+	bool ok = lept_binary_load_item(b, node, &next, v);
+	lept_walk_init(&w);
+	if (ok && (v->type == LEPT_ARRAY || v->type == LEPT_OBJECT)) {
+		lept_walk_push(&w, v);
+		w.frames[0].off = (size_t)(node & ~(uint64_t)7);
+	}
+	while (ok && w.depth) {
+		lept_walk_frame* f = &w.frames[w.depth - 1];
+		lept_value* c = (lept_value*)f->v, *e;
+		const char* p = b->data + f->off;
+		if (f->i == (c->type == LEPT_ARRAY ? c->u.a.capacity : c->u.o.capacity)) {
+			w.depth--;
+			continue;
+		}
+		if (c->type == LEPT_ARRAY) {
+			e = &c->u.a.e[f->i];
+			if ((ok = lept_binary_load_item(b, node = lept_get_u64(p + 8 + 8 * f->i), &next, e)))
+				c->u.a.size++;	/* the elements loaded go with v on failure */
+		}
+		else {
+			lept_member* m = &c->u.o.m[f->i];
+			const char* k;
+			size_t klen;
+			e = &m->v;
+			ok = (k = lept_binary_load_key(b, lept_get_u64(p + 8 + 16 * f->i), &next, &klen)) != NULL
+				&& lept_binary_load_item(b, node = lept_get_u64(p + 16 + 16 * f->i), &next, e);
+			if (ok) {
+				m->k = (char*)lept_mem_alloc(klen + 1);
+				memcpy(m->k, k, klen);
+				m->k[klen] = '\0';
+				m->klen = klen;
+				c->u.o.size++;
+			}
+		}
+		f->i++;
+		if (ok && (e->type == LEPT_ARRAY || e->type == LEPT_OBJECT)) {
+			if (!(ok = w.depth < max_depth))
+				break;
+			lept_walk_push(&w, e);
+			w.frames[w.depth - 1].off = (size_t)(node & ~(uint64_t)7);
+		}
+	}
+	lept_walk_free(&w);
+	return ok && next == b->size;	/* nothing left over */
 }
 
-double lept_get_number(const lept_value* v) {
-	assert(v != NULL && v->type == LEPT_NUMBER);
-	return v->u.n;
+int lept_load_binary(lept_value* v, const void* data, size_t size) {
+	lept_binary_view b;
+	int ret;
+	assert(v != NULL);
+	lept_init(v);
+	if ((ret = lept_binary_open(&b, data, size)) != LEPT_BINARY_OK)
+		return ret;
+	if (!lept_binary_load(&b, v)) {
+		lept_free(v);
+		return LEPT_BINARY_INVALID;
+	}
+	return LEPT_BINARY_OK;
 }
 
-void lept_set_number(lept_value* v, double n) {
-	lept_free(v);
-	v->type = LEPT_NUMBER;
-	v->u.n = n;
+lept_type lept_binary_get_type(const lept_binary_view* b, size_t node) {
+	assert(b != NULL);
+	return (lept_type)(node & 7);
 }
 
-const char* lept_get_string(const lept_value* v) {
-	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.s;
+bool lept_binary_get_boolean(const lept_binary_view* b, size_t node) {
+	assert(b != NULL && ((node & 7) == LEPT_TRUE || (node & 7) == LEPT_FALSE));
+	return (node & 7) == LEPT_TRUE;
 }
 
-size_t lept_get_string_length(const lept_value* v) {
-	assert(v != NULL && v->type == LEPT_STRING);
-	return v->u.s.len;
+double lept_binary_get_number(const lept_binary_view* b, size_t node) {
+	uint64_t bits;
+	double n;
+	assert(b != NULL && (node & 7) == LEPT_NUMBER);
+	bits = lept_get_u64(b->data + (node & ~(size_t)7));
+	memcpy(&n, &bits, sizeof(n));
+	return n;
 }
 
-void lept_set_string(lept_value* v, const char* s, size_t len) {
-	assert(v != NULL && (s != NULL || len == 0));
-	lept_free(v);
-	v->type = LEPT_STRING;
-	v->u.s.s = (char*)malloc(len + 1);
-	memcpy(v->u.s.s, s, len);	// 滻memcpy_s?
-	v->u.s.s[len] = '\0';
-	v->u.s.len = len;
+const char* lept_binary_get_string(const lept_binary_view* b, size_t node) {
+	assert(b != NULL && (node & 7) == LEPT_STRING);
+	return b->data + (node & ~(size_t)7) + 8;
 }
 
-size_t lept_get_array_size(const lept_value* v)
-{
-	assert(v != NULL && v->type == LEPT_ARRAY);
-	return v->u.a.size;
+size_t lept_binary_get_string_length(const lept_binary_view* b, size_t node) {
+	assert(b != NULL && (node & 7) == LEPT_STRING);
+	return (size_t)lept_get_u64(b->data + (node & ~(size_t)7));
 }
 
-lept_value* lept_get_array_element(const lept_value* v, size_t index)
-{
-	assert(v != NULL&&v->type == LEPT_ARRAY);
-	assert(index < v->u.a.size);
-	return &v->u.a.e[index];
+size_t lept_binary_get_array_size(const lept_binary_view* b, size_t node) {
+	assert(b != NULL && (node & 7) == LEPT_ARRAY);
+	return (size_t)lept_get_u64(b->data + (node & ~(size_t)7));
 }
 
-size_t lept_get_object_size(const lept_value* v)
-{
-	assert(v != NULL && v->type == LEPT_OBJECT);
-	return v->u.o.size;
+size_t lept_binary_get_array_element(const lept_binary_view* b, size_t node, size_t index) {
+	assert(index < lept_binary_get_array_size(b, node));
+	return (size_t)lept_get_u64(b->data + (node & ~(size_t)7) + 8 + 8 * index);
 }
 
-const char* lept_get_object_key(const lept_value* v, size_t index)
-{
-	assert(v != NULL && v->type == LEPT_OBJECT);
-	assert(index < v->u.o.size);
-	return v->u.o.m[index].k;
+size_t lept_binary_get_object_size(const lept_binary_view* b, size_t node) {
+	assert(b != NULL && (node & 7) == LEPT_OBJECT);
+	return (size_t)lept_get_u64(b->data + (node & ~(size_t)7));
 }
 
-size_t lept_get_object_key_length(const lept_value * v, size_t index)
-{
-	assert(v != NULL && v->type == LEPT_OBJECT);
-	assert(index < v->u.o.size);
-	return v->u.o.m[index].klen;
+const char* lept_binary_get_object_key(const lept_binary_view* b, size_t node, size_t index) {
+	assert(index < lept_binary_get_object_size(b, node));
+	return b->data + lept_get_u64(b->data + (node & ~(size_t)7) + 8 + 16 * index) + 8;
 }
 
-lept_value* lept_get_object_value(const lept_value* v, size_t index)
-{
-	assert(v != NULL && v->type == LEPT_OBJECT);
-	assert(index < v->u.o.size);
-	return &v->u.o.m[index].v;
+size_t lept_binary_get_object_key_length(const lept_binary_view* b, size_t node, size_t index) {
+	assert(index < lept_binary_get_object_size(b, node));
+	return (size_t)lept_get_u64(b->data + lept_get_u64(b->data + (node & ~(size_t)7) + 8 + 16 * index));
+}
+
+size_t lept_binary_get_object_value(const lept_binary_view* b, size_t node, size_t index) {
+	assert(index < lept_binary_get_object_size(b, node));
+	return (size_t)lept_get_u64(b->data + (node & ~(size_t)7) + 16 + 16 * index);
 }
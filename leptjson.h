@@ -1,6 +1,10 @@
 #ifndef LEPTJSON_H__
 #define LEPTJSON_H__
 
+#include <stddef.h> /* size_t */
+#include <stdio.h> /* FILE */
+#include <stdint.h> /* uint64_t */
+
 enum lept_type {
 	LEPT_NULL,
 	LEPT_FALSE,
@@ -12,15 +16,26 @@ enum lept_type {
 };
 
 typedef struct lept_member lept_member; // Forward Declaration
+typedef struct lept_object_index lept_object_index;
+typedef struct lept_shape lept_shape;
+typedef struct lept_hash_cache lept_hash_cache;
+
+enum lept_flag {
+	LEPT_FLAG_BORROWED = 1,	/* storage is owned elsewhere (arena, input buffer), lept_free() does not release it */
+	LEPT_FLAG_BORROWED_KEYS = 2,	/* object member keys point into the input buffer */
+	LEPT_FLAG_SHAPED = 4	/* object stored as u.sh: its keys are in a shared shape */
+};
 
 struct lept_value {
 	union {
-		struct { lept_member* m; size_t size; } o; /* object */
-		struct { lept_value* e; size_t size; } a; /* array */
+		struct { lept_member* m; size_t size, capacity; lept_object_index* index; } o; /* object, index: NULL until a lookup or lept_hash() needs it */
+		struct { lept_value* v; size_t size; lept_shape* shape; lept_hash_cache* hash; } sh; /* shaped object: values in the order of the shape keys */
+		struct { lept_value* e; size_t size, capacity; lept_hash_cache* hash; } a; /* array, hash: NULL until lept_hash() caches it */
 		struct { char* s; size_t len; } s; /* string: null-terminated string, string length */
 		double n; /* number */
 	} u;
 	lept_type type;
+	unsigned flags;	/* combination of lept_flag */
 };
 
 struct lept_member {
@@ -43,17 +58,176 @@ enum lept_status {
 	LEPT_PARSE_MISS_KEY,
 	LEPT_PARSE_MISS_COLON,
 	LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET,
-	LEPT_STRINGIFY_OK
+	LEPT_PARSE_FILE_ERROR,	// lept_parse_file() cannot open or map the file
+	LEPT_PARSE_ABORTED,	// A lept_handler callback returned false
+	LEPT_PARSE_TOO_DEEP,	// Arrays and objects are nested deeper than lept_set_max_depth() allows
+	LEPT_STRINGIFY_OK,
+	LEPT_STRINGIFY_SINK_ERROR,	// The write callback of a lept_sink returned false
+	LEPT_BINARY_OK,
+	LEPT_BINARY_INVALID	// Not a binary snapshot of this version, truncated, or its checksum does not match
+};
+
+/*
+	Region allocator: strings, elements and members of the values parsed into an arena are
+	bump-allocated from a few large blocks and are all released at once by lept_arena_reset().
+*/
+typedef struct lept_arena_block lept_arena_block;
+
+struct lept_arena {
+	lept_arena_block* head;	/* current block, older blocks are chained behind it */
+	size_t block_size;
+};
+
+/*
+	Push parser: the document is fed in chunks of any size as they arrive, and the same tree (or the same
+	error status) as lept_parse() on the concatenated input is produced by lept_push_parser_finish().
+*/
+typedef struct lept_push_parser lept_push_parser;
+
+/*
+	Reusable contexts for many small documents: a parser keeps its scratch stack and a writer its
+	output buffer from one call to the next. A buffer that grew past keep bytes is cut back to keep
+	when the call is done with it, keep == 0 keeps it at any size.
+*/
+typedef struct lept_parser lept_parser;
+typedef struct lept_writer lept_writer;
+
+/*
+	SAX-style events, in document order. A callback returns false to stop the parse with
+	LEPT_PARSE_ABORTED, a NULL callback ignores its event. Strings and keys are decoded but not
+	terminated, and are only valid during the callback. end_* callbacks receive the number of
+	elements or members.
+*/
+struct lept_handler {
+	bool (*null)(void* user);
+	bool (*boolean)(void* user, bool b);
+	bool (*number)(void* user, double n);
+	bool (*string)(void* user, const char* s, size_t len);
+	bool (*key)(void* user, const char* s, size_t len);
+	bool (*start_object)(void* user);
+	bool (*end_object)(void* user, size_t size);
+	bool (*start_array)(void* user);
+	bool (*end_array)(void* user, size_t size);
+};
+
+/*
+	Allocator: the library allocates only through these functions, malloc(), realloc() and free() by
+	default, and the buffers it returns to be free()d are released with deallocate(). Set it before
+	the library allocates anything, or after everything it allocated has been released.
+*/
+struct lept_allocator {
+	void* (*allocate)(void* user, size_t size);
+	void* (*reallocate)(void* user, void* p, size_t size);	/* p may be NULL */
+	void (*deallocate)(void* user, void* p);	/* p may be NULL */
+	void* user;
+};
+
+/*
+	Allocation counters of the calling thread, for example around one parse or stringify. Frees of
+	a size the library does not track are not subtracted, so held and peak are upper bounds.
+*/
+struct lept_alloc_stats {
+	size_t allocs;	/* calls to allocate() and reallocate() */
+	size_t bytes;	/* bytes they requested */
+	size_t held, peak;	/* bytes held now, and at most */
+	size_t stack;	/* largest scratch stack (parse) or output buffer (stringify) */
+};
+
+/*
+	Shape of a parsed document, from lept_parse_ex(). Keys are counted apart from string values and
+	both add their decoded length to string_bytes, depth is 0 for a scalar and 1 for a flat container.
+	On an error the counts cover the input up to the error and bytes is its offset.
+*/
+struct lept_parse_stats {
+	size_t values[LEPT_OBJECT + 1];	/* indexed by lept_type */
+	size_t keys;
+	size_t depth;	/* deepest nesting */
+	size_t string_bytes, escapes;
+	size_t largest_array, largest_object;	/* most elements, most members */
+	size_t integers, non_integers;	/* numbers without and with a fraction or exponent */
+	size_t bytes;	/* input consumed */
 };
 
 /* API */
+void lept_set_allocator(const lept_allocator* a);	/* NULL restores the default */
+void lept_count_allocs(lept_alloc_stats* stats);	/* zeroes *stats and counts into it until called with NULL */
+void lept_set_max_depth(size_t depth);	/* process-wide, for the parses started afterwards in any thread, 0 restores the default of 1024, (size_t)-1 has no limit */
+
 void lept_init(lept_value* v);
 
 void lept_free(lept_value* v);
 
 int lept_parse(lept_value* v, const char* json);
+int lept_parse_n(lept_value* v, const char* json, size_t len);	/* json[0..len), no terminator needed, '\0' is an ordinary byte */
+int lept_parse_ex(lept_value* v, const char* json, lept_parse_stats* stats);	/* lept_parse() that also fills *stats unless NULL */
+int lept_parse_file(lept_value* v, const char* path);	/* maps the file read-only and parses it without a copy */
+int lept_parse_sax(const char* json, size_t len, const lept_handler* h, void* user);	/* no tree is built */
+int lept_parse_parallel(lept_value* v, const char* json, size_t len, unsigned threads);	/* same result and status as lept_parse_n(), threads == 0: one per processor */
+
+lept_push_parser* lept_push_parser_create();
+void lept_push_parser_destroy(lept_push_parser* p);
+int lept_push_parser_feed(lept_push_parser* p, const char* chunk, size_t len);	/* LEPT_PARSE_OK so far, or the (sticky) error */
+int lept_push_parser_finish(lept_push_parser* p, lept_value* v);	/* ends the document and resets the parser for the next one */
+
+lept_parser* lept_parser_create(size_t keep);
+void lept_parser_destroy(lept_parser* p);
+int lept_parser_parse(lept_parser* p, lept_value* v, const char* json, size_t len);	/* lept_parse_n() on the kept stack */
+
+/*
+	Parses into v, which holds a value (or is a null value), and reuses its storage where the new
+	document has the same shape: the string buffers that are long enough, keys with the same bytes,
+	and the elements or members of arrays and objects with enough capacity (which they keep). The
+	rest of the old value is freed. p may be NULL.
+*/
+int lept_parse_into(lept_parser* p, lept_value* v, const char* json, size_t len);
+
+void lept_arena_init(lept_arena* a, size_t block_size);	/* block_size == 0 selects the default */
+void lept_arena_reset(lept_arena* a);	/* invalidates every value parsed into the arena */
+void lept_arena_free(lept_arena* a);
+int lept_parse_arena(lept_value* v, const char* json, lept_arena* a);
+
+/* Objects with the same key sequence share one copy of their keys and store only their values */
+int lept_parse_shaped(lept_value* v, const char* json);
+
+/* Destructive parse: escapes are decoded inside json and strings/keys point into it, json must outlive v */
+int lept_parse_insitu(lept_value* v, char* json);
+
+/*
+	Newline-delimited JSON (JSON Lines): one document per line, parsed by several threads. The
+	callback receives every non-blank line with its 1-based line number and its status, v holds the
+	value (a null value on an error) and is freed after the callback, which may take the value over by
+	copying *v and calling lept_init(v). Returning false stops the parse with LEPT_PARSE_ABORTED.
+	Callbacks are never concurrent; they come in line order unless unordered is set, in which case
+	lines come in the order their chunks finish (still in order inside a chunk).
+*/
+struct lept_ndjson_options {
+	unsigned threads;	/* 0: one per online processor */
+	bool unordered;
+	size_t chunk_size;	/* bytes a thread parses at a time, 0 selects the default */
+};
+
+typedef bool (*lept_ndjson_callback)(void* user, size_t line, int status, lept_value* v);
+
+int lept_parse_ndjson(const char* json, size_t len, const lept_ndjson_options* options, lept_ndjson_callback callback, void* user);	/* options may be NULL */
+int lept_parse_ndjson_file(const char* path, const lept_ndjson_options* options, lept_ndjson_callback callback, void* user);
+
+/*
+	Output of lept_stringify_to(): write() receives the text in pieces from a fixed-size buffer, and
+	returns false on an error, after which nothing more is written.
+*/
+struct lept_sink {
+	bool (*write)(void* user, const char* data, size_t len);
+	void* user;
+};
 
 char* lept_stringify(const lept_value* v, size_t* length);
+int lept_stringify_to(const lept_value* v, const lept_sink* sink);	/* LEPT_STRINGIFY_OK or LEPT_STRINGIFY_SINK_ERROR */
+
+lept_writer* lept_writer_create(size_t keep);
+void lept_writer_destroy(lept_writer* w);
+const char* lept_writer_stringify(lept_writer* w, const lept_value* v, size_t* length);	/* owned by w, valid until its next call */
+lept_sink lept_sink_file(FILE* fp);
+lept_sink lept_sink_fd(int fd);	/* a file descriptor, or a CRT handle on Windows */
 
 lept_type lept_get_type(const lept_value* v);
 
@@ -69,12 +243,152 @@ const char* lept_get_string(const lept_value* v);
 size_t lept_get_string_length(const lept_value* v);
 void lept_set_string(lept_value* v, const char* s, size_t len);
 
+/*
+	Containers grow geometrically, so appending is amortized O(1). Element and member pointers are
+	invalidated by any change to their container. Changing a shaped, arena or in-situ container first
+	gives it storage (and keys) of its own; its descendants are unchanged.
+*/
+void lept_set_array(lept_value* v, size_t capacity);	/* an empty array */
 size_t lept_get_array_size(const lept_value* v);
+size_t lept_get_array_capacity(const lept_value* v);
+void lept_reserve_array(lept_value* v, size_t capacity);
+void lept_shrink_array(lept_value* v);	/* the capacity becomes the size */
+void lept_clear_array(lept_value* v);	/* keeps the capacity */
 lept_value* lept_get_array_element(const lept_value* v, size_t index);
+lept_value* lept_pushback_array_element(lept_value* v);	/* a new null element */
+void lept_popback_array_element(lept_value* v);
+lept_value* lept_insert_array_element(lept_value* v, size_t index);	/* index <= size */
+void lept_erase_array_element(lept_value* v, size_t index, size_t count);
 
+void lept_set_object(lept_value* v, size_t capacity);	/* an empty object */
 size_t lept_get_object_size(const lept_value* v);
+size_t lept_get_object_capacity(const lept_value* v);
+void lept_reserve_object(lept_value* v, size_t capacity);
+void lept_shrink_object(lept_value* v);
+void lept_clear_object(lept_value* v);
 const char* lept_get_object_key(const lept_value* v, size_t index);
 size_t lept_get_object_key_length(const lept_value* v, size_t index);
 lept_value* lept_get_object_value(const lept_value* v, size_t index);
+lept_value* lept_set_object_value(lept_value* v, const char* key, size_t klen);	/* the value of the first member with key, a new null one if there is none */
+void lept_remove_object_value(lept_value* v, size_t index);
+
+#define LEPT_KEY_NOT_EXIST ((size_t)-1)
+
+/* Hashed lookup in large objects: the first lookup indexes the object, concurrent first lookups must be serialized */
+size_t lept_find_object_index(const lept_value* v, const char* key, size_t klen);	/* first member with this key */
+lept_value* lept_find_object_value(lept_value* v, const char* key, size_t klen);	/* NULL if there is none */
+
+/* Objects with the same non-NULL shape have the same keys at the same indices, a found index can be reused */
+const lept_shape* lept_get_object_shape(const lept_value* v);
+
+/*
+	Structural hash: equal values have equal hashes, whatever the order of their object members.
+	Containers of at least 16 elements or members cache their hash. lept_hash() labels the tree it
+	hashes, and a change through this API to a value of a labeled tree drops the hashes cached in
+	that tree only, so a change below a container drops its hash too; writing to the fields of a
+	lept_value directly does not. lept_init() and the parse functions do not read the old value:
+	free a value of a hashed tree before parsing into it. As with lookups, concurrent first calls
+	on a tree must be serialized.
+	lept_is_equal() compares the member multisets, as the hash does: member order does not matter
+	and duplicated keys match one to one. It first rejects containers of different sizes or
+	different cached hashes.
+*/
+uint64_t lept_hash(const lept_value* v);
+bool lept_is_equal(const lept_value* a, const lept_value* b);
+
+/*
+	JSON Pointer (RFC 6901) paths, where a "*" token also matches every array element. A projected
+	parse builds only the values on the paths, with the enclosing containers, and skips the rest
+	without decoding it: skipped values are only checked for matching brackets and quotes. Array
+	elements keep their index (elements before a kept one become null) and a path follows only the
+	first member of a duplicated key, so a pointer of the set finds the same value in the projection
+	as in the whole document.
+*/
+typedef struct lept_path_set lept_path_set;
+
+lept_path_set* lept_path_set_create(const char* const* pointers, size_t count);	/* NULL if a pointer is malformed */
+void lept_path_set_destroy(lept_path_set* s);
+int lept_parse_projected(lept_value* v, const char* json, size_t len, const lept_path_set* paths);
+lept_value* lept_pointer_get(const lept_value* v, const char* pointer);	/* NULL if there is no such value */
+
+/*
+	Flat document: the parse result as one tape of 64-bit words, with scalars inline, containers
+	that know where they end, and the strings in one side buffer. A node is a tape offset and the root
+	is node 0. The buffers are kept by the next parse, and are valid until then.
+*/
+typedef struct lept_document lept_document;
+
+lept_document* lept_document_create();
+void lept_document_destroy(lept_document* d);
+int lept_document_parse(lept_document* d, const char* json, size_t len);	/* the status of lept_parse_n() */
+
+lept_type lept_document_get_type(const lept_document* d, size_t node);
+bool lept_document_get_boolean(const lept_document* d, size_t node);
+double lept_document_get_number(const lept_document* d, size_t node);
+const char* lept_document_get_string(const lept_document* d, size_t node);
+size_t lept_document_get_string_length(const lept_document* d, size_t node);
+size_t lept_document_get_array_size(const lept_document* d, size_t node);
+size_t lept_document_get_array_element(const lept_document* d, size_t node, size_t index);	/* skips the elements before it */
+size_t lept_document_get_object_size(const lept_document* d, size_t node);
+const char* lept_document_get_object_key(const lept_document* d, size_t node, size_t index);
+size_t lept_document_get_object_key_length(const lept_document* d, size_t node, size_t index);
+size_t lept_document_get_object_value(const lept_document* d, size_t node, size_t index);
+size_t lept_document_next(const lept_document* d, size_t node);	/* the node after node and its descendants */
+
+/*
+	On-demand parsing: lept_lazy_parse() only finds where the root value ends, by matching brackets and
+	skipping strings. A container is split into its elements when first accessed, and their subtrees
+	are skipped again; a string or number is decoded by its first getter. The result is kept, so the
+	next access costs nothing, and so is an error: getters return LEPT_PARSE_OK or the status of the
+	faulty part, a faulty number reads as 0. Strings and keys are not terminated, and point into json
+	(which must outlive the document) when they have no escapes. First accesses to a node must be
+	serialized.
+*/
+typedef struct lept_lazy lept_lazy;
+
+int lept_lazy_parse(lept_lazy** root, const char* json, size_t len);
+void lept_lazy_free(lept_lazy* root);	/* frees every node of the document */
+
+lept_type lept_lazy_get_type(const lept_lazy* v);	/* from the first byte, checks nothing */
+int lept_lazy_get_boolean(const lept_lazy* v, bool* b);
+int lept_lazy_get_number(lept_lazy* v, double* n);
+int lept_lazy_get_string(lept_lazy* v, const char** s, size_t* len);
+int lept_lazy_get_array_size(lept_lazy* v, size_t* size);
+int lept_lazy_get_array_element(lept_lazy* v, size_t index, lept_lazy** e);
+int lept_lazy_get_object_size(lept_lazy* v, size_t* size);
+int lept_lazy_get_object_key(lept_lazy* v, size_t index, const char** key, size_t* klen);
+int lept_lazy_get_object_value(lept_lazy* v, size_t index, lept_lazy** value);
+int lept_lazy_find_object_value(lept_lazy* v, const char* key, size_t klen, lept_lazy** value);	/* *value is NULL if there is no such key */
+int lept_lazy_get_value(const lept_lazy* v, lept_value* out);	/* parses the whole subtree */
+
+/*
+	Binary snapshot: a versioned, position-independent encoding of a value with length-prefixed
+	strings, raw doubles, offset tables for O(1) access into containers, and a checksum. A view reads
+	a snapshot in place, for example a mapped file, without allocating; nodes are like those of a
+	lept_document and the root is view.root. lept_binary_open() checks the header and the checksum
+	only, so the offsets are trusted: lept_load_binary() also checks every offset, that each value is
+	written once where lept_serialize_binary() puts it, and the depth against lept_set_max_depth().
+*/
+struct lept_binary_view {
+	const char* data;
+	size_t size;
+	size_t root;
+};
+
+char* lept_serialize_binary(const lept_value* v, size_t* size);	/* free() the result */
+int lept_load_binary(lept_value* v, const void* data, size_t size);	/* LEPT_BINARY_OK or LEPT_BINARY_INVALID */
+int lept_binary_open(lept_binary_view* b, const void* data, size_t size);
+
+lept_type lept_binary_get_type(const lept_binary_view* b, size_t node);
+bool lept_binary_get_boolean(const lept_binary_view* b, size_t node);
+double lept_binary_get_number(const lept_binary_view* b, size_t node);
+const char* lept_binary_get_string(const lept_binary_view* b, size_t node);
+size_t lept_binary_get_string_length(const lept_binary_view* b, size_t node);
+size_t lept_binary_get_array_size(const lept_binary_view* b, size_t node);
+size_t lept_binary_get_array_element(const lept_binary_view* b, size_t node, size_t index);
+size_t lept_binary_get_object_size(const lept_binary_view* b, size_t node);
+const char* lept_binary_get_object_key(const lept_binary_view* b, size_t node, size_t index);
+size_t lept_binary_get_object_key_length(const lept_binary_view* b, size_t node, size_t index);
+size_t lept_binary_get_object_value(const lept_binary_view* b, size_t node, size_t index);
 
 #endif /* LEPTJSON_H__ */
@@ -5,6 +5,8 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <float.h>
+#include <math.h>
 #include "leptjson.h"
 
 static int main_ret = 0;
@@ -104,6 +106,87 @@ static void test_parse_number() {
 	TEST_NUMBER(-1.7976931348623157e+308, "-1.7976931348623157e+308");
 }
 
+static unsigned test_random_state = 20170101;
+
+static unsigned test_random() {	/* deterministic, the corpus is the same on every run */
+	test_random_state = test_random_state * 1103515245 + 12345;
+	return test_random_state >> 8;
+}
+
+static int test_number_matches_strtod(const char* json) {
+	lept_value v;
+	double expect = strtod(json, NULL), actual;
+	int ret;
+	lept_init(&v);
+	ret = lept_parse(&v, json);
+	actual = lept_get_type(&v) == LEPT_NUMBER ? lept_get_number(&v) : 0.0;
+	lept_free(&v);
+	if (expect == HUGE_VAL || expect == -HUGE_VAL)
+		return ret == LEPT_PARSE_NUMBER_TOO_BIG;
+	if (ret == LEPT_PARSE_OK && memcmp(&expect, &actual, sizeof(double)) == 0)
+		return 1;
+	fprintf(stderr, "%s:%d: %s parsed as %.17g instead of %.17g\n", __FILE__, __LINE__, json, actual, expect);
+	return 0;
+}
+
+static void test_parse_number_exact() {
+	static char json[1200];
+	int i, j, k, n, mismatches = 0;
+	for (i = 0; i < 20000; i++) {
+		/* the shortest and the longer representations of any finite double */
+		unsigned bits[2];
+		double d;
+		bits[0] = test_random() ^ (test_random() << 24);
+		bits[1] = test_random() ^ (test_random() << 24);
+		memcpy(&d, bits, sizeof(double));
+		if (d != d || d - d != 0.0)
+			continue;	/* NaN or infinity */
+		for (j = 15; j <= 17; j++) {
+			sprintf(json, "%.*g", j, d);
+			mismatches += !test_number_matches_strtod(json);
+		}
+		/* random digits with more than 19 significant ones, fractions and far exponents */
+		n = 0;
+		if (test_random() & 1)
+			json[n++] = '-';
+		json[n++] = (char)('1' + test_random() % 9);
+		for (j = test_random() % 30; j > 0; j--)
+			json[n++] = (char)('0' + test_random() % 10);
+		if (test_random() & 1)
+			for (json[n++] = '.', j = 1 + test_random() % 20; j > 0; j--)
+				json[n++] = (char)('0' + test_random() % 10);
+		sprintf(json + n, "e%d", (int)(test_random() % 700) - 350);
+		mismatches += !test_number_matches_strtod(json);
+#if LDBL_MANT_DIG >= 64
+		/* exactly halfway between two doubles, and a digit above or below it */
+		if (d > 0 && d < DBL_MAX && d >= DBL_MIN) {
+			frexp(d, &k);
+			n = sprintf(json, "%.1100Lg", (long double)d + ldexp(1.0, k - 54));
+			mismatches += !test_number_matches_strtod(json);
+			if (n > 2 && json[n - 1] >= '1' && json[n - 1] <= '8') {
+				json[n - 1]++;
+				mismatches += !test_number_matches_strtod(json);
+				json[n - 1] -= 2;
+				mismatches += !test_number_matches_strtod(json);
+			}
+		}
+#endif
+	}
+	EXPECT_EQ_INT(0, mismatches);
+
+	/* ties to even, and carries into the exponent */
+	EXPECT_TRUE(test_number_matches_strtod("9007199254740993"));
+	EXPECT_TRUE(test_number_matches_strtod("9007199254740993.00000000000000000000001"));
+	EXPECT_TRUE(test_number_matches_strtod("9007199254740995"));
+	EXPECT_TRUE(test_number_matches_strtod("2.4703282292062327e-324"));
+	EXPECT_TRUE(test_number_matches_strtod("2.4703282292062328e-324"));
+	EXPECT_TRUE(test_number_matches_strtod("2.2250738585072011e-308"));
+	EXPECT_TRUE(test_number_matches_strtod("1.7976931348623158e308"));
+	EXPECT_TRUE(test_number_matches_strtod("1.7976931348623159e308"));
+	EXPECT_TRUE(test_number_matches_strtod("123456789012345678901234567890"));
+	EXPECT_TRUE(test_number_matches_strtod("0.0000000000000000000000000000001234567890123456789012"));
+}
+
 #define TEST_STRING(expect, json)\
     do {\
         lept_value v;\
@@ -127,6 +210,54 @@ static void test_parse_string() {
 	TEST_STRING("\xF0\x9D\x84\x9E", "\"\\ud834\\udd1e\"");  /* G clef sign U+1D11E */
 }
 
+static void test_parse_long_string() {
+	/* Runs long enough for the vector kernels, with the stop character at every offset of a 32-byte block */
+	char json[160], expect[160];
+	size_t i, n;
+	lept_value v;
+	for (n = 0; n < 100; n++) {
+		json[0] = '"';
+		for (i = 0; i < n; i++)
+			json[1 + i] = expect[i] = (char)('a' + i % 26);
+		memcpy(json + 1 + n, "\\n", 2);
+		expect[n] = '\n';
+		memcpy(json + 3 + n, "xyz\"", 5);
+		memcpy(expect + n + 1, "xyz", 3);
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		EXPECT_EQ_SIZE_T(n + 4, lept_get_string_length(&v));
+		EXPECT_TRUE(memcmp(expect, lept_get_string(&v), n + 4) == 0);
+		lept_free(&v);
+
+		json[1 + n] = '\x01';
+		EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_CHAR, lept_parse(&v, json));
+		json[1 + n] = '\0';
+		EXPECT_EQ_INT(LEPT_PARSE_MISS_QUOTATION_MARK, lept_parse(&v, json));
+	}
+}
+
+static void test_parse_whitespace() {
+	static const char array[] = "[ \n\t  1 ,\r\n  2   ]";
+	const size_t len = sizeof(array) - 1;
+	char json[250];
+	size_t i, n;
+	lept_value v;
+	for (n = 0; n < 100; n++) {
+		for (i = 0; i < n; i++)
+			json[i] = " \t\n\r"[i % 4];
+		memcpy(json + n, array, len);
+		memset(json + n + len, ' ', n);
+		json[2 * n + len] = '\0';
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		EXPECT_EQ_SIZE_T(2, lept_get_array_size(&v));
+		lept_free(&v);
+		json[2 * n + len] = 'x';
+		json[2 * n + len + 1] = '\0';
+		EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse(&v, json));
+	}
+}
+
 static void test_parse_array() {
 	size_t i, j;
 	lept_value v;
@@ -226,6 +357,812 @@ static void test_parse_object() {
 	lept_free(&v);
 }
 
+static void test_parse_arena() {
+	lept_arena a;
+	lept_value v;
+	size_t i;
+	char json[4096];
+	char* p;
+
+	lept_arena_init(&a, 256);
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, "{\"s\":\"abc\",\"a\":[1,\"x\",{\"k\":null}]}", &a));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_get_type(&v));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+	EXPECT_EQ_STRING("s", lept_get_object_key(&v, 0), lept_get_object_key_length(&v, 0));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_object_value(&v, 0)), lept_get_string_length(lept_get_object_value(&v, 0)));
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(lept_get_object_value(&v, 1)));
+	EXPECT_EQ_STRING("x", lept_get_string(lept_get_array_element(lept_get_object_value(&v, 1), 1)), 1);
+	lept_free(&v);	/* no-op for arena storage */
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_arena_reset(&a);
+
+	/* a document larger than one block */
+	p = json;
+	*p++ = '[';
+	for (i = 0; i < 300; i++)
+		p += sprintf(p, "%s\"%u\"", i ? "," : "", (unsigned)i);
+	*p++ = ']';
+	*p = '\0';
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, json, &a));
+	EXPECT_EQ_SIZE_T(300, lept_get_array_size(&v));
+	EXPECT_EQ_STRING("299", lept_get_string(lept_get_array_element(&v, 299)), 3);
+	lept_arena_reset(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, json, &a));
+	EXPECT_EQ_STRING("123", lept_get_string(lept_get_array_element(&v, 123)), 3);
+	lept_arena_reset(&a);
+
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_arena(&v, "{\"a\":[\"b\"]", &a));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_arena_free(&a);
+}
+
+static void test_parse_insitu() {
+	char json[] = "{\"k\\u0041y\":[\"Hello\\nWorld\",\"\\uD834\\uDD1E\",\"\"],\"s\":\"abc\"}";
+	char bad[] = "[\"a\",\"b\\x\"]";
+	lept_value v, *a;
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&v, json));
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(&v));
+	EXPECT_EQ_STRING("kAy", lept_get_object_key(&v, 0), lept_get_object_key_length(&v, 0));
+	EXPECT_TRUE(lept_get_object_key(&v, 0) == json + 2);
+	a = lept_get_object_value(&v, 0);
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(a));
+	EXPECT_EQ_STRING("Hello\nWorld", lept_get_string(lept_get_array_element(a, 0)), lept_get_string_length(lept_get_array_element(a, 0)));
+	EXPECT_EQ_STRING("\xF0\x9D\x84\x9E", lept_get_string(lept_get_array_element(a, 1)), lept_get_string_length(lept_get_array_element(a, 1)));
+	EXPECT_EQ_STRING("", lept_get_string(lept_get_array_element(a, 2)), lept_get_string_length(lept_get_array_element(a, 2)));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_object_value(&v, 1)), lept_get_string_length(lept_get_object_value(&v, 1)));
+	EXPECT_TRUE(lept_get_string(lept_get_object_value(&v, 1)) > json && lept_get_string(lept_get_object_value(&v, 1)) < json + sizeof(json));
+	lept_set_string(lept_get_array_element(a, 0), "owned", 5);	/* replacing a borrowed string */
+	lept_free(&v);
+
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_insitu(&v, bad));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+}
+
+static void test_parse_shaped() {
+	const char* json = "[{\"id\":1,\"tag\":{\"x\":0}},{\"id\":2,\"tag\":{\"y\":0}},{\"id\":3,\"tag\":{\"x\":1}},"
+		"{\"id\":4,\"name\":\"d\"},{\"id\":5,\"tag\":null},{},{\"a\\u0000b\":true}]";
+	lept_value v, plain, *e;
+	char* s1, *s2;
+	size_t l1, l2, i;
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_shaped(&v, json));
+	EXPECT_EQ_SIZE_T(7, lept_get_array_size(&v));
+	e = lept_get_array_element(&v, 0);
+	EXPECT_TRUE(lept_get_object_shape(e) != NULL);
+	for (i = 1; i < 5; i++)	/* the same keys share a shape, a key prefix does not */
+		EXPECT_EQ_INT(i != 3, lept_get_object_shape(lept_get_array_element(&v, i)) == lept_get_object_shape(e));
+	EXPECT_TRUE(lept_get_object_shape(lept_get_object_value(lept_get_array_element(&v, 2), 1)) == lept_get_object_shape(lept_get_object_value(e, 1)));
+	EXPECT_TRUE(lept_get_object_shape(lept_get_object_value(lept_get_array_element(&v, 1), 1)) != lept_get_object_shape(lept_get_object_value(e, 1)));
+	EXPECT_TRUE(lept_get_object_shape(lept_get_array_element(&v, 5)) == NULL);
+
+	e = lept_get_array_element(&v, 3);
+	EXPECT_EQ_SIZE_T(2, lept_get_object_size(e));
+	EXPECT_EQ_STRING("name", lept_get_object_key(e, 1), lept_get_object_key_length(e, 1));
+	EXPECT_EQ_STRING("d", lept_get_string(lept_get_object_value(e, 1)), lept_get_string_length(lept_get_object_value(e, 1)));
+	EXPECT_EQ_SIZE_T(1, lept_find_object_index(e, "name", 4));
+	EXPECT_EQ_DOUBLE(4.0, lept_get_number(lept_find_object_value(e, "id", 2)));
+	EXPECT_TRUE(lept_find_object_value(e, "tag", 3) == NULL);
+	e = lept_get_array_element(&v, 6);
+	EXPECT_EQ_SIZE_T(0, lept_find_object_index(e, "a\0b", 3));
+
+	/* the same document as an ordinary parse */
+	lept_init(&plain);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&plain, json));
+	s1 = lept_stringify(&v, &l1);
+	s2 = lept_stringify(&plain, &l2);
+	EXPECT_EQ_SIZE_T(l2, l1);
+	EXPECT_TRUE(memcmp(s1, s2, l1) == 0);
+	free(s1);
+	free(s2);
+	lept_free(&plain);
+	lept_set_null(lept_get_array_element(&v, 0));	/* the shape outlives one of its objects */
+	EXPECT_EQ_DOUBLE(3.0, lept_get_number(lept_find_object_value(lept_get_array_element(&v, 2), "id", 2)));
+	lept_free(&v);
+
+	/* a large shape is indexed once for all its objects */
+	{
+		static char records[16384];
+		size_t n = 0;
+		int r, k;
+		records[n++] = '[';
+		for (r = 0; r < 20; r++) {
+			for (k = 0; k < 30; k++)
+				n += sprintf(records + n, "%c\"f%d\":%d", k ? ',' : '{', k, r * 100 + k);
+			n += sprintf(records + n, "}%c", r < 19 ? ',' : ']');
+		}
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_shaped(&v, records));
+		for (r = 0, k = 0; r < 20; r++)
+			k += lept_get_number(lept_find_object_value(lept_get_array_element(&v, r), "f29", 3)) == r * 100 + 29;
+		EXPECT_EQ_INT(20, k);
+		lept_free(&v);
+	}
+
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_shaped(&v, "[{\"a\":1},{\"a\":2},{\"a\":3 4}]"));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_parse_shaped(&v, "[{\"a\":1,\"b\":2},{\"a\":2,\"c\" 3}]"));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+}
+
+#define TEST_ERROR_N(error, json)\
+    do {\
+        lept_value v;\
+        lept_init(&v);\
+        EXPECT_EQ_INT(error, lept_parse_n(&v, json, sizeof(json) - 1));\
+        EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));\
+    } while(0)
+
+static void test_parse_length() {
+	const char* slice = "[1,\"ab\",true] trailing bytes";
+	lept_value v;
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, slice, 14));
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, slice + 3, 4));
+	EXPECT_EQ_STRING("ab", lept_get_string(&v), lept_get_string_length(&v));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "123456", 3));
+	EXPECT_EQ_DOUBLE(123.0, lept_get_number(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, "truex", 4));
+	EXPECT_EQ_INT(LEPT_TRUE, lept_get_type(&v));
+
+	/* the input ends in the middle of a token */
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_n(&v, "null", 0));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parse_n(&v, "null", 3));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parse_n(&v, "1.5", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_QUOTATION_MARK, lept_parse_n(&v, "\"abc\"", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_parse_n(&v, "\"a\\n\"", 3));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_UNICODE_HEX, lept_parse_n(&v, "\"\\u0041\"", 5));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_UNICODE_SURROGATE, lept_parse_n(&v, "\"\\uD834\\uDD1E\"", 7));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_n(&v, "[1,2]", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_n(&v, "{\"a\":1}", 6));
+
+	/* embedded NUL bytes are ordinary input */
+	TEST_ERROR_N(LEPT_PARSE_INVALID_STRING_CHAR, "\"a\0b\"");
+	TEST_ERROR_N(LEPT_PARSE_ROOT_NOT_SINGULAR, "null\0");
+	TEST_ERROR_N(LEPT_PARSE_INVALID_VALUE, "\0");
+	TEST_ERROR_N(LEPT_PARSE_INVALID_VALUE, "[\0]");
+	TEST_ERROR_N(LEPT_PARSE_MISS_KEY, "{\0}");
+}
+
+static void test_parse_file() {
+	const char* path = "leptjson_test_parse_file.json";
+	lept_value v;
+	FILE* fp;
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_FILE_ERROR, lept_parse_file(&v, "leptjson_no_such_file.json"));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	if ((fp = fopen(path, "wb")) == NULL)
+		return;
+	fputs("{\"a\" : [1, 2, \"three\"]}\n", fp);
+	fclose(fp);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_file(&v, path));
+	EXPECT_EQ_SIZE_T(3, lept_get_array_size(lept_get_object_value(&v, 0)));
+	lept_free(&v);
+
+	fclose(fopen(path, "wb"));
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_file(&v, path));
+	remove(path);
+}
+
+#define NDJSON_LINES 2000
+
+/* Line i holds {"id":i}, every 7th ends with CRLF, every 50th is blank and every 37th is invalid */
+static char* ndjson_make(size_t* len) {
+	char* json = (char*)malloc(NDJSON_LINES * 24), *p = json;
+	int i;
+	for (i = 1; i <= NDJSON_LINES; i++) {
+		if (i % 50 == 0)
+			p += sprintf(p, " \t\n");
+		else if (i % 37 == 0)
+			p += sprintf(p, "{\"id\":}\n");
+		else
+			p += sprintf(p, i % 7 == 0 ? "{\"id\":%d}\r\n" : "{\"id\":%d}\n", i);
+	}
+	*len = p - json - 1;	/* the last line has no newline */
+	return json;
+}
+
+struct ndjson_seen {
+	size_t count, last, stop_at;
+	bool ordered;
+	int status[NDJSON_LINES + 1];
+	lept_value v[NDJSON_LINES + 1];
+};
+
+static bool ndjson_collect(void* user, size_t line, int status, lept_value* v) {
+	ndjson_seen* seen = (ndjson_seen*)user;
+	if (line <= seen->last)
+		seen->ordered = false;
+	seen->last = line;
+	if (line <= NDJSON_LINES && seen->status[line] == -1) {
+		seen->status[line] = status;
+		seen->v[line] = *v;	/* takes the value over */
+		lept_init(v);
+	}
+	return ++seen->count != seen->stop_at;
+}
+
+static void test_ndjson(const char* json, size_t len, unsigned threads, bool unordered, size_t chunk_size, size_t stop_at) {
+	static ndjson_seen seen;
+	lept_ndjson_options options;
+	size_t i, lines = 0;
+	seen.count = seen.last = 0;
+	seen.stop_at = stop_at;
+	seen.ordered = true;
+	for (i = 0; i <= NDJSON_LINES; i++) {
+		seen.status[i] = -1;
+		lept_init(&seen.v[i]);
+	}
+	options.threads = threads;
+	options.unordered = unordered;
+	options.chunk_size = chunk_size;
+	EXPECT_EQ_INT(stop_at ? LEPT_PARSE_ABORTED : LEPT_PARSE_OK, lept_parse_ndjson(json, len, &options, ndjson_collect, &seen));
+	if (!unordered)
+		EXPECT_TRUE(seen.ordered);
+	for (i = 1; i <= NDJSON_LINES; i++) {
+		if (seen.status[i] == -1)
+			continue;
+		lines++;
+		if (i % 50 == 0)
+			EXPECT_EQ_INT(-1, seen.status[i]);
+		else if (i % 37 == 0) {
+			EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, seen.status[i]);
+			EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&seen.v[i]));
+		}
+		else {
+			EXPECT_EQ_INT(LEPT_PARSE_OK, seen.status[i]);
+			EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_object_value(&seen.v[i], 0)));
+		}
+		lept_free(&seen.v[i]);
+	}
+	EXPECT_EQ_SIZE_T(seen.count, lines);
+	EXPECT_EQ_SIZE_T(stop_at ? stop_at : len ? NDJSON_LINES - NDJSON_LINES / 50 : 0, lines);
+}
+
+static void test_parse_ndjson() {
+	const char* path = "leptjson_test_parse_ndjson.json";
+	size_t len;
+	char* json = ndjson_make(&len);
+	ndjson_seen* seen;
+	FILE* fp;
+
+	test_ndjson(json, len, 1, false, 0, 0);
+	test_ndjson(json, len, 4, false, 100, 0);
+	test_ndjson(json, len, 4, true, 100, 0);
+	test_ndjson(json, len, 8, false, 1, 0);
+	test_ndjson(json, len, 4, false, 100, 500);
+	test_ndjson(json, len, 4, true, 100, 1);
+	test_ndjson(json, 0, 4, false, 0, 0);
+
+	if ((fp = fopen(path, "wb")) != NULL) {
+		fwrite(json, 1, len, fp);
+		fclose(fp);
+		seen = (ndjson_seen*)calloc(1, sizeof(ndjson_seen));
+		seen->ordered = true;
+		for (len = 0; len <= NDJSON_LINES; len++)
+			seen->status[len] = -1;
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ndjson_file(path, NULL, ndjson_collect, seen));
+		EXPECT_EQ_SIZE_T(NDJSON_LINES - NDJSON_LINES / 50, seen->count);
+		EXPECT_TRUE(seen->ordered);
+		EXPECT_EQ_DOUBLE(1999.0, lept_get_number(lept_get_object_value(&seen->v[1999], 0)));
+		for (len = 0; len <= NDJSON_LINES; len++)
+			lept_free(&seen->v[len]);
+		free(seen);
+		remove(path);
+	}
+	EXPECT_EQ_INT(LEPT_PARSE_FILE_ERROR, lept_parse_ndjson_file("leptjson_no_such_file.json", NULL, ndjson_collect, NULL));
+	free(json);
+}
+
+/* lept_parse_parallel() gives the status and the tree of lept_parse_n() */
+static void test_parallel(const char* json, size_t len, unsigned threads) {
+	lept_value expect, v;
+	char* s1, *s2;
+	int ret;
+	lept_init(&expect);
+	lept_init(&v);
+	ret = lept_parse_n(&expect, json, len);
+	EXPECT_EQ_INT(ret, lept_parse_parallel(&v, json, len, threads));
+	if (ret == LEPT_PARSE_OK) {
+		s1 = lept_stringify(&expect, NULL);
+		s2 = lept_stringify(&v, NULL);
+		EXPECT_TRUE(strcmp(s1, s2) == 0);
+		free(s1);
+		free(s2);
+	}
+	else
+		EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_free(&expect);
+	lept_free(&v);
+}
+
+static void test_parse_parallel() {
+	static const char* broken[] = { "}", "]", ",", ",,", "\"", "\\", "[", "x", "1e999" };
+	size_t cap = 1 << 20, len, i, at;
+	char* json = (char*)malloc(cap), *p, c;
+	int n;
+
+	/* strings with escaped quotes and backslashes, brackets and commas inside them */
+	p = json + sprintf(json, " [\n");
+	for (n = 0; p - json < 400000; n++)
+		p += sprintf(p, "%s{\"id\":%d,\"s\":\"a\\\\\\\"[{,\\\\\",\"t\":[%d.5,true,null,\"\\u00e9]\\\\\"],\"o\":{}}", n ? ",\n" : "", n, n);
+	len = p - json + sprintf(p, "\n] ");
+	test_parallel(json, len, 4);
+	test_parallel(json, len, 3);
+	test_parallel(json, len, 1);
+	test_parallel(json, len, 0);
+
+	for (i = 0; i < sizeof(broken) / sizeof(broken[0]); i++)
+		for (at = len / 7; at < len; at += len / 5) {
+			char save[8];
+			size_t k = strlen(broken[i]);
+			memcpy(save, json + at, k);
+			memcpy(json + at, broken[i], k);
+			test_parallel(json, len, 4);
+			memcpy(json + at, save, k);
+		}
+	test_parallel(json, len - 3, 4);	/* no closing bracket */
+	json[len - 1] = 'x';
+	test_parallel(json, len, 4);	/* root not singular */
+	json[len - 1] = ' ';
+
+	/* the members of a large object */
+	p = json + sprintf(json, "{");
+	for (n = 0; p - json < 400000; n++)
+		p += sprintf(p, "%s\"k%d\\\"\" : [%d, {\"a,\":\"}\"}]", n ? ", " : "", n, n);
+	len = p - json + sprintf(p, "}");
+	test_parallel(json, len, 4);
+	test_parallel(json, len - 1, 4);
+	c = json[len / 2];
+	json[len / 2] = ':';
+	test_parallel(json, len, 4);
+	json[len / 2] = c;
+	lept_set_max_depth(3);
+	test_parallel(json, len, 4);
+	lept_set_max_depth(2);
+	test_parallel(json, len, 4);	/* too deep */
+	lept_set_max_depth(0);
+
+	test_parallel("[1,2,3]", 7, 4);
+	test_parallel("", 0, 4);
+	free(json);
+}
+
+/* Walks the document node and the tree v side by side */
+static int test_document_equal(const lept_document* d, size_t node, const lept_value* v) {
+	size_t i, n;
+	if (lept_document_get_type(d, node) != lept_get_type(v))
+		return 0;
+	switch (lept_get_type(v)) {
+		case LEPT_NUMBER:
+			return lept_document_get_number(d, node) == lept_get_number(v);
+		case LEPT_STRING:
+			return lept_document_get_string_length(d, node) == lept_get_string_length(v)
+				&& memcmp(lept_document_get_string(d, node), lept_get_string(v), lept_get_string_length(v) + 1) == 0;
+		case LEPT_ARRAY:
+			if ((n = lept_document_get_array_size(d, node)) != lept_get_array_size(v))
+				return 0;
+			for (i = 0; i < n; i++)
+				if (!test_document_equal(d, lept_document_get_array_element(d, node, i), lept_get_array_element(v, i)))
+					return 0;
+			return 1;
+		case LEPT_OBJECT:
+			if ((n = lept_document_get_object_size(d, node)) != lept_get_object_size(v))
+				return 0;
+			for (i = 0; i < n; i++)
+				if (lept_document_get_object_key_length(d, node, i) != lept_get_object_key_length(v, i)
+					|| memcmp(lept_document_get_object_key(d, node, i), lept_get_object_key(v, i), lept_get_object_key_length(v, i)) != 0
+					|| !test_document_equal(d, lept_document_get_object_value(d, node, i), lept_get_object_value(v, i)))
+					return 0;
+			return 1;
+		default:
+			return 1;
+	}
+}
+
+static void test_parse_document() {
+	static const char* json[] = {
+		"null", " true ", "false", "-1.5e-3", "\"\"", "\"Hello\\u0000World\\n\"", "[]", "{}",
+		"[ null , false , true , 123 , \"abc\", [1, [2, [3]]], {} ]",
+		"{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":{\"a\":[]}}}",
+		"[", "[1,]", "{\"a\" 1}", "\"\\x\"", "1e309", "[1] x", ""
+	};
+	lept_document* d = lept_document_create();
+	lept_value v;
+	size_t i;
+	int ret;
+	for (i = 0; i < sizeof(json) / sizeof(json[0]); i++) {	/* one document, reused */
+		lept_init(&v);
+		ret = lept_parse(&v, json[i]);
+		EXPECT_EQ_INT(ret, lept_document_parse(d, json[i], strlen(json[i])));
+		if (ret == LEPT_PARSE_OK)
+			EXPECT_TRUE(test_document_equal(d, 0, &v));
+		lept_free(&v);
+	}
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_document_parse(d, "[1,[2,3],{\"a\":4},5]", 19));
+	EXPECT_EQ_SIZE_T(1, lept_document_get_array_element(d, 0, 0));
+	EXPECT_EQ_SIZE_T(3, lept_document_next(d, 1));
+	EXPECT_EQ_SIZE_T(9, lept_document_next(d, 3));	/* a number takes two words, a container its end word */
+	EXPECT_EQ_SIZE_T(14, lept_document_next(d, 9));
+	EXPECT_EQ_SIZE_T(14, lept_document_get_array_element(d, 0, 3));
+	EXPECT_EQ_DOUBLE(5.0, lept_document_get_number(d, 14));
+	EXPECT_EQ_SIZE_T(17, lept_document_next(d, 0));
+	lept_document_destroy(d);
+}
+
+static void test_parse_lazy() {
+	const char* json = " {\"id\": 7, \"name\" : \"a\\u00e9b\", \"raw\":\"plain\", \"skip\": [1, {\"x\": \"]}\\\"\"}, [[]]],"
+		" \"bad\": 1.5x, \"list\": [true, false, null, -0.5e1], \"k\\n\": {} } ";
+	lept_lazy* root, *v, *w;
+	const char* s;
+	size_t len, size;
+	double n;
+	bool b;
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_parse(&root, json, strlen(json)));
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_lazy_get_type(root));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(root, "id", 2, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_number(v, &n));
+	EXPECT_EQ_DOUBLE(7.0, n);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(root, "name", 4, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_string(v, &s, &len));
+	EXPECT_EQ_STRING("a\xC3\xA9" "b", s, len);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(root, "raw", 3, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_string(v, &s, &len));
+	EXPECT_EQ_STRING("plain", s, len);
+	EXPECT_TRUE(s > json && s < json + strlen(json));	/* borrowed */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_string(v, &s, &len));	/* memoized */
+	EXPECT_EQ_STRING("plain", s, len);
+
+	/* an error is reported by the getter of the faulty value only */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(root, "bad", 3, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_lazy_get_number(v, &n));
+	EXPECT_EQ_DOUBLE(0.0, n);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(root, "missing", 7, &v));
+	EXPECT_TRUE(v == NULL);
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(root, "list", 4, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_array_size(v, &size));
+	EXPECT_EQ_SIZE_T(4, size);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_array_element(v, 1, &w));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_boolean(w, &b));
+	EXPECT_FALSE(b);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_array_element(v, 2, &w));
+	EXPECT_EQ_INT(LEPT_NULL, lept_lazy_get_type(w));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_array_element(v, 3, &w));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_number(w, &n));
+	EXPECT_EQ_DOUBLE(-5.0, n);
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_object_size(root, &size));
+	EXPECT_EQ_SIZE_T(7, size);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_object_key(root, 6, &s, &len));
+	EXPECT_EQ_STRING("k\n", s, len);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_object_value(root, 3, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_array_element(v, 1, &w));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_find_object_value(w, "x", 1, &w));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_string(w, &s, &len));
+	EXPECT_EQ_STRING("]}\"", s, len);
+	{
+		lept_value tree;
+		lept_init(&tree);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_get_value(v, &tree));
+		EXPECT_EQ_SIZE_T(3, lept_get_array_size(&tree));
+		lept_free(&tree);
+	}
+	lept_lazy_free(root);
+
+	/* only the structure is checked up front */
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_lazy_parse(&root, " ", 1));
+	EXPECT_TRUE(root == NULL);
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_lazy_parse(&root, "[] 1", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_QUOTATION_MARK, lept_lazy_parse(&root, "\"abc", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_lazy_parse(&root, "[1, [2]", 7));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_lazy_parse(&root, "{\"a\":[}", 7));
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_parse(&root, "{\"a\":1 \"b\":2}", 13));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_lazy_get_object_size(root, &size));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_lazy_find_object_value(root, "a", 1, &v));
+	lept_lazy_free(root);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_parse(&root, "{\"a\\n\" 1}", 9));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_lazy_get_object_size(root, &size));
+	lept_lazy_free(root);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_parse(&root, "[1,]", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_lazy_get_array_size(root, &size));
+	lept_lazy_free(root);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_lazy_parse(&root, "\"\\x\"", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_STRING_ESCAPE, lept_lazy_get_string(root, &s, &len));
+	lept_lazy_free(root);
+}
+
+static const char* test_projection_json =
+	"{\"user\":{\"id\":42,\"name\":\"x\",\"tags\":[\"a\",\"b\"]},"
+	"\"items\":[{\"price\":1,\"qty\":2},{\"price\":3},{\"qty\":4}],"
+	"\"big\":[[1,2,{\"x\":\"}\\\"]\"}]],\"a/b\":{\"m~n\":5},\"\":7}";
+
+static void test_projection(const char* expect, const char* const* pointers, size_t count) {
+	lept_path_set* paths = lept_path_set_create(pointers, count);
+	lept_value v, full, *a, *b;
+	char* json, *s1, *s2;
+	size_t i;
+	EXPECT_TRUE(paths != NULL);
+	lept_init(&v);
+	lept_init(&full);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_projected(&v, test_projection_json, strlen(test_projection_json), paths));
+	json = lept_stringify(&v, NULL);
+	EXPECT_EQ_BASE(strcmp(expect, json) == 0, expect, json, "%s");
+	free(json);
+	lept_parse(&full, test_projection_json);
+	for (i = 0; i < count; i++) {	/* a pointer of the set finds the same value in both, or none */
+		a = lept_pointer_get(&full, pointers[i]);
+		b = lept_pointer_get(&v, pointers[i]);
+		if (a && b) {
+			s1 = lept_stringify(a, NULL);
+			s2 = lept_stringify(b, NULL);
+			EXPECT_EQ_BASE(strcmp(s1, s2) == 0, s1, s2, "%s");
+			free(s1);
+			free(s2);
+		}
+		else
+			EXPECT_TRUE(a == NULL && b == NULL);
+	}
+	lept_free(&full);
+	lept_free(&v);
+	lept_path_set_destroy(paths);
+}
+
+static void test_parse_projected() {
+	static const char* user_id[] = { "/user/id", "/items/*/price", "/a~1b/m~0n" };
+	static const char* index[] = { "/items/2/qty", "/items/*/price" };
+	static const char* element[] = { "/items/1" };
+	static const char* deeper[] = { "/user/id/deep", "/big/0/2/x" };
+	static const char* whole[] = { "/items/0/price", "" };
+	static const char* empty_key[] = { "/" };
+	static const char* bad[] = { "/user", "user" };
+	static const char* bad_escape[] = { "/~2" };
+	static const char* numeric_key[] = { "/*/x", "/0/y" };
+	static const char* const numeric_docs[][2] = {
+		{ "{\"0\":{\"x\":1,\"y\":2},\"a\":{\"x\":3}}", "{\"0\":{\"y\":2}}" },	/* "*" matches no member */
+		{ "[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}]", "[{\"x\":1,\"y\":2},{\"x\":3}]" }
+	};
+	static const char* duplicate_key[] = { "/a/a" };
+	static const char* const duplicate_docs[][2] = {
+		{ "{\"a\":12.5,\"a\":{\"a\":{\"x\":1}}}", "{}" },	/* the first "a" has no "a" */
+		{ "{\"a\":{\"a\":1,\"a\":2},\"a\":{\"a\":3}}", "{\"a\":{\"a\":1}}" }
+	};
+	lept_path_set* paths;
+	lept_value v;
+	char* json;
+	size_t i;
+
+	test_projection("{\"user\":{\"id\":42},\"items\":[{\"price\":1},{\"price\":3},{}],\"a/b\":{\"m~n\":5}}", user_id, 3);
+	test_projection("{\"items\":[{\"price\":1},{\"price\":3},{\"qty\":4}]}", index, 2);
+	test_projection("{\"items\":[null,{\"price\":3}]}", element, 1);
+	test_projection("{\"user\":{},\"big\":[[null,null,{\"x\":\"}\\\"]\"}]]}", deeper, 2);
+	test_projection("{\"user\":{\"id\":42,\"name\":\"x\",\"tags\":[\"a\",\"b\"]},\"items\":[{\"price\":1,\"qty\":2},{\"price\":3},{\"qty\":4}],"
+		"\"big\":[[1,2,{\"x\":\"}\\\"]\"}]],\"a/b\":{\"m~n\":5},\"\":7}", whole, 2);
+	test_projection("{\"\":7}", empty_key, 1);
+	test_projection("{}", NULL, 0);
+
+	EXPECT_TRUE(lept_path_set_create(bad, 2) == NULL);
+	EXPECT_TRUE(lept_path_set_create(bad_escape, 1) == NULL);
+
+	/* a numeric token is a member key in an object, "*" only adds to it in an array */
+	paths = lept_path_set_create(numeric_key, 2);
+	lept_init(&v);
+	for (i = 0; i < 2; i++) {
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_projected(&v, numeric_docs[i][0], strlen(numeric_docs[i][0]), paths));
+		json = lept_stringify(&v, NULL);
+		EXPECT_EQ_BASE(strcmp(numeric_docs[i][1], json) == 0, numeric_docs[i][1], json, "%s");
+		free(json);
+		lept_free(&v);
+	}
+	lept_path_set_destroy(paths);
+
+	/* a path follows the first member of its key, as lept_pointer_get() does */
+	paths = lept_path_set_create(duplicate_key, 1);
+	for (i = 0; i < 2; i++) {
+		lept_value full;
+		lept_value* a, *b;
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_projected(&v, duplicate_docs[i][0], strlen(duplicate_docs[i][0]), paths));
+		json = lept_stringify(&v, NULL);
+		EXPECT_EQ_BASE(strcmp(duplicate_docs[i][1], json) == 0, duplicate_docs[i][1], json, "%s");
+		free(json);
+		lept_init(&full);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&full, duplicate_docs[i][0]));
+		a = lept_pointer_get(&full, "/a/a");
+		b = lept_pointer_get(&v, "/a/a");
+		EXPECT_TRUE(a == NULL ? b == NULL : b != NULL && lept_is_equal(a, b));
+		lept_free(&full);
+		lept_free(&v);
+	}
+	lept_path_set_destroy(paths);
+
+	/* kept values are fully checked, skipped ones only for brackets and quotes */
+	paths = lept_path_set_create(user_id, 1);
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_projected(&v, "{\"user\":{\"id\":4x}}", 18, paths));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_projected(&v, "{\"skip\":[1,{]},\"user\":{}}", 25, paths));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_QUOTATION_MARK, lept_parse_projected(&v, "{\"skip\":\"abc}", 13, paths));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_KEY, lept_parse_projected(&v, "{\"user\":{\"id\":1},}", 18, paths));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_projected(&v, "{} []", 5, paths));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_projected(&v, "{\"skip\":tru,\"user\":{\"id\":1}}", 28, paths));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(lept_pointer_get(&v, "/user/id")));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_projected(&v, " 5 ", 3, paths));	/* nothing on the paths */
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_path_set_destroy(paths);
+}
+
+/* Feeds json in chunks of every size and expects the status and tree of lept_parse() */
+static void test_push_chunks(const char* json) {
+	lept_push_parser* p = lept_push_parser_create();
+	size_t len = strlen(json), chunk, i;
+	lept_value expect, v;
+	char* s1 = NULL, *s2;
+	int ret;
+	lept_init(&expect);
+	ret = lept_parse(&expect, json);
+	if (ret == LEPT_PARSE_OK)
+		s1 = lept_stringify(&expect, NULL);
+	for (chunk = 1; chunk <= len + 1; chunk++) {
+		for (i = 0; i < len; i += chunk)
+			lept_push_parser_feed(p, json + i, len - i < chunk ? len - i : chunk);
+		EXPECT_EQ_INT(ret, lept_push_parser_finish(p, &v));
+		if (ret == LEPT_PARSE_OK) {
+			s2 = lept_stringify(&v, NULL);
+			EXPECT_EQ_BASE(strcmp(s1, s2) == 0, s1, s2, "%s");
+			free(s2);
+		}
+		else
+			EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+		lept_free(&v);
+	}
+	free(s1);
+	lept_free(&expect);
+	lept_push_parser_destroy(p);
+}
+
+static void test_parse_push() {
+	static const char* const docs[] = {
+		"null", " true ", "false", "123", "-1.5e+10", "0", "\"\"", "\"Hello\\nWorld\"",
+		"\"\\uD834\\uDD1E \\u20AC \\\\ \\\"\"", "[ ]", "{ }",
+		"[ null , false , true , 123 , \"abc\" , [ 1, [ ] ], { } ]",
+		" { \"n\" : null , \"f\" : false , \"t\" : true , \"i\" : 123 , \"s\" : \"abc\", "
+		"\"a\" : [ 1, 2, 3 ], \"o\" : { \"1\" : 1, \"2\" : 2, \"3\" : 3 } } ",
+		"", " ", "nul", "?", "+1", "1.", "[1,]", "[\"a\", nul]", "null x", "0123", "0x123", "1e309",
+		"\"abc", "\"\\v\"", "\"\x01\"", "\"\\u012\"", "\"\\uD800\\\\\"", "\"\\uD800\\uE000\"",
+		"[1", "[1}", "[1 2", "[[]", "{:1,", "{1:1,", "{\"a\":1,", "{\"a\"}", "{\"a\",\"b\"}",
+		"{\"a\":1", "{\"a\":1]", "{\"a\":1 \"b\"", "{\"a\":{}", "[1-2]", "[0 1]", "{\"a\":[1,{\"b\":\"c\\\"\"}]}x"
+	};
+	lept_push_parser* p;
+	lept_value v;
+	size_t i;
+	for (i = 0; i < sizeof(docs) / sizeof(docs[0]); i++)
+		test_push_chunks(docs[i]);
+
+	/* several documents through one parser, an error is sticky until finish */
+	p = lept_push_parser_create();
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_feed(p, "[\"ab", 4));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_feed(p, "c\"]", 3));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_STRING("abc", lept_get_string(lept_get_array_element(&v, 0)), 3);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_push_parser_feed(p, "{\"a\" 1", 7));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_push_parser_feed(p, "}", 1));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_feed(p, "  1", 3));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_DOUBLE(1.0, lept_get_number(&v));
+	lept_push_parser_destroy(p);
+}
+
+struct sax_trace {
+	char buf[256];
+	size_t len;
+	int events, stop;	/* abort at the stop-th event when stop > 0 */
+};
+
+static bool sax_put(void* user, const char* s, size_t len) {
+	sax_trace* t = (sax_trace*)user;
+	memcpy(t->buf + t->len, s, len);
+	t->len += len;
+	return ++t->events != t->stop;
+}
+
+static bool sax_null(void* user) { return sax_put(user, "n ", 2); }
+static bool sax_boolean(void* user, bool b) { return sax_put(user, b ? "t " : "f ", 2); }
+static bool sax_start_object(void* user) { return sax_put(user, "{ ", 2); }
+static bool sax_start_array(void* user) { return sax_put(user, "[ ", 2); }
+
+static bool sax_number(void* user, double n) {
+	char s[32];
+	return sax_put(user, s, sprintf(s, "%g ", n));
+}
+
+static bool sax_string(void* user, const char* s, size_t len) {
+	sax_put(user, "\"", 1);
+	sax_put(user, s, len);
+	((sax_trace*)user)->events -= 2;
+	return sax_put(user, "\" ", 2);
+}
+
+static bool sax_key(void* user, const char* s, size_t len) {
+	((sax_trace*)user)->events--;
+	sax_put(user, s, len);
+	return sax_put(user, ": ", 2);
+}
+
+static bool sax_end_object(void* user, size_t size) {
+	char s[32];
+	return sax_put(user, s, sprintf(s, "}%d ", (int)size));
+}
+
+static bool sax_end_array(void* user, size_t size) {
+	char s[32];
+	return sax_put(user, s, sprintf(s, "]%d ", (int)size));
+}
+
+static const lept_handler sax_tracer = {
+	sax_null, sax_boolean, sax_number, sax_string, sax_key,
+	sax_start_object, sax_end_object, sax_start_array, sax_end_array
+};
+
+#define TEST_SAX(expect, json)\
+	do {\
+		sax_trace t;\
+		t.len = 0;\
+		t.events = t.stop = 0;\
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax(json, strlen(json), &sax_tracer, &t));\
+		EXPECT_EQ_STRING(expect, t.buf, t.len);\
+	} while(0)
+
+static void test_parse_sax() {
+	static const lept_handler ignore_all = { 0 };
+	sax_trace t;
+	TEST_SAX("n ", " null ");
+	TEST_SAX("1.5 ", "1.5");
+	TEST_SAX("\"a\0b\" ", "\"a\\u0000b\"");
+	TEST_SAX("[ ]0 ", "[ ]");
+	TEST_SAX("{ }0 ", "{ }");
+	TEST_SAX("[ n f t 123 \"abc\" ]5 ", "[ null , false , true , 123 , \"abc\" ]");
+	TEST_SAX("[ [ ]0 [ 0 ]1 [ 0 1 ]2 ]3 ", "[ [ ] , [ 0 ] , [ 0 , 1 ] ]");
+	TEST_SAX("{ a: [ 1 2 ]2 o: { x: n }1 s: \"\" }3 ", " { \"a\" : [ 1, 2 ], \"o\" : { \"x\" : null }, \"s\" : \"\" } ");
+
+	/* any callback may stop the parse, no later event is delivered */
+	t.len = 0;
+	t.events = 0;
+	t.stop = 4;
+	EXPECT_EQ_INT(LEPT_PARSE_ABORTED, lept_parse_sax("[ 1, [ 2, 3 ], 4 ]", 18, &sax_tracer, &t));
+	EXPECT_EQ_STRING("[ 1 [ 2 ", t.buf, t.len);
+	t.len = 0;
+	t.events = 0;
+	t.stop = 2;
+	EXPECT_EQ_INT(LEPT_PARSE_ABORTED, lept_parse_sax("{\"a\":1,\"b\":2}", 13, &sax_tracer, &t));
+	EXPECT_EQ_STRING("{ a: ", t.buf, t.len);
+
+	/* the same grammar as lept_parse(), events already delivered stand */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_sax("[{\"a\":[]}]", 10, &ignore_all, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_EXPECT_VALUE, lept_parse_sax(" ", 1, &ignore_all, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_ROOT_NOT_SINGULAR, lept_parse_sax("[] x", 4, &ignore_all, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_NUMBER_TOO_BIG, lept_parse_sax("[1e309]", 7, &ignore_all, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parse_sax("[1 2]", 5, &ignore_all, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_KEY, lept_parse_sax("{1:1}", 5, &ignore_all, NULL));
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COLON, lept_parse_sax("{\"a\" 1}", 7, &ignore_all, NULL));
+	t.len = 0;
+	t.events = t.stop = 0;
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, lept_parse_sax("{\"a\":[1]", 8, &sax_tracer, &t));
+	EXPECT_EQ_STRING("{ a: [ 1 ]1 ", t.buf, t.len);
+}
+
 #define TEST_ERROR(error, json)\
     do {\
         lept_value v;\
@@ -345,14 +1282,295 @@ static void test_parse_miss_comma_or_curly_bracket() {
 	TEST_ERROR(LEPT_PARSE_MISS_COMMA_OR_CURLY_BRACKET, "{\"a\":{}");
 }
 
+static void test_parse_too_deep() {
+	const size_t depth = 100000;
+	char* json = (char*)malloc(2 * depth + 1), *s, *data;
+	lept_push_parser* p;
+	lept_handler h;
+	lept_value v, w, *e;
+	size_t i, length, size;
+	for (i = 0; i < depth; i++) {
+		json[i] = '[';
+		json[2 * depth - 1 - i] = ']';
+	}
+	json[2 * depth] = '\0';
+	TEST_ERROR(LEPT_PARSE_TOO_DEEP, json);
+
+	/* parse, stringify, free, hashing, equality and the binary snapshot do not recurse */
+	lept_set_max_depth((size_t)-1);
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	data = lept_serialize_binary(&v, &size);
+	EXPECT_EQ_SIZE_T(32 + 16 * depth - 8, size);	/* the innermost array is empty */
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_load_binary(&v, data, size));
+	s = lept_stringify(&v, &length);
+	EXPECT_EQ_SIZE_T(2 * depth, length);
+	EXPECT_TRUE(memcmp(s, json, length) == 0);
+	free(s);
+	lept_init(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, json));
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_hash(&v) == lept_hash(&w));
+	for (e = &w; lept_get_array_size(e); e = lept_get_array_element(e, 0))
+		;
+	lept_set_number(lept_pushback_array_element(e), 1.0);
+	EXPECT_FALSE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_hash(&v) != lept_hash(&w));
+	lept_free(&w);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+
+	lept_set_max_depth(2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[[1],{\"a\":1},[]]"));
+	lept_free(&v);
+	TEST_ERROR(LEPT_PARSE_TOO_DEEP, "[[[1]]]");
+	TEST_ERROR(LEPT_PARSE_TOO_DEEP, "{\"a\":{\"b\":[]}}");
+	TEST_ERROR(LEPT_PARSE_TOO_DEEP, "[[],[[]]]");
+	memset(&h, 0, sizeof(h));
+	EXPECT_EQ_INT(LEPT_PARSE_TOO_DEEP, lept_parse_sax("[[[]]]", 6, &h, NULL));
+	p = lept_push_parser_create();
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_feed(p, "[[", 2));
+	EXPECT_EQ_INT(LEPT_PARSE_TOO_DEEP, lept_push_parser_feed(p, "[1]]]", 5));
+	EXPECT_EQ_INT(LEPT_PARSE_TOO_DEEP, lept_push_parser_finish(p, &v));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_feed(p, "[[1]]", 5));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_push_parser_finish(p, &v));
+	lept_free(&v);
+	lept_push_parser_destroy(p);
+
+	/* the default */
+	lept_set_max_depth(0);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, json + depth - 1024, 2 * 1024));
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_TOO_DEEP, lept_parse_n(&v, json + depth - 1025, 2 * 1025));
+	EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_load_binary(&v, data, size));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	free(data);
+	free(json);
+}
+
+/* An allocator that counts the blocks it hands out */
+static size_t test_blocks;
+
+static void* test_allocate(void* user, size_t size) {
+	++*(size_t*)user;
+	test_blocks++;
+	return malloc(size);
+}
+
+static void* test_reallocate(void* user, void* p, size_t size) {
+	++*(size_t*)user;
+	test_blocks += p == NULL;
+	return realloc(p, size);
+}
+
+static void test_deallocate(void*, void* p) {
+	test_blocks -= p != NULL;
+	free(p);
+}
+
+static void* test_allocate_nothing(void*, size_t) {
+	return NULL;
+}
+
+static void test_parse_allocator() {
+	static const char json[] = "{\"a\":[1,\"abc\",{\"k\":[]}],\"long\":\"0123456789012345678901234567890123456789\"}";
+	size_t calls = 0, length;
+	lept_allocator a;
+	lept_alloc_stats s;
+	lept_value v;
+	char* out;
+
+	a.allocate = test_allocate;
+	a.reallocate = test_reallocate;
+	a.deallocate = test_deallocate;
+	a.user = &calls;
+	lept_set_allocator(&a);
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	lept_set_string(lept_set_object_value(&v, "b", 1), "x", 1);
+	out = lept_stringify(&v, &length);
+	test_deallocate(NULL, out);
+	lept_free(&v);
+	lept_set_allocator(NULL);
+	EXPECT_TRUE(calls > 0);
+	EXPECT_EQ_SIZE_T(0, test_blocks);
+
+	/* a parse holds its strings, containers and scratch stack */
+	lept_count_allocs(&s);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	lept_count_allocs(NULL);
+	EXPECT_TRUE(s.allocs >= 8);
+	EXPECT_TRUE(s.bytes >= 41 + 4 + 2 * sizeof(lept_value) + 3 * sizeof(lept_value) + sizeof(lept_member));
+	EXPECT_TRUE(s.peak >= s.held && s.held + 256 <= s.peak);
+	EXPECT_EQ_SIZE_T(256, s.stack);
+	lept_count_allocs(&s);
+	lept_free(&v);
+	EXPECT_EQ_SIZE_T(0, s.allocs);
+	lept_count_allocs(NULL);
+
+	lept_init(&v);
+	lept_set_string(&v, json, sizeof(json) - 1);
+	lept_count_allocs(&s);
+	out = lept_stringify(&v, &length);
+	lept_count_allocs(NULL);
+	EXPECT_TRUE(s.stack > length && s.peak == s.stack && s.held == s.stack);
+	free(out);
+	lept_free(&v);
+}
+
+static void test_parse_stats() {
+	static const char json[] = " { \"n\" : [ 1, -2.5, 3e2, 40, null, true, false ], \"s\\t\" : \"a\\\"b\\u00e9\", \"o\" : { \"e\" : [ [ ] ] } } ";
+	lept_parse_stats s;
+	lept_value v;
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, json, &s));
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_NULL]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_FALSE]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_TRUE]);
+	EXPECT_EQ_SIZE_T(4, s.values[LEPT_NUMBER]);
+	EXPECT_EQ_SIZE_T(1, s.values[LEPT_STRING]);
+	EXPECT_EQ_SIZE_T(3, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(2, s.values[LEPT_OBJECT]);
+	EXPECT_EQ_SIZE_T(4, s.keys);
+	EXPECT_EQ_SIZE_T(4, s.depth);
+	EXPECT_EQ_SIZE_T(1 + 2 + 1 + 1 + 5, s.string_bytes);
+	EXPECT_EQ_SIZE_T(3, s.escapes);
+	EXPECT_EQ_SIZE_T(7, s.largest_array);
+	EXPECT_EQ_SIZE_T(3, s.largest_object);
+	EXPECT_EQ_SIZE_T(2, s.integers);
+	EXPECT_EQ_SIZE_T(2, s.non_integers);
+	EXPECT_EQ_SIZE_T(sizeof(json) - 1, s.bytes);
+	EXPECT_EQ_SIZE_T(3, lept_get_object_size(&v));
+	lept_free(&v);
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, "\"x\"", NULL));
+	EXPECT_EQ_INT(LEPT_STRING, lept_get_type(&v));
+	lept_free(&v);
+
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_ex(&v, "0", &s));
+	EXPECT_EQ_SIZE_T(0, s.depth);
+	EXPECT_EQ_SIZE_T(1, s.integers);
+
+	/* on an error the counts stop at it */
+	EXPECT_EQ_INT(LEPT_PARSE_INVALID_VALUE, lept_parse_ex(&v, "[[1],[2,?]]", &s));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	EXPECT_EQ_SIZE_T(3, s.values[LEPT_ARRAY]);
+	EXPECT_EQ_SIZE_T(2, s.integers);
+	EXPECT_EQ_SIZE_T(1, s.largest_array);
+	EXPECT_EQ_SIZE_T(8, s.bytes);
+}
+
+/* lept_parse_into() gives what lept_parse() gives, whatever v held */
+static void test_reuse(lept_parser* p, lept_value* v, const char* json) {
+	lept_value expect;
+	lept_init(&expect);
+	EXPECT_EQ_INT(lept_parse(&expect, json), lept_parse_into(p, v, json, strlen(json)));
+	EXPECT_TRUE(lept_is_equal(&expect, v));
+	lept_free(&expect);
+}
+
+static void test_parse_reuse() {
+	static const char* const docs[] = {
+		"{\"id\":1,\"name\":\"first message\",\"tags\":[\"a\",\"bb\",\"ccc\"],\"pos\":{\"x\":1.5,\"y\":-2}}",
+		"{\"id\":2,\"name\":\"second\",\"tags\":[\"d\",\"e\"],\"pos\":{\"x\":0,\"y\":0}}",
+		"{\"id\":3,\"name\":\"a longer name than before\",\"tags\":[\"f\",\"g\",\"h\",\"i\",\"j\"],\"pos\":null}",
+		"{\"name\":\"x\",\"id\":4,\"pos\":{\"x\":1,\"y\":2,\"z\":3},\"tags\":{}}",
+		"[1,[2,[3]],{\"a\":[]}]", "[[[\"deep\"]],{\"a\":[\"b\"]}]", "\"scalar\"", "{\"a\":1,", "[1,[2", "{\"a\":[1,2,3]}",
+		"{\"a\":[1]}", "[{\"a\":1,\"b\":\"c\"},{\"a\":2,\"b\":\"d\"}]", "[{\"a\":1,\"b\":\"c\"},{\"b\":2}]", "[]", "{}"
+	};
+	static const char big[] = "[\"0123456789012345678901234567890123456789012345678901234567890123456789"
+		"0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789"
+		"0123456789012345678901234567890123456789012345678901234567890123456789012345678901234567890123456789\"]";
+	lept_parser* p = lept_parser_create(0);
+	lept_alloc_stats s, plain;
+	lept_arena a;
+	lept_value v;
+	size_t i, k;
+	lept_init(&v);
+	for (k = 0; k < 2; k++)
+		for (i = 0; i < sizeof(docs) / sizeof(docs[0]); i++)
+			test_reuse(k ? p : NULL, &v, docs[i]);
+	lept_free(&v);
+	lept_set_array(&v, 0);	/* a value from the mutation API */
+	lept_set_string(lept_pushback_array_element(&v), "abc", 3);
+	test_reuse(NULL, &v, docs[4]);
+	lept_set_object(&v, 0);
+	lept_set_number(lept_set_object_value(&v, "a", 1), 1);
+	test_reuse(p, &v, docs[10]);
+	lept_free(&v);
+	lept_arena_init(&a, 0);	/* borrowed storage is left alone */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, docs[0], &a));
+	test_reuse(NULL, &v, docs[1]);
+	lept_arena_free(&a);
+	test_reuse(NULL, &v, docs[0]);
+	lept_free(&v);
+
+	/* the same shape again needs no allocation */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_into(p, &v, docs[0], strlen(docs[0])));
+	lept_count_allocs(&s);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_into(p, &v, docs[1], strlen(docs[1])));
+	lept_count_allocs(NULL);
+	EXPECT_EQ_SIZE_T(0, s.allocs);
+	EXPECT_EQ_SIZE_T(2, lept_get_array_size(lept_get_object_value(&v, 2)));
+	EXPECT_EQ_SIZE_T(3, lept_get_array_capacity(lept_get_object_value(&v, 2)));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_get_object_value(&v, 0)));
+	lept_free(&v);
+
+	/* lept_parser_parse() keeps its stack */
+	lept_count_allocs(&plain);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_n(&v, docs[0], strlen(docs[0])));
+	lept_count_allocs(NULL);
+	lept_free(&v);
+	lept_count_allocs(&s);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v, docs[0], strlen(docs[0])));
+	lept_count_allocs(NULL);
+	EXPECT_EQ_SIZE_T(0, s.stack);
+	EXPECT_TRUE(s.allocs + 2 <= plain.allocs);	/* neither the stack nor the frames */
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_MISS_COMMA_OR_SQUARE_BRACKET, lept_parser_parse(p, &v, docs[8], strlen(docs[8])));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_parser_destroy(p);
+
+	/* a stack that grew past keep is cut back */
+	for (k = 0; k < 2; k++) {
+		p = lept_parser_create(k ? 256 : 0);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v, big, sizeof(big) - 1));
+		lept_free(&v);
+		lept_count_allocs(&s);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parser_parse(p, &v, big, sizeof(big) - 1));
+		lept_count_allocs(NULL);
+		EXPECT_TRUE(k ? s.stack > 256 : s.stack == 0);
+		lept_free(&v);
+		lept_parser_destroy(p);
+	}
+}
+
 static void test_parse() {
 	test_parse_null();
 	test_parse_true();
 	test_parse_false();
 	test_parse_number();
+	test_parse_number_exact();
 	test_parse_string();
+	test_parse_long_string();
+	test_parse_whitespace();
 	test_parse_array();
 	test_parse_object();
+	test_parse_arena();
+	test_parse_allocator();
+	test_parse_stats();
+	test_parse_reuse();
+	test_parse_insitu();
+	test_parse_shaped();
+	test_parse_length();
+	test_parse_file();
+	test_parse_ndjson();
+	test_parse_parallel();
+	test_parse_document();
+	test_parse_lazy();
+	test_parse_projected();
+	test_parse_push();
+	test_parse_sax();
 
 	test_parse_expect_value();
 	test_parse_invalid_value();
@@ -364,6 +1582,7 @@ static void test_parse() {
 	test_parse_invalid_unicode_hex();
 	test_parse_invalid_unicode_surrogate();
 	test_parse_miss_comma_or_square_bracket();
+	test_parse_too_deep();
 }
 
 static void test_access_null() {
@@ -405,11 +1624,426 @@ static void test_access_string() {
 	lept_free(&v);
 }
 
+static void test_access_expect_json(const char* expect, const lept_value* v) {
+	char* json = lept_stringify(v, NULL);
+	EXPECT_EQ_BASE(strcmp(expect, json) == 0, expect, json, "%s");
+	free(json);
+}
+
+static void test_access_array() {
+	static char insitu[] = "[\"a\",[1,2],\"b\"]";
+	lept_value a, e, *p;
+	lept_arena arena;
+	size_t i, j;
+
+	lept_init(&a);
+	for (j = 0; j <= 5; j += 5) {
+		lept_set_array(&a, j);
+		EXPECT_EQ_SIZE_T(0, lept_get_array_size(&a));
+		EXPECT_EQ_SIZE_T(j, lept_get_array_capacity(&a));
+		for (i = 0; i < 10; i++) {
+			lept_init(&e);
+			lept_set_number(&e, (double)i);
+			*lept_pushback_array_element(&a) = e;	/* the element takes over e */
+		}
+		EXPECT_EQ_SIZE_T(10, lept_get_array_size(&a));
+		for (i = 0; i < 10; i++)
+			EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_array_element(&a, i)));
+	}
+
+	lept_popback_array_element(&a);
+	EXPECT_EQ_SIZE_T(9, lept_get_array_size(&a));
+	lept_erase_array_element(&a, 4, 0);
+	lept_erase_array_element(&a, 8, 1);
+	lept_erase_array_element(&a, 0, 2);
+	test_access_expect_json("[2,3,4,5,6,7]", &a);
+	lept_set_string(lept_insert_array_element(&a, 0), "Hello", 5);
+	lept_set_boolean(lept_insert_array_element(&a, 7), true);
+	lept_set_array(lept_insert_array_element(&a, 3), 0);
+	test_access_expect_json("[\"Hello\",2,3,[],4,5,6,7,true]", &a);
+
+	i = lept_get_array_capacity(&a);
+	lept_clear_array(&a);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_size(&a));
+	EXPECT_EQ_SIZE_T(i, lept_get_array_capacity(&a));
+	lept_shrink_array(&a);
+	EXPECT_EQ_SIZE_T(0, lept_get_array_capacity(&a));
+	lept_reserve_array(&a, 20);
+	EXPECT_EQ_SIZE_T(20, lept_get_array_capacity(&a));
+	lept_reserve_array(&a, 10);
+	EXPECT_EQ_SIZE_T(20, lept_get_array_capacity(&a));
+	lept_free(&a);
+
+	/* an arena or in-situ array is copied out when it grows, its old elements stay borrowed */
+	lept_arena_init(&arena, 0);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&a, "[\"a\",[1,2],\"b\"]", &arena));
+	lept_set_number(lept_pushback_array_element(lept_get_array_element(&a, 1)), 3.0);
+	lept_popback_array_element(&a);
+	lept_set_null(lept_insert_array_element(&a, 0));
+	lept_shrink_array(&a);
+	test_access_expect_json("[null,\"a\",[1,2,3]]", &a);
+	lept_free(&a);
+	lept_arena_free(&arena);
+	lept_init(&a);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&a, insitu));
+	lept_erase_array_element(&a, 0, 1);
+	p = lept_pushback_array_element(&a);
+	lept_set_string(p, "c", 1);
+	test_access_expect_json("[[1,2],\"b\",\"c\"]", &a);
+	lept_free(&a);
+}
+
+static void test_access_object() {
+	static char insitu[] = "{\"a\":1,\"b\":2}";
+	lept_value o, *v;
+	lept_arena arena;
+	char key[16];
+	size_t i, j, index;
+
+	lept_init(&o);
+	for (j = 0; j <= 5; j += 5) {
+		lept_set_object(&o, j);
+		EXPECT_EQ_SIZE_T(0, lept_get_object_size(&o));
+		EXPECT_EQ_SIZE_T(j, lept_get_object_capacity(&o));
+		for (i = 0; i < 10; i++) {
+			key[0] = 'a' + (char)i;
+			key[1] = '\0';
+			lept_set_number(lept_set_object_value(&o, key, 1), (double)i);
+		}
+		EXPECT_EQ_SIZE_T(10, lept_get_object_size(&o));
+		for (i = 0; i < 10; i++) {
+			key[0] = 'a' + (char)i;
+			index = lept_find_object_index(&o, key, 1);
+			EXPECT_EQ_SIZE_T(i, index);
+			EXPECT_EQ_DOUBLE((double)i, lept_get_number(lept_get_object_value(&o, index)));
+		}
+	}
+
+	/* an existing key keeps its member */
+	v = lept_set_object_value(&o, "j", 1);
+	EXPECT_EQ_DOUBLE(9.0, lept_get_number(v));
+	lept_set_string(v, "Hello", 5);
+	EXPECT_EQ_SIZE_T(10, lept_get_object_size(&o));
+	EXPECT_EQ_STRING("Hello", lept_get_string(lept_find_object_value(&o, "j", 1)), 5);
+
+	lept_remove_object_value(&o, 0);
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "a", 1));
+	EXPECT_EQ_SIZE_T(8, lept_find_object_index(&o, "j", 1));
+	i = lept_get_object_capacity(&o);
+	lept_clear_object(&o);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_size(&o));
+	EXPECT_EQ_SIZE_T(i, lept_get_object_capacity(&o));
+	lept_shrink_object(&o);
+	EXPECT_EQ_SIZE_T(0, lept_get_object_capacity(&o));
+	lept_reserve_object(&o, 8);
+	EXPECT_EQ_SIZE_T(8, lept_get_object_capacity(&o));
+
+	/* the index follows appends and removals */
+	for (i = 0; i < 200; i++)
+		lept_set_number(lept_set_object_value(&o, key, sprintf(key, "k%d", (int)i)), (double)i);
+	for (i = 0; i < 200; i += 7)
+		EXPECT_EQ_SIZE_T(i, lept_find_object_index(&o, key, sprintf(key, "k%d", (int)i)));
+	lept_remove_object_value(&o, 100);
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&o, "k100", 4));
+	EXPECT_EQ_SIZE_T(100, lept_find_object_index(&o, "k101", 4));
+	EXPECT_EQ_SIZE_T(198, lept_find_object_index(&o, "k199", 4));
+	lept_free(&o);
+
+	/* shaped, arena and in-situ objects get members and keys of their own */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_shaped(&o, "[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}]"));
+	v = lept_get_array_element(&o, 1);
+	lept_set_number(lept_set_object_value(v, "z", 1), 5.0);
+	EXPECT_TRUE(lept_get_object_shape(v) == NULL);
+	lept_remove_object_value(lept_get_array_element(&o, 0), 0);
+	EXPECT_TRUE(lept_get_object_shape(lept_get_array_element(&o, 0)) == NULL);
+	test_access_expect_json("[{\"y\":2},{\"x\":3,\"y\":4,\"z\":5}]", &o);
+	lept_free(&o);
+	lept_arena_init(&arena, 0);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&o, "{\"a\":{\"b\":[]},\"c\":\"d\"}", &arena));
+	lept_set_boolean(lept_set_object_value(lept_find_object_value(&o, "a", 1), "e", 1), false);
+	lept_remove_object_value(&o, 1);
+	test_access_expect_json("{\"a\":{\"b\":[],\"e\":false}}", &o);
+	lept_free(&o);
+	lept_arena_free(&arena);
+	lept_init(&o);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_insitu(&o, insitu));
+	lept_clear_object(&o);
+	lept_set_null(lept_set_object_value(&o, "a", 1));
+	test_access_expect_json("{\"a\":null}", &o);
+	lept_free(&o);
+}
+
+static void test_equal(const char* json1, const char* json2, bool equality) {
+	lept_value v1, v2;
+	lept_init(&v1);
+	lept_init(&v2);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v1, json1));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_shaped(&v2, json2));
+	EXPECT_EQ_INT(equality, lept_is_equal(&v1, &v2));
+	EXPECT_EQ_INT(equality, lept_is_equal(&v2, &v1));
+	if (equality)
+		EXPECT_TRUE(lept_hash(&v1) == lept_hash(&v2));
+	else	/* not guaranteed, but these differ */
+		EXPECT_TRUE(lept_hash(&v1) != lept_hash(&v2));
+	EXPECT_EQ_INT(equality, lept_is_equal(&v1, &v2));	/* with cached hashes */
+	lept_free(&v1);
+	lept_free(&v2);
+}
+
+static void test_access_equal() {
+	static char json[4][512];
+	lept_value v, w;
+	size_t i;
+	uint64_t h;
+	int k;
+	lept_allocator none = { test_allocate_nothing, test_reallocate, test_deallocate, &i };
+
+	test_equal("true", "true", true);
+	test_equal("true", "false", false);
+	test_equal("false", "false", true);
+	test_equal("null", "null", true);
+	test_equal("null", "0", false);
+	test_equal("123", "123", true);
+	test_equal("123", "456", false);
+	test_equal("0", "-0", true);
+	test_equal("\"abc\"", "\"abc\"", true);
+	test_equal("\"abc\"", "\"abcd\"", false);
+	test_equal("\"a\\u0000b\"", "\"a\\u0000c\"", false);
+	test_equal("\"0123456789abcdef\"", "\"0123456789abcdeg\"", false);
+	test_equal("[]", "[]", true);
+	test_equal("[]", "null", false);
+	test_equal("[1,2,3]", "[1,2,3]", true);
+	test_equal("[1,2,3]", "[1,2,3,4]", false);
+	test_equal("[1,2,3]", "[3,2,1]", false);
+	test_equal("[[]]", "[[]]", true);
+	test_equal("{}", "{}", true);
+	test_equal("{}", "null", false);
+	test_equal("{}", "[]", false);
+	test_equal("{\"a\":1,\"b\":2}", "{\"a\":1,\"b\":2}", true);
+	test_equal("{\"a\":1,\"b\":2}", "{\"b\":2,\"a\":1}", true);
+	test_equal("{\"a\":1,\"b\":2}", "{\"a\":1,\"b\":3}", false);
+	test_equal("{\"a\":1,\"b\":2}", "{\"a\":1,\"b\":2,\"c\":3}", false);
+	test_equal("{\"a\":1,\"b\":2}", "{\"a\":1,\"c\":2}", false);
+	test_equal("{\"a\":{\"b\":{\"c\":{}}}}", "{\"a\":{\"b\":{\"c\":{}}}}", true);
+	test_equal("{\"a\":{\"b\":{\"c\":{}}}}", "{\"a\":{\"b\":{\"c\":[]}}}", false);
+	test_equal("[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}]", "[{\"y\":2,\"x\":1},{\"x\":3,\"y\":4}]", true);
+	test_equal("[{\"x\":1,\"y\":2},{\"x\":3,\"y\":4}]", "[{\"x\":1,\"y\":2},{\"x\":3,\"y\":5}]", false);
+	test_equal("{\"a\":1,\"a\":2}", "{\"a\":2,\"a\":1}", true);	/* duplicated keys compare as a multiset */
+	test_equal("{\"a\":1,\"a\":1}", "{\"a\":1,\"b\":1}", false);
+	test_equal("{\"a\":1,\"b\":1}", "{\"a\":1,\"a\":1}", false);
+	test_equal("{\"a\":1,\"a\":2}", "{\"a\":1,\"a\":3}", false);	/* not only the first "a" */
+	test_equal("{\"a\":1,\"a\":3}", "{\"a\":1,\"a\":2}", false);
+	test_equal("{\"a\":1,\"a\":1,\"b\":2}", "{\"a\":1,\"b\":2,\"a\":1}", true);
+	test_equal("{\"a\":1,\"a\":1,\"a\":2}", "{\"a\":1,\"a\":2,\"a\":2}", false);
+	test_equal("{\"a\":1,\"a\":2,\"a\":2}", "{\"a\":1,\"a\":1,\"a\":2}", false);
+
+	/* objects of one shape with a duplicated key */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_shaped(&v, "[{\"a\":1,\"a\":2},{\"a\":2,\"a\":1},{\"a\":1,\"a\":3},{\"b\":1,\"c\":2},{\"b\":1,\"c\":3}]"));
+	EXPECT_TRUE(lept_get_object_shape(lept_get_array_element(&v, 0)) == lept_get_object_shape(lept_get_array_element(&v, 1)));
+	EXPECT_TRUE(lept_is_equal(lept_get_array_element(&v, 0), lept_get_array_element(&v, 1)));
+	EXPECT_TRUE(lept_hash(lept_get_array_element(&v, 0)) == lept_hash(lept_get_array_element(&v, 1)));
+	EXPECT_FALSE(lept_is_equal(lept_get_array_element(&v, 0), lept_get_array_element(&v, 2)));
+	EXPECT_FALSE(lept_is_equal(lept_get_array_element(&v, 3), lept_get_array_element(&v, 4)));
+	lept_free(&v);
+
+	/* large objects are sorted by key, then on the heap; without memory they are scanned */
+	for (k = 0; k < 4; k++) {
+		size_t n = sprintf(json[k], "{\"dup\":%d", k == 1 ? 2 : 1);
+		for (i = 0; i < 20; i++) {
+			int j = (int)(k == 0 || k == 3 ? i : 19 - i);
+			n += sprintf(json[k] + n, ",\"k%d\":%d", j, k == 3 && j == 7 ? -1 : j);
+		}
+		sprintf(json[k] + n, ",\"dup\":%d}", k == 1 ? 1 : 2);
+	}
+	test_equal(json[0], json[1], true);	/* reversed, the values of "dup" swapped */
+	test_equal(json[0], json[2], true);	/* reversed */
+	test_equal(json[2], json[3], false);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json[0]));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, json[2]));
+	lept_set_allocator(&none);
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_is_equal(&w, &v));
+	lept_set_allocator(NULL);
+	lept_free(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, json[3]));
+	lept_set_allocator(&none);
+	EXPECT_FALSE(lept_is_equal(&v, &w));
+	lept_set_allocator(NULL);
+	lept_free(&v);
+	lept_free(&w);
+
+	/* mutation drops the cached hashes */
+	lept_init(&v);
+	lept_init(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[1,{\"a\":[]}]"));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "[1,{\"a\":[2]}]"));
+	h = lept_hash(&v);
+	EXPECT_TRUE(h != lept_hash(&w));
+	lept_set_number(lept_pushback_array_element(lept_set_object_value(lept_get_array_element(&v, 1), "a", 1)), 2.0);
+	lept_popback_array_element(&v);
+	lept_set_object(lept_pushback_array_element(&v), 0);
+	lept_set_array(lept_set_object_value(lept_get_array_element(&v, 1), "a", 1), 0);
+	lept_set_number(lept_pushback_array_element(lept_get_object_value(lept_get_array_element(&v, 1), 0)), 2.0);
+	lept_erase_array_element(&v, 0, 1);
+	lept_set_number(lept_insert_array_element(&v, 0), 1.0);
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_hash(&v) == lept_hash(&w));
+	lept_free(&v);
+	lept_free(&w);
+
+	/* a change below a container drops its cached hash, large containers cache theirs */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[[1]]"));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "[[1,2]]"));
+	lept_hash(&v);
+	lept_hash(&w);
+	lept_set_number(lept_pushback_array_element(lept_get_array_element(&v, 0)), 2.0);
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_is_equal(&w, &v));
+	EXPECT_TRUE(lept_hash(&v) == lept_hash(&w));
+	lept_free(&v);
+	lept_free(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[[1],0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]"));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "[[1,2],0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]"));
+	h = lept_hash(&v);
+	lept_hash(&w);
+	EXPECT_FALSE(lept_is_equal(&v, &w));
+	lept_set_number(lept_pushback_array_element(lept_get_array_element(&v, 0)), 2.0);
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_is_equal(&w, &v));
+	EXPECT_TRUE(lept_hash(&v) == lept_hash(&w));
+	lept_set_number(lept_get_array_element(lept_get_array_element(&v, 0), 1), 3.0);
+	EXPECT_FALSE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_hash(&v) != lept_hash(&w));
+	lept_popback_array_element(lept_get_array_element(&v, 0));
+	EXPECT_TRUE(h == lept_hash(&v));
+	lept_free(&v);
+	lept_free(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_shaped(&v, "{\"a\":[1],\"b\":{}}"));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "{\"b\":{},\"a\":[1,2]}"));
+	lept_hash(&v);
+	lept_hash(&w);
+	lept_set_number(lept_pushback_array_element(lept_find_object_value(&v, "a", 1)), 2.0);
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(lept_is_equal(&w, &v));
+	EXPECT_TRUE(lept_hash(&v) == lept_hash(&w));
+	lept_free(&v);
+
+	/* a large object, indexed before it changes */
+	lept_set_object(&v, 0);
+	for (i = 0; i < 40; i++) {
+		char key[16];
+		h = lept_hash(&v);
+		lept_set_number(lept_set_object_value(&v, key, sprintf(key, "k%d", (int)i)), (double)i);
+		EXPECT_TRUE(h != lept_hash(&v));
+	}
+	lept_remove_object_value(&v, 39);
+	EXPECT_TRUE(h == lept_hash(&v));
+	lept_free(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "{}"));
+	for (i = 0; i < 39; i++) {
+		char key[16];
+		lept_set_number(lept_set_object_value(&w, key, sprintf(key, "k%d", (int)(38 - i))), (double)(38 - i));
+	}
+	lept_set_array(lept_set_object_value(&v, "k0", 2), 0);
+	EXPECT_FALSE(lept_is_equal(&v, &w));
+	lept_set_array(lept_set_object_value(&w, "k0", 2), 0);
+	EXPECT_TRUE(lept_is_equal(&v, &w));
+	h = lept_hash(&v);
+	EXPECT_TRUE(h == lept_hash(&w));
+	lept_pushback_array_element(lept_find_object_value(&v, "k0", 2));
+	EXPECT_FALSE(lept_is_equal(&v, &w));
+	EXPECT_TRUE(h != lept_hash(&v));
+	lept_free(&v);
+	lept_free(&w);
+
+	/* changes in other trees keep a cached hash, a direct write goes unseen until one in its tree */
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[[1],0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]"));
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "[[1],0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0,0]"));
+	h = lept_hash(&v);
+	lept_hash(&w);
+	lept_set_number(lept_get_array_element(&w, 1), 1.0);
+	lept_free(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&w, "1"));
+	lept_get_array_element(&v, 1)->u.n = 1.0;
+	EXPECT_TRUE(h == lept_hash(&v));
+	lept_set_number(lept_get_array_element(&v, 2), 0.0);
+	EXPECT_TRUE(h != lept_hash(&v));
+	lept_free(&v);
+	lept_free(&w);
+}
+
+static void test_access_find_object() {
+	static char json[8192];
+	lept_value v;
+	lept_arena a;
+	size_t i, n, sizes[] = { 3, 100 };	/* scanned, then indexed */
+	int k, found;
+	for (k = 0; k < 2; k++) {
+		n = sprintf(json, "{\"dup\":0");
+		for (i = 1; i < sizes[k]; i++)
+			n += sprintf(json + n, ",\"key%d\":%d", (int)i, (int)i);
+		sprintf(json + n, ",\"dup\":-1,\"a\\u0000b\":[]}");
+		lept_init(&v);
+		EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+		for (i = 1, found = 0; i < sizes[k]; i++) {
+			char key[16];
+			size_t index = lept_find_object_index(&v, key, sprintf(key, "key%d", (int)i));
+			found += index == i && lept_get_number(lept_get_object_value(&v, index)) == (double)i;
+		}
+		EXPECT_EQ_INT((int)sizes[k] - 1, found);
+		EXPECT_EQ_SIZE_T(0, lept_find_object_index(&v, "dup", 3));
+		EXPECT_EQ_SIZE_T(sizes[k] + 1, lept_find_object_index(&v, "a\0b", 3));
+		EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "a", 1));
+		EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "key", 3));
+		EXPECT_TRUE(lept_find_object_value(&v, "dup", 3) == lept_get_object_value(&v, 0));
+		EXPECT_TRUE(lept_find_object_value(&v, "nope", 4) == NULL);
+		lept_free(&v);
+	}
+
+	/* arena objects are indexed by the parse */
+	lept_arena_init(&a, 0);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse_arena(&v, json, &a));
+	EXPECT_EQ_SIZE_T(42, lept_find_object_index(&v, "key42", 5));
+	EXPECT_EQ_SIZE_T(0, lept_find_object_index(&v, "dup", 3));
+	lept_free(&v);
+	lept_arena_free(&a);
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "{}"));
+	EXPECT_EQ_SIZE_T(LEPT_KEY_NOT_EXIST, lept_find_object_index(&v, "", 0));
+	lept_free(&v);
+}
+
+static void test_access_pointer() {
+	lept_value v;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, test_projection_json));
+	EXPECT_TRUE(lept_pointer_get(&v, "") == &v);
+	EXPECT_EQ_DOUBLE(42.0, lept_get_number(lept_pointer_get(&v, "/user/id")));
+	EXPECT_EQ_STRING("b", lept_get_string(lept_pointer_get(&v, "/user/tags/1")), lept_get_string_length(lept_pointer_get(&v, "/user/tags/1")));
+	EXPECT_EQ_DOUBLE(3.0, lept_get_number(lept_pointer_get(&v, "/items/1/price")));
+	EXPECT_EQ_DOUBLE(5.0, lept_get_number(lept_pointer_get(&v, "/a~1b/m~0n")));
+	EXPECT_EQ_DOUBLE(7.0, lept_get_number(lept_pointer_get(&v, "/")));
+	EXPECT_TRUE(lept_pointer_get(&v, "/items/3") == NULL);
+	EXPECT_TRUE(lept_pointer_get(&v, "/items/-") == NULL);
+	EXPECT_TRUE(lept_pointer_get(&v, "/items/01") == NULL);
+	EXPECT_TRUE(lept_pointer_get(&v, "/user/id/x") == NULL);
+	EXPECT_TRUE(lept_pointer_get(&v, "/nothing") == NULL);
+	EXPECT_TRUE(lept_pointer_get(&v, "/a~2b") == NULL);
+	EXPECT_TRUE(lept_pointer_get(&v, "user") == NULL);
+	lept_free(&v);
+}
+
 static void test_access() {
 	test_access_null();
 	test_access_boolean();
 	test_access_number();
 	test_access_string();
+	test_access_array();
+	test_access_object();
+	test_access_find_object();
+	test_access_equal();
+	test_access_pointer();
 }
 
 #define TEST_ROUNDTRIP(json)\
@@ -425,6 +2059,51 @@ static void test_access() {
         free(json2);\
     } while(0)
 
+static int test_significant_digits(const char* s) {
+	int n = 0, zeros = 0;
+	for (; *s && *s != 'e'; s++) {
+		if (*s < '0' || *s > '9' || (*s == '0' && n == 0))
+			continue;
+		zeros = *s == '0' ? zeros + 1 : 0;
+		n++;
+	}
+	return n - zeros;
+}
+
+static void test_stringify_number_shortest() {
+	static char json[32];
+	int i, p, mismatches = 0;
+	for (i = 0; i < 20000; i++) {
+		unsigned bits[2];
+		double d, back;
+		char* s;
+		size_t length;
+		lept_value v;
+		bits[0] = test_random() ^ (test_random() << 24);
+		bits[1] = test_random() ^ (test_random() << 24);
+		memcpy(&d, bits, sizeof(double));
+		if (d != d || d - d != 0.0)
+			continue;
+		lept_init(&v);
+		lept_set_number(&v, d);
+		s = lept_stringify(&v, &length);
+		back = strtod(s, NULL);
+		/* as short as the shortest %.*e that round-trips */
+		for (p = 0; p < 17; p++) {
+			sprintf(json, "%.*e", p, d);
+			if (strtod(json, NULL) == d)
+				break;
+		}
+		if (memcmp(&back, &d, sizeof(double)) != 0 || test_significant_digits(s) > p + 1) {
+			fprintf(stderr, "%s:%d: %.17g stringified as %s\n", __FILE__, __LINE__, d, s);
+			mismatches++;
+		}
+		free(s);
+		lept_free(&v);
+	}
+	EXPECT_EQ_INT(0, mismatches);
+}
+
 static void test_stringify_number() {
 	TEST_ROUNDTRIP("0");
 	TEST_ROUNDTRIP("-0");
@@ -438,14 +2117,52 @@ static void test_stringify_number() {
 	TEST_ROUNDTRIP("1.234e-20");
 
 	TEST_ROUNDTRIP("1.0000000000000002"); /* the smallest number > 1 */
-	TEST_ROUNDTRIP("4.9406564584124654e-324"); /* minimum denormal */
-	TEST_ROUNDTRIP("-4.9406564584124654e-324");
-	TEST_ROUNDTRIP("2.2250738585072009e-308");  /* Max subnormal double */
-	TEST_ROUNDTRIP("-2.2250738585072009e-308");
+	TEST_ROUNDTRIP("5e-324"); /* minimum denormal */
+	TEST_ROUNDTRIP("-5e-324");
+	TEST_ROUNDTRIP("2.225073858507201e-308");  /* Max subnormal double */
+	TEST_ROUNDTRIP("-2.225073858507201e-308");
 	TEST_ROUNDTRIP("2.2250738585072014e-308");  /* Min normal positive double */
 	TEST_ROUNDTRIP("-2.2250738585072014e-308");
 	TEST_ROUNDTRIP("1.7976931348623157e+308");  /* Max double */
 	TEST_ROUNDTRIP("-1.7976931348623157e+308");
+
+	/* the shortest digits that parse back to the same double */
+	TEST_ROUNDTRIP("0.1");
+	TEST_ROUNDTRIP("0.3");
+	TEST_ROUNDTRIP("0.0001");
+	TEST_ROUNDTRIP("1e-05");
+	TEST_ROUNDTRIP("123456789012");
+	TEST_ROUNDTRIP("9007199254740992");
+	TEST_ROUNDTRIP("1e+17");
+	TEST_ROUNDTRIP("1e+23");
+	TEST_ROUNDTRIP("5e-310");
+	TEST_ROUNDTRIP("2.5e-05");
+	TEST_ROUNDTRIP("-123.456");
+	TEST_ROUNDTRIP("[0.1,0.2,0.30000000000000004]");
+	test_stringify_number_shortest();
+}
+
+static void test_stringify_string_escapes() {
+	char s[80], *json;
+	size_t i, length;
+	lept_value v, back;
+	int mismatches = 0;
+	for (i = 0; i < 256; i++) {	/* every byte, at every offset of a 16-byte block */
+		memset(s, 'x', sizeof(s));
+		s[i % 64] = (char)i;
+		s[i % 64 + 1] = i & 1 ? '"' : '\\';
+		lept_init(&v);
+		lept_init(&back);
+		lept_set_string(&v, s, sizeof(s));
+		json = lept_stringify(&v, &length);
+		if (lept_parse(&back, json) != LEPT_PARSE_OK || lept_get_string_length(&back) != sizeof(s) ||
+			memcmp(lept_get_string(&back), s, sizeof(s)) != 0 || length > sizeof(s) + 2 + 6)
+			mismatches++;
+		free(json);
+		lept_free(&v);
+		lept_free(&back);
+	}
+	EXPECT_EQ_INT(0, mismatches);
 }
 
 static void test_stringify_string() {
@@ -454,6 +2171,8 @@ static void test_stringify_string() {
 	TEST_ROUNDTRIP("\"Hello\\nWorld\"");
 	TEST_ROUNDTRIP("\"\\\" \\\\ / \\b \\f \\n \\r \\t\"");
 	TEST_ROUNDTRIP("\"Hello\\u0000World\"");
+	TEST_ROUNDTRIP("\"\\u0001\\u001F<a href=\\\"x\\\">0123456789abcdef</a>\\r\\n0123456789abcdef0123456789\\t\"");
+	test_stringify_string_escapes();
 }
 
 static void test_stringify_array() {
@@ -466,6 +2185,291 @@ static void test_stringify_object() {
 	TEST_ROUNDTRIP("{\"n\":null,\"f\":false,\"t\":true,\"i\":123,\"s\":\"abc\",\"a\":[1,2,3],\"o\":{\"1\":1,\"2\":2,\"3\":3}}");
 }
 
+struct test_sink_buffer {
+	char* data;
+	size_t len, writes, largest, fail_after;	/* fail_after: refuse the write after this many, 0 never */
+};
+
+static bool test_sink_write(void* user, const char* data, size_t len) {
+	test_sink_buffer* b = (test_sink_buffer*)user;
+	if (b->fail_after && b->writes == b->fail_after)
+		return false;
+	b->data = (char*)realloc(b->data, b->len + len);
+	memcpy(b->data + b->len, data, len);
+	b->len += len;
+	b->writes++;
+	if (len > b->largest)
+		b->largest = len;
+	return true;
+}
+
+static void test_stringify_writer() {
+	lept_writer* w = lept_writer_create(0);
+	lept_alloc_stats s;
+	const char* out;
+	char* big = (char*)malloc(1000);
+	lept_value v;
+	size_t length;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[1,\"two\",{\"three\":3}]"));
+	out = lept_writer_stringify(w, &v, &length);
+	EXPECT_EQ_SIZE_T(21, length);
+	EXPECT_EQ_INT(0, strcmp("[1,\"two\",{\"three\":3}]", out));
+	lept_count_allocs(&s);
+	out = lept_writer_stringify(w, &v, &length);
+	lept_count_allocs(NULL);
+	EXPECT_EQ_SIZE_T(0, s.allocs);
+	EXPECT_EQ_INT(0, strcmp("[1,\"two\",{\"three\":3}]", out));
+	lept_writer_destroy(w);
+
+	/* an output buffer that grew past keep is cut back by the next call */
+	w = lept_writer_create(256);
+	memset(big, 'x', 1000);
+	lept_set_string(&v, big, 1000);
+	out = lept_writer_stringify(w, &v, &length);
+	EXPECT_EQ_SIZE_T(1002, length);
+	EXPECT_TRUE(out[0] == '"' && out[1001] == '"' && out[1002] == '\0');
+	lept_set_number(&v, 1);
+	lept_count_allocs(&s);
+	out = lept_writer_stringify(w, &v, &length);
+	lept_count_allocs(NULL);
+	EXPECT_EQ_SIZE_T(1, s.allocs);
+	EXPECT_EQ_INT(0, strcmp("1", out));
+	lept_count_allocs(&s);
+	lept_writer_stringify(w, &v, &length);
+	lept_count_allocs(NULL);
+	EXPECT_EQ_SIZE_T(0, s.allocs);
+	lept_writer_destroy(w);
+	lept_free(&v);
+	free(big);
+}
+
+static void test_stringify_to() {
+	lept_value v, *e;
+	lept_sink sink;
+	test_sink_buffer b;
+	char* json, *s;
+	size_t length, i;
+	FILE* fp;
+
+	/* a document much larger than the output buffer, with a string longer than it */
+	s = (char*)malloc(300000);
+	for (i = 0; i < 300000; i++)
+		s[i] = "ab\"\n\\\x01xyz"[i % 9];
+	length = 0;
+	json = (char*)malloc(2000000);
+	length += sprintf(json, "[\"");
+	for (i = 0; i < 300000; i++)
+		length += sprintf(json + length, "%s", s[i] == '"' ? "\\\"" : s[i] == '\n' ? "\\n" : s[i] == '\\' ? "\\\\" : s[i] == 1 ? "\\u0001" : "a");
+	for (i = 0; i < 20000; i++)
+		length += sprintf(json + length, "\",{\"k%d\":[%d.5,true,null]},\"", (int)i, (int)i);
+	sprintf(json + length, "\"]");
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	free(s);
+	free(json);
+
+	b.data = NULL;
+	b.len = b.writes = b.largest = b.fail_after = 0;
+	sink.write = test_sink_write;
+	sink.user = &b;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to(&v, &sink));
+	s = lept_stringify(&v, &length);
+	EXPECT_EQ_SIZE_T(length, b.len);
+	EXPECT_TRUE(memcmp(s, b.data, length) == 0);
+	EXPECT_TRUE(b.writes > 10);
+	EXPECT_TRUE(b.largest < 128 * 1024);	/* a bounded buffer, not the whole output */
+
+	/* an error stops the output */
+	b.len = b.writes = 0;
+	b.fail_after = 3;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_SINK_ERROR, lept_stringify_to(&v, &sink));
+	EXPECT_EQ_SIZE_T(3, b.writes);
+	free(b.data);
+
+	/* FILE* sink */
+	if ((fp = tmpfile()) != NULL) {
+		char* read = (char*)malloc(length + 1);
+		sink = lept_sink_file(fp);
+		EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to(&v, &sink));
+		rewind(fp);
+		EXPECT_EQ_SIZE_T(length, fread(read, 1, length + 1, fp));
+		EXPECT_TRUE(memcmp(s, read, length) == 0);
+		free(read);
+		fclose(fp);
+	}
+	free(s);
+
+	e = lept_get_array_element(&v, 1);
+	b.data = NULL;
+	b.len = b.writes = b.largest = b.fail_after = 0;
+	sink.write = test_sink_write;
+	sink.user = &b;
+	EXPECT_EQ_INT(LEPT_STRINGIFY_OK, lept_stringify_to(e, &sink));
+	EXPECT_EQ_STRING("{\"k0\":[0.5,true,null]}", b.data, b.len);
+	free(b.data);
+	lept_free(&v);
+}
+
+/* lept_load_binary() of the snapshot gives back the same value */
+static void test_binary_roundtrip(const char* json) {
+	lept_value v, w;
+	char* data, *s1, *s2;
+	size_t size;
+	lept_init(&v);
+	lept_init(&w);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	data = lept_serialize_binary(&v, &size);
+	EXPECT_TRUE(size % 8 == 0);
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_load_binary(&w, data, size));
+	s1 = lept_stringify(&v, NULL);
+	s2 = lept_stringify(&w, NULL);
+	EXPECT_EQ_BASE(strcmp(s1, s2) == 0, s1, s2, "%s");
+	free(s1);
+	free(s2);
+	free(data);
+	lept_free(&w);
+	lept_free(&v);
+}
+
+/* Sets the little-endian word at off of a snapshot and recomputes its checksum, as lept_serialize_binary() does */
+static void test_binary_patch(char* data, size_t size, size_t off, uint64_t x) {
+	uint64_t h = 1;	/* the version */
+	size_t i;
+	int j;
+	for (j = 0; j < 8; j++)
+		data[off + j] = (char)(x >> (8 * j));
+	for (i = 0; i < size; i += 8) {
+		if (i == 24)
+			continue;
+		for (x = 0, j = 7; j >= 0; j--)
+			x = x << 8 | (unsigned char)data[i + j];
+		h = (h ^ x) * ((uint64_t)0x9e3779b9 << 32 | 0x7f4a7c15);
+		h ^= h >> 29;
+	}
+	for (j = 0; j < 8; j++)
+		data[24 + j] = (char)(h >> (8 * j));
+}
+
+/* The snapshot of json with the word at off set to x is rejected, though its checksum is right */
+static void test_binary_invalid(const char* json, size_t off, uint64_t x) {
+	lept_binary_view b;
+	lept_value v;
+	char* data;
+	size_t size;
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	data = lept_serialize_binary(&v, &size);
+	lept_free(&v);
+	test_binary_patch(data, size, off, x);
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_binary_open(&b, data, size));
+	EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_load_binary(&v, data, size));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	free(data);
+}
+
+static void test_stringify_binary() {
+	static const char json[] = "[{\"id\":1,\"tag\":\"a\\u0000b\"},{\"id\":-0.5,\"tag\":null},true,false,\"\",[],{}]";
+	lept_binary_view b;
+	lept_value v;
+	char* data, *copy;
+	size_t size, e, i;
+
+	test_binary_roundtrip("null");
+	test_binary_roundtrip("true");
+	test_binary_roundtrip("1.5e300");
+	test_binary_roundtrip("\"\"");
+	test_binary_roundtrip("\"12345678\"");
+	test_binary_roundtrip("{\"a\":{\"a\":[\"a\",{\"a\":1}]},\"b\":[]}");
+	test_binary_roundtrip(json);
+
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, json));
+	data = lept_serialize_binary(&v, &size);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_binary_open(&b, data, size));
+	EXPECT_EQ_INT(LEPT_ARRAY, lept_binary_get_type(&b, b.root));
+	EXPECT_EQ_SIZE_T(7, lept_binary_get_array_size(&b, b.root));
+	e = lept_binary_get_array_element(&b, b.root, 0);
+	EXPECT_EQ_INT(LEPT_OBJECT, lept_binary_get_type(&b, e));
+	EXPECT_EQ_SIZE_T(2, lept_binary_get_object_size(&b, e));
+	EXPECT_EQ_STRING("tag", lept_binary_get_object_key(&b, e, 1), lept_binary_get_object_key_length(&b, e, 1));
+	EXPECT_EQ_STRING("a\0b", lept_binary_get_string(&b, lept_binary_get_object_value(&b, e, 1)),
+		lept_binary_get_string_length(&b, lept_binary_get_object_value(&b, e, 1)));
+	EXPECT_EQ_DOUBLE(1.0, lept_binary_get_number(&b, lept_binary_get_object_value(&b, e, 0)));
+	/* equal keys are stored once */
+	EXPECT_TRUE(lept_binary_get_object_key(&b, e, 0) == lept_binary_get_object_key(&b, lept_binary_get_array_element(&b, b.root, 1), 0));
+	EXPECT_TRUE(lept_binary_get_boolean(&b, lept_binary_get_array_element(&b, b.root, 2)));
+	EXPECT_FALSE(lept_binary_get_boolean(&b, lept_binary_get_array_element(&b, b.root, 3)));
+	EXPECT_EQ_SIZE_T(0, lept_binary_get_string_length(&b, lept_binary_get_array_element(&b, b.root, 4)));
+	EXPECT_EQ_SIZE_T(0, lept_binary_get_array_size(&b, lept_binary_get_array_element(&b, b.root, 5)));
+	EXPECT_EQ_SIZE_T(0, lept_binary_get_object_size(&b, lept_binary_get_array_element(&b, b.root, 6)));
+
+	/* any change is caught by the checksum, any truncation by the size */
+	copy = (char*)malloc(size);
+	for (i = 0; i < size; i++) {
+		memcpy(copy, data, size);
+		copy[i] ^= 0x10;
+		EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_load_binary(&v, copy, size));
+		EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	}
+	EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_load_binary(&v, data, size - 8));
+	EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_load_binary(&v, data, 16));
+	EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_binary_open(&b, NULL, 0));
+	free(copy);
+	free(data);
+
+	/* "[1]" is the array at 32 with its element at 40, then the number at 48 */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[1]"));
+	data = lept_serialize_binary(&v, &size);
+	lept_free(&v);
+	test_binary_patch(data, size, 48, (uint64_t)0x40000000 << 32);	/* 2.0 */
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_load_binary(&v, data, size));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_get_array_element(&v, 0)));
+	lept_free(&v);
+	free(data);
+	test_binary_invalid("[1]", 40, 56 | LEPT_NUMBER);	/* out of the snapshot */
+	test_binary_invalid("[1]", 40, (uint64_t)1 << 40 | LEPT_NUMBER);
+	test_binary_invalid("[1]", 40, 8 | LEPT_NUMBER);	/* before its container */
+	test_binary_invalid("[1]", 40, 32 | LEPT_ARRAY);	/* the container itself */
+	test_binary_invalid("[1]", 32, 3);	/* more elements than fit */
+	test_binary_invalid("[1]", 32, ~(uint64_t)0 >> 4);
+	test_binary_invalid("[1]", 32, 0);	/* an item left over */
+	test_binary_invalid("[1]", 40, 48 | LEPT_STRING);	/* the bits of 1.0 as a length */
+	test_binary_invalid("[1]", 16, 32 | LEPT_OBJECT);	/* a wrong type */
+	test_binary_invalid("[\"ab\"]", 48, 8);	/* the string would end past the snapshot */
+	test_binary_invalid("[\"ab\"]", 48, ~(uint64_t)0);
+	test_binary_invalid("[null]", 40, 48 | LEPT_NULL);	/* a literal has no item */
+	test_binary_invalid("[true]", 40, 8 | LEPT_TRUE);
+	test_binary_invalid("[false]", 40, 32 | LEPT_FALSE);
+	test_binary_invalid("null", 16, 8 | LEPT_NULL);
+	/* "[[],[]]" has its elements at 56 and 64: sharing one would let a small snapshot expand */
+	test_binary_invalid("[[],[]]", 48, 56 | LEPT_ARRAY);
+	test_binary_invalid("[[],[]]", 40, 64 | LEPT_ARRAY);
+	/* {"a":1,"b":2} has its keys at 72 and 96, each before its value: a key may only point back */
+	test_binary_invalid("{\"a\":1,\"b\":2}", 40, 96);
+	test_binary_invalid("{\"a\":1,\"b\":2}", 40, 72 | LEPT_STRING);
+	test_binary_invalid("{\"a\":1,\"b\":2}", 40, 16);
+
+	/* a shared key is fine, the depth is limited as for a parse */
+	lept_init(&v);
+	EXPECT_EQ_INT(LEPT_PARSE_OK, lept_parse(&v, "[[[{\"a\":1}]],{\"a\":2}]"));
+	data = lept_serialize_binary(&v, &size);
+	lept_free(&v);
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_load_binary(&v, data, size));
+	EXPECT_EQ_DOUBLE(2.0, lept_get_number(lept_find_object_value(lept_get_array_element(&v, 1), "a", 1)));
+	lept_free(&v);
+	lept_set_max_depth(4);
+	EXPECT_EQ_INT(LEPT_BINARY_OK, lept_load_binary(&v, data, size));
+	lept_free(&v);
+	lept_set_max_depth(3);
+	EXPECT_EQ_INT(LEPT_BINARY_INVALID, lept_load_binary(&v, data, size));
+	EXPECT_EQ_INT(LEPT_NULL, lept_get_type(&v));
+	lept_set_max_depth(0);
+	free(data);
+}
+
 static void test_stringify() {
 	TEST_ROUNDTRIP("null");
 	TEST_ROUNDTRIP("false");
@@ -474,6 +2478,9 @@ static void test_stringify() {
 	test_stringify_string();
 	test_stringify_array();
 	test_stringify_object();
+	test_stringify_to();
+	test_stringify_writer();
+	test_stringify_binary();
 }
 
 int main() {